@@ -1,6 +1,9 @@
 #include <bench/randomPoints.h>
 #include <unistd.h>
+#include <omp.h>
 
+unsigned BenchTypeClasses::Benchmark::chunkSize = 10000;
+unsigned BenchTypeClasses::Benchmark::chunkBuffers = 4;
 unsigned BenchTypeClasses::Uniform::size = 10000;
 unsigned BenchTypeClasses::Uniform::dimensions = dimensions;
 unsigned BenchTypeClasses::Uniform::seed = 3141;
@@ -22,17 +25,33 @@ PointGenerator<T>::PointGenerator(BenchTag::DistributionGenerated) :
 
 template <typename T>
 PointGenerator<T>::PointGenerator(BenchTag::FileBackedReadAll) :
-	benchmarkSize(T::size), backingFile(T::fileName), offset(0)
+	benchmarkSize(T::size), offset(0)
 {
 }
 
 template <typename T>
 PointGenerator<T>::PointGenerator(BenchTag::FileBackedReadChunksAtATime) :
-    benchmarkSize(T::size), backingFile(T::fileName), offset(0)
+	benchmarkSize(T::size), backingFile(T::fileName), offset(0)
 {
+	reset(BenchTag::FileBackedReadChunksAtATime{});
 }
 
 
+// Points are read straight out of the mapping one at a time so the file never has to fit in memory
+template <typename T>
+PointGenerator<T>::PointGenerator(BenchTag::FileBackedBinary) :
+	benchmarkSize(T::size), offset(0)
+{
+	if (!pointFile.open(T::binaryFileName) || pointFile.dimensions() != T::dimensions || pointFile.size() < benchmarkSize)
+	{
+		std::cout << "Could not read from file: " << T::binaryFileName << std::endl;
+		std::cout << "Convert " << T::fileName << " with bin/convertPoints -d " << T::dimensions << " first." << std::endl;
+		exit(1);
+	}
+
+	reset(BenchTag::FileBackedBinary{});
+}
+
 template <typename T>
 void PointGenerator<T>::reset(BenchTag::DistributionGenerated)
 {
@@ -48,8 +67,19 @@ void PointGenerator<T>::reset(BenchTag::FileBackedReadAll)
 template <typename T>
 void PointGenerator<T>::reset(BenchTag::FileBackedReadChunksAtATime)
 {
-	offset = 0;
+	prefetcher.stop();
+	backingFile.clear();
 	backingFile.seekg(0);
+	filledPoints = 0;
+	prefetcher.start(T::chunkSize, T::chunkBuffers, [this](Point *chunk, size_t capacity) { return fillChunk(BenchTag::FileBackedReadChunksAtATime{}, chunk, capacity); });
+}
+
+template <typename T>
+void PointGenerator<T>::reset(BenchTag::FileBackedBinary)
+{
+	prefetcher.stop();
+	filledPoints = 0;
+	prefetcher.start(T::chunkSize, T::chunkBuffers, [this](Point *chunk, size_t capacity) { return fillChunk(BenchTag::FileBackedBinary{}, chunk, capacity); });
 }
 
 template <typename T>
@@ -89,22 +119,12 @@ std::optional<Point> PointGenerator<T>::nextPoint(BenchTag::FileBackedReadAll)
 {
 	if (pointBuffer.empty())
 	{
-		// We produce all of the points at once, shove them into the buffer.
-		fileGoodOrDie(backingFile);
-
-		// Initialize points
-		pointBuffer.reserve(benchmarkSize);
-		for (unsigned i = 0; i < benchmarkSize; ++i)
+		// We produce all of the points at once, parsing the file in parallel into the buffer.
+		pointBuffer.resize(benchmarkSize);
+		if (!textpoints::read(T::fileName, T::dimensions, benchmarkSize, pointBuffer.data()))
 		{
-			Point p;
-			for (unsigned d = 0; d < T::dimensions; ++d)
-			{
-				fileGoodOrDie(backingFile);
-				double dbl;
-				backingFile >> dbl;
-				p[d] = dbl;
-			}
-			pointBuffer.push_back(std::move(p));
+			std::cout << "Could not read from file: " << T::fileName << std::endl;
+			exit(1);
 		}
 	}
 
@@ -118,37 +138,55 @@ std::optional<Point> PointGenerator<T>::nextPoint(BenchTag::FileBackedReadAll)
 template <typename T>
 std::optional<Point> PointGenerator<T>::nextPoint(BenchTag::FileBackedReadChunksAtATime)
 {
-	if (offset >= benchmarkSize)
+	Point p;
+	if (prefetcher.next(p))
 	{
-		return std::nullopt;
+		return p;
 	}
-	if (pointBuffer.empty())
+	return std::nullopt;
+}
+
+template <typename T>
+std::optional<Point> PointGenerator<T>::nextPoint(BenchTag::FileBackedBinary)
+{
+	Point p;
+	if (prefetcher.next(p))
 	{
-		// Fill it with 10k entries
-		pointBuffer.resize(10000);
+		return p;
 	}
-	if (offset % 10000 == 0)
-	{
-		// Time to read 10k more things
-		// Do the fstream song and dance
+	return std::nullopt;
+}
 
-		// Initialize points
-		for (unsigned i = 0; i < 10000 and offset+i < benchmarkSize; ++i)
+// Runs on the prefetcher's thread
+template <typename T>
+size_t PointGenerator<T>::fillChunk(BenchTag::FileBackedReadChunksAtATime, Point *chunk, size_t capacity)
+{
+	size_t count = 0;
+	for (; count < capacity && filledPoints < benchmarkSize; ++count, ++filledPoints)
+	{
+		for (unsigned d = 0; d < T::dimensions; ++d)
 		{
-			Point p;
-			for (unsigned d = 0; d < T::dimensions; ++d)
-			{
-				fileGoodOrDie(backingFile);
-				double dbl;
-				backingFile >> dbl;
-				p[d] = dbl;
-			}
-			pointBuffer[i] = p;
+			fileGoodOrDie(backingFile);
+			double dbl;
+			backingFile >> dbl;
+			chunk[count][d] = dbl;
 		}
+	}
 
+	return count;
+}
+
+// Runs on the prefetcher's thread, copying points out also faults the mapping in ahead of them
+template <typename T>
+size_t PointGenerator<T>::fillChunk(BenchTag::FileBackedBinary, Point *chunk, size_t capacity)
+{
+	size_t count = 0;
+	for (; count < capacity && filledPoints < benchmarkSize; ++count, ++filledPoints)
+	{
+		chunk[count] = pointFile.point(filledPoints);
 	}
 
-	return pointBuffer[offset++ % 10000];
+	return count;
 }
 
 template <typename T>
@@ -454,7 +492,7 @@ static Rectangle *generateGaiaRectangles()
 
 
 template <typename T>
-static void runBench(PointGenerator<T> &pointGen, std::map<std::string, unsigned> &configU, std::map<std::string, double> &configD)
+static void runBench(PointGenerator<T> &pointGen, std::map<std::string, unsigned> &configU, std::map<std::string, double> &configD, std::map<std::string, std::string> &configS)
 {
 	std::cout << "Running benchmark." << std::endl;
 
@@ -462,13 +500,20 @@ static void runBench(PointGenerator<T> &pointGen, std::map<std::string, unsigned
 	unsigned directSum = 0;
 
 	// Setup statistics
+	double totalTimeBulkLoad = 0.0;
+	double totalTimeLoad = 0.0;
 	double totalTimeInserts = 0.0;
 	double totalTimeSearches = 0.0;
 	double totalTimeRangeSearches = 0.0;
+	double totalTimeKnnSearches = 0.0;
+	double totalTimeCounts = 0.0;
+	double totalTimePagedRangeSearches = 0.0;
 	double totalTimeDeletes = 0.0;
 	unsigned totalInserts = 0;
 	double totalSearches = 0.0;
 	double totalRangeSearches = 0.0;
+	double totalKnnSearches = 0.0;
+	double totalCounts = 0.0;
 	unsigned totalDeletes = 0.0;
 
 	// Initialize the index
@@ -549,27 +594,127 @@ static void runBench(PointGenerator<T> &pointGen, std::map<std::string, unsigned
 		return;
 	}
 
-	// Insert points and time their insertion
-	std::cout << "Inserting Points." << std::endl;
+	// Read back the tree built by an earlier run if a snapshot of it was given and exists
+	bool snapshotLoaded = false;
+	if (!configS["snapshot"].empty())
+	{
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+		snapshotLoaded = spatialIndex->load(configS["snapshot"]);
+		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+		totalTimeLoad = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin).count();
+	}
+
 	std::optional<Point> nextPoint;
-	while((nextPoint = pointGen.nextPoint()) /* Intentional = and not == */)
+	if (snapshotLoaded)
 	{
-		// Compute the checksum directly
-		for (unsigned d = 0; d < dimensions; ++d)
+		// The points are still read through for the checksum
+		while((nextPoint = pointGen.nextPoint()) /* Intentional = and not == */)
 		{
-			directSum += (unsigned) nextPoint.value()[d];
+			// Compute the checksum directly
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				directSum += (unsigned) nextPoint.value()[d];
+			}
+		}
+		std::cout << "Snapshot load OK." << std::endl;
+	}
+	else if (configU["bulkload"])
+	{
+		// Gather every point up front so only the packing itself is timed
+		std::cout << "Bulk loading Points." << std::endl;
+		std::vector<Point> points;
+		while((nextPoint = pointGen.nextPoint()) /* Intentional = and not == */)
+		{
+			// Compute the checksum directly
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				directSum += (unsigned) nextPoint.value()[d];
+			}
+
+			points.push_back(nextPoint.value());
 		}
 
-		// Insert
+		// Bulk load
 		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
-		spatialIndex->insert(nextPoint.value());
+		spatialIndex->bulkLoad(points);
 		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
 		std::chrono::duration<double> delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
-		totalTimeInserts += delta.count();
-		totalInserts += 1;
-		// std::cout << "Point[" << totalInserts << "] inserted. " << delta.count() << "s" << std::endl;
+		totalTimeBulkLoad = delta.count();
+		std::cout << "Bulk load OK." << std::endl;
+	}
+	else if (configU["insertbatch"])
+	{
+		// Insert points a batch at a time and time each batch
+		std::cout << "Inserting Points in batches of " << configU["insertbatch"] << "." << std::endl;
+		std::vector<Point> batch;
+		batch.reserve(configU["insertbatch"]);
+		for (;;)
+		{
+			nextPoint = pointGen.nextPoint();
+			if (nextPoint)
+			{
+				// Compute the checksum directly
+				for (unsigned d = 0; d < dimensions; ++d)
+				{
+					directSum += (unsigned) nextPoint.value()[d];
+				}
+
+				batch.push_back(nextPoint.value());
+			}
+
+			if (batch.size() == configU["insertbatch"] || (!nextPoint && !batch.empty()))
+			{
+				// Insert
+				std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+				spatialIndex->insertBatch(batch);
+				std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+				std::chrono::duration<double> delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+				totalTimeInserts += delta.count();
+				totalInserts += batch.size();
+				batch.clear();
+			}
+
+			if (!nextPoint)
+			{
+				break;
+			}
+		}
+		std::cout << "Insertion OK." << std::endl;
+	}
+	else
+	{
+		// Insert points and time their insertion
+		std::cout << "Inserting Points." << std::endl;
+		while((nextPoint = pointGen.nextPoint()) /* Intentional = and not == */)
+		{
+			// Compute the checksum directly
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				directSum += (unsigned) nextPoint.value()[d];
+			}
+
+			// Insert
+			std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+			spatialIndex->insert(nextPoint.value());
+			std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+			std::chrono::duration<double> delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+			totalTimeInserts += delta.count();
+			totalInserts += 1;
+			// std::cout << "Point[" << totalInserts << "] inserted. " << delta.count() << "s" << std::endl;
+		}
+		std::cout << "Insertion OK." << std::endl;
+	}
+
+	// Save the tree for later runs to read back
+	if (!configS["snapshot"].empty() && !snapshotLoaded)
+	{
+		if (!spatialIndex->save(configS["snapshot"]))
+		{
+			std::cout << "Bad Snapshot!" << std::endl;
+			exit(1);
+		}
+		std::cout << "Snapshot save OK." << std::endl;
 	}
-	std::cout << "Insertion OK." << std::endl;
 
 	// Visualize the tree
 	if (configU["visualization"])
@@ -609,6 +754,30 @@ static void runBench(PointGenerator<T> &pointGen, std::map<std::string, unsigned
 		totalTimeSearches += delta.count();
 		totalSearches += 1;
 		// std::cout << "Point[" << i << "] queried. " << delta.count() << " s" << std::endl;
+
+		if (configU["knn"])
+		{
+			// Nearest neighbours of a stored point start with the point itself
+			begin = std::chrono::high_resolution_clock::now();
+			std::vector<Point> neighbours = spatialIndex->nearest(p, configU["knn"]);
+			end = std::chrono::high_resolution_clock::now();
+			delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+			totalTimeKnnSearches += delta.count();
+			totalKnnSearches += 1;
+
+			if (neighbours.empty() || neighbours[0].distance(p) != 0.0)
+			{
+				exit(1);
+			}
+
+#ifndef NDEBUG
+			// Validate neighbours are ordered by distance
+			for (unsigned i = 1; i < neighbours.size(); ++i)
+			{
+				assert(neighbours[i - 1].distance(p) <= neighbours[i].distance(p));
+			}
+#endif
+		}
 	}
 	std::cout << "Search OK." << std::endl;
 
@@ -623,30 +792,196 @@ static void runBench(PointGenerator<T> &pointGen, std::map<std::string, unsigned
 	// Search for rectangles
 	unsigned rangeSearchChecksum = 0;
 	std::cout << "Beginning search for " << configU["rectanglescount"] << " rectangles..." << std::endl;
-	for (unsigned i = 0; i < configU["rectanglescount"]; ++i)
+	if (configU["searchbatch"])
 	{
-		// Search
-		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
-		std::vector<Point> v = spatialIndex->search(searchRectangles[i]);
-		std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
-		std::chrono::duration<double> delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
-		totalTimeRangeSearches += delta.count();
-		totalRangeSearches += 1;
-		rangeSearchChecksum += v.size();
-		// std::cout << "searchRectangles[" << i << "] queried. " << delta.count() << " s" << std::endl;
-		// std::cout << "searchRectangles[" << i << "] returned " << v.size() << " points" << std::endl;
+		// Search for rectangles a batch at a time sharing one traversal per batch
+		std::vector<Rectangle> batch;
+		batch.reserve(configU["searchbatch"]);
+		for (unsigned i = 0; i < configU["rectanglescount"]; i += configU["searchbatch"])
+		{
+			batch.assign(searchRectangles + i, searchRectangles + std::min(i + configU["searchbatch"], configU["rectanglescount"]));
+
+			// Search
+			std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+			std::vector<std::vector<Point>> vs = spatialIndex->searchBatch(batch);
+			std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+			std::chrono::duration<double> delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+			totalTimeRangeSearches += delta.count();
+			totalRangeSearches += batch.size();
+
+			for (unsigned j = 0; j < vs.size(); ++j)
+			{
+				rangeSearchChecksum += vs[j].size();
 
 #ifndef NDEBUG
-		// Validate points returned in the search
-		for (unsigned j = 0; j < v.size(); ++j)
-		{
-			assert(searchRectangles[i].containsPoint(v[j]));
+				// Validate points returned in the search
+				for (unsigned k = 0; k < vs[j].size(); ++k)
+				{
+					assert(batch[j].containsPoint(vs[j][k]));
+				}
+#endif
+			}
 		}
-		// std::cout << v.size() << " points verified." << std::endl;
+	}
+	else
+	{
+		for (unsigned i = 0; i < configU["rectanglescount"]; ++i)
+		{
+			// Search
+			std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+			std::vector<Point> v = spatialIndex->search(searchRectangles[i]);
+			std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+			std::chrono::duration<double> delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+			totalTimeRangeSearches += delta.count();
+			totalRangeSearches += 1;
+			rangeSearchChecksum += v.size();
+			// std::cout << "searchRectangles[" << i << "] queried. " << delta.count() << " s" << std::endl;
+			// std::cout << "searchRectangles[" << i << "] returned " << v.size() << " points" << std::endl;
+
+#ifndef NDEBUG
+			// Validate points returned in the search
+			for (unsigned j = 0; j < v.size(); ++j)
+			{
+				assert(searchRectangles[i].containsPoint(v[j]));
+			}
+			// std::cout << v.size() << " points verified." << std::endl;
 #endif
+		}
 	}
 	std::cout << "Range search OK. Checksum = " << rangeSearchChecksum << std::endl;
 
+	// Repeat the range searches on the R*-tree written out as pages and mapped back in
+	if (!configS["paged"].empty())
+	{
+		rstartree::RStarTree *rStarTree = dynamic_cast<rstartree::RStarTree *>(spatialIndex);
+		size_t pageBytes = configU["nodebytes"] != 0 && configU["nodebytes"] % nodesizing::pageBytes == 0 ? configU["nodebytes"] : nodesizing::pageBytes;
+		if (rStarTree == nullptr || !rstartree::PagedRStarTree::build(*rStarTree, configS["paged"], pageBytes))
+		{
+			std::cout << "Bad Paged Tree!" << std::endl;
+			exit(1);
+		}
+
+		rstartree::PagedRStarTree pagedTree(configS["paged"]);
+		unsigned pagedRangeSearchChecksum = 0;
+		std::cout << "Beginning paged search for " << configU["rectanglescount"] << " rectangles..." << std::endl;
+		for (unsigned i = 0; pagedTree.good() && i < configU["rectanglescount"]; ++i)
+		{
+			// Search
+			std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+			std::vector<Point> v = pagedTree.search(searchRectangles[i]);
+			std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+			std::chrono::duration<double> delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+			totalTimePagedRangeSearches += delta.count();
+			pagedRangeSearchChecksum += v.size();
+		}
+
+		if (!pagedTree.good() || pagedRangeSearchChecksum != rangeSearchChecksum)
+		{
+			std::cout << "Bad Paged Search!" << std::endl;
+			exit(1);
+		}
+		std::cout << "Paged range search OK. Checksum = " << pagedRangeSearchChecksum << std::endl;
+	}
+
+	// Count the same rectangles without materialising their points
+	if (configU["count"])
+	{
+		unsigned countChecksum = 0;
+		std::cout << "Beginning count of " << configU["rectanglescount"] << " rectangles..." << std::endl;
+		for (unsigned i = 0; i < configU["rectanglescount"]; ++i)
+		{
+			// Count
+			std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+			countChecksum += spatialIndex->count(searchRectangles[i]);
+			std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+			std::chrono::duration<double> delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+			totalTimeCounts += delta.count();
+			totalCounts += 1;
+		}
+
+		if (countChecksum != rangeSearchChecksum)
+		{
+			std::cout << "Bad Count Checksum!" << std::endl;
+			exit(1);
+		}
+		std::cout << "Count OK. Checksum = " << countChecksum << std::endl;
+	}
+
+	// Repeat the read-only queries split across threads to see how the read path scales
+	double parallelTime = 0.0;
+	std::vector<unsigned> threadSearches(configU["threads"], 0);
+	std::vector<unsigned> threadRangeSearches(configU["threads"], 0);
+	std::vector<double> threadTimeSearches(configU["threads"], 0.0);
+	std::vector<double> threadTimeRangeSearches(configU["threads"], 0.0);
+	if (configU["threads"])
+	{
+		// Gather the search points up front so threads do not share the generator
+		std::vector<Point> searchPoints;
+		pointGen.reset();
+		while((nextPoint = pointGen.nextPoint()) /* Intentional = not == */)
+		{
+			searchPoints.push_back(nextPoint.value());
+		}
+
+		std::cout << "Beginning parallel search on " << configU["threads"] << " threads..." << std::endl;
+		const Index *readIndex = spatialIndex;
+		unsigned threads = configU["threads"];
+		unsigned rectanglesCount = configU["rectanglescount"];
+		unsigned parallelRangeSearchChecksum = 0;
+		bool parallelSearchOK = true;
+		std::chrono::high_resolution_clock::time_point parallelBegin = std::chrono::high_resolution_clock::now();
+		#pragma omp parallel num_threads(threads) reduction(+:parallelRangeSearchChecksum) reduction(&&:parallelSearchOK)
+		{
+			// Keep the timings local so threads do not share cache lines while querying
+			unsigned thread = omp_get_thread_num();
+			unsigned searches = 0;
+			unsigned rangeSearches = 0;
+			double timeSearches = 0.0;
+			double timeRangeSearches = 0.0;
+
+			#pragma omp for schedule(static)
+			for (unsigned i = 0; i < searchPoints.size(); ++i)
+			{
+				// Search
+				const Point &p = searchPoints[i];
+				std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+				std::vector<Point> v = readIndex->search(p);
+				std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+				std::chrono::duration<double> delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+				timeSearches += delta.count();
+				searches += 1;
+				parallelSearchOK = parallelSearchOK && !v.empty() && v[0] == p;
+			}
+
+			#pragma omp for schedule(static)
+			for (unsigned i = 0; i < rectanglesCount; ++i)
+			{
+				// Search
+				std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+				std::vector<Point> v = readIndex->search(searchRectangles[i]);
+				std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+				std::chrono::duration<double> delta = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin);
+				timeRangeSearches += delta.count();
+				rangeSearches += 1;
+				parallelRangeSearchChecksum += v.size();
+			}
+
+			threadSearches[thread] = searches;
+			threadRangeSearches[thread] = rangeSearches;
+			threadTimeSearches[thread] = timeSearches;
+			threadTimeRangeSearches[thread] = timeRangeSearches;
+		}
+		std::chrono::high_resolution_clock::time_point parallelEnd = std::chrono::high_resolution_clock::now();
+		parallelTime = std::chrono::duration_cast<std::chrono::duration<double>>(parallelEnd - parallelBegin).count();
+
+		if (!parallelSearchOK || parallelRangeSearchChecksum != rangeSearchChecksum)
+		{
+			std::cout << "Bad Parallel Search!" << std::endl;
+			exit(1);
+		}
+		std::cout << "Parallel search OK. Checksum = " << parallelRangeSearchChecksum << std::endl;
+	}
+
 	// Gather statistics
 #ifdef STAT
 	spatialIndex->stat();
@@ -677,13 +1012,60 @@ static void runBench(PointGenerator<T> &pointGen, std::map<std::string, unsigned
 	}
 	std::cout << "Deletion OK." << std::endl;
 
+	// Gather allocation statistics, after deletion so that removes are covered too
+#ifdef ALLOCPROFILE
+	std::cout << spatialIndex->allocationProfile;
+	std::cout << "Allocation Statistics OK." << std::endl;
+#endif
+
 	// Timing Statistics
-	std::cout << "Total time to insert: " << totalTimeInserts << "s" << std::endl;
-	std::cout << "Avg time to insert: " << totalTimeInserts / (double) totalInserts << "s" << std::endl;
+	if (snapshotLoaded)
+	{
+		std::cout << "Total time to load snapshot: " << totalTimeLoad << "s" << std::endl;
+	}
+	else if (configU["bulkload"])
+	{
+		std::cout << "Total time to bulk load: " << totalTimeBulkLoad << "s" << std::endl;
+	}
+	else
+	{
+		std::cout << "Total time to insert: " << totalTimeInserts << "s" << std::endl;
+		std::cout << "Avg time to insert: " << totalTimeInserts / (double) totalInserts << "s" << std::endl;
+	}
 	std::cout << "Total time to search: " << totalTimeSearches << "s" << std::endl;
 	std::cout << "Avg time to search: " << totalTimeSearches / totalSearches << "s" << std::endl;
 	std::cout << "Total time to range search: " << totalTimeRangeSearches << "s" << std::endl;
 	std::cout << "Avg time to range search: " << totalTimeRangeSearches / totalRangeSearches << "s" << std::endl;
+	if (configU["knn"])
+	{
+		std::cout << "Total time to kNN search: " << totalTimeKnnSearches << "s" << std::endl;
+		std::cout << "Avg time to kNN search: " << totalTimeKnnSearches / totalKnnSearches << "s" << std::endl;
+	}
+	if (!configS["paged"].empty())
+	{
+		std::cout << "Total time to paged range search: " << totalTimePagedRangeSearches << "s" << std::endl;
+		std::cout << "Avg time to paged range search: " << totalTimePagedRangeSearches / totalRangeSearches << "s" << std::endl;
+	}
+	if (configU["count"])
+	{
+		std::cout << "Total time to count: " << totalTimeCounts << "s" << std::endl;
+		std::cout << "Avg time to count: " << totalTimeCounts / totalCounts << "s" << std::endl;
+	}
+	if (configU["threads"])
+	{
+		unsigned parallelQueries = 0;
+		for (unsigned thread = 0; thread < configU["threads"]; ++thread)
+		{
+			parallelQueries += threadSearches[thread] + threadRangeSearches[thread];
+		}
+		std::cout << "Total time to parallel search: " << parallelTime << "s" << std::endl;
+		std::cout << "Parallel throughput: " << parallelQueries / parallelTime << " queries/s" << std::endl;
+		for (unsigned thread = 0; thread < configU["threads"]; ++thread)
+		{
+			std::cout << "  Thread " << thread << " avg time to search: " << threadTimeSearches[thread] / threadSearches[thread] << "s";
+			std::cout << ", avg time to range search: " << threadTimeRangeSearches[thread] / threadRangeSearches[thread] << "s" << std::endl;
+		}
+	}
 	std::cout << "Total time to delete: " << totalTimeDeletes << "s" << std::endl;
 	std::cout << "Avg time to delete: " << totalTimeDeletes / (double) totalDeletes << "s" << std::endl;
 
@@ -692,8 +1074,11 @@ static void runBench(PointGenerator<T> &pointGen, std::map<std::string, unsigned
 	delete [] searchRectangles;
 }
 
-void randomPoints(std::map<std::string, unsigned> &configU, std::map<std::string, double> &configD)
+void randomPoints(std::map<std::string, unsigned> &configU, std::map<std::string, double> &configD, std::map<std::string, std::string> &configS)
 {
+	BenchTypeClasses::Benchmark::chunkSize = configU["chunksize"];
+	BenchTypeClasses::Benchmark::chunkBuffers = configU["chunkbuffers"];
+
 	switch (configU["distribution"])
 	{
 		case UNIFORM:
@@ -702,49 +1087,49 @@ void randomPoints(std::map<std::string, unsigned> &configU, std::map<std::string
 			BenchTypeClasses::Uniform::dimensions = dimensions;
 			BenchTypeClasses::Uniform::seed = configU["seed"];
 			PointGenerator<BenchTypeClasses::Uniform> pointGen;
-			runBench(pointGen, configU, configD);
+			runBench(pointGen, configU, configD, configS);
 			break;
 		}
 		case SKEW:
 		{
 			PointGenerator<BenchTypeClasses::Skew> pointGen;
-			runBench(pointGen, configU, configD);
+			runBench(pointGen, configU, configD, configS);
 			break;
 		}
 		case CALIFORNIA:
 		{
 			PointGenerator<BenchTypeClasses::California> pointGen;
-			runBench(pointGen, configU, configD);
+			runBench(pointGen, configU, configD, configS);
 			break;
 		}
 		case BIOLOGICAL:
 		{
 			PointGenerator<BenchTypeClasses::Biological> pointGen;
-			runBench(pointGen, configU, configD);
+			runBench(pointGen, configU, configD, configS);
 			break;
 		}
 		case FOREST:
 		{
 			PointGenerator<BenchTypeClasses::Forest> pointGen;
-			runBench(pointGen, configU, configD);
+			runBench(pointGen, configU, configD, configS);
 			break;
 		}
 		case CANADA:
 		{
 			PointGenerator<BenchTypeClasses::Canada> pointGen;
-			runBench(pointGen, configU, configD);
+			runBench(pointGen, configU, configD, configS);
 			break;
 		}
 		case GAIA:
 		{
 			PointGenerator<BenchTypeClasses::Gaia> pointGen;
-			runBench(pointGen, configU, configD);
+			runBench(pointGen, configU, configD, configS);
 			break;
 		}
 		case MICROSOFTBUILDINGS:
 		{
 			PointGenerator<BenchTypeClasses::MicrosoftBuildings> pointGen;
-			runBench(pointGen, configU, configD);
+			runBench(pointGen, configU, configD, configS);
 			break;
 		}
 	}
@@ -12,10 +12,14 @@
 #include <rtree/rtree.h>
 #include <rplustree/rplustree.h>
 #include <rstartree/rstartree.h>
+#include <rstartree/pagedRStarTree.h>
 #include <nirtree/nirtree.h>
 #include <quadtree/quadtree.h>
 #include <revisedrstartree/revisedrstartree.h>
 #include <optional>
+#include <util/pointFile.h>
+#include <util/textPoints.h>
+#include <util/pointPrefetcher.h>
 
 const unsigned BitDataSize = 60000;
 const unsigned BitQuerySize = 3164;
@@ -36,21 +40,30 @@ const unsigned MicrosoftBuildingsDataSize = 752704741;
 enum BenchType {UNIFORM, SKEW, CLUSTER, CALIFORNIA, BIOLOGICAL, FOREST, CANADA, GAIA, MICROSOFTBUILDINGS};
 enum TreeType {R_TREE, R_PLUS_TREE, R_STAR_TREE, NIR_TREE, QUAD_TREE, REVISED_R_STAR_TREE};
 
-void randomPoints(std::map<std::string, unsigned> &configU, std::map<std::string, double> &configD);
+void randomPoints(std::map<std::string, unsigned> &configU, std::map<std::string, double> &configD, std::map<std::string, std::string> &configS);
 
 // Tags defining how the benchmark is generated
 namespace BenchTag
 {
 	struct DistributionGenerated {};
 	struct FileBackedReadAll {};
+	// Parses the text file a chunk at a time ahead of the benchmark in a background thread
 	struct FileBackedReadChunksAtATime {};
+	// Maps a binary point file made by bin/convertPoints from the text file, read ahead the same way
+	struct FileBackedBinary {};
 	struct Error {};
 };
 
 // Classes for each benchmark with their relevant constants
 namespace BenchTypeClasses
 {
-	class Benchmark {};
+	class Benchmark
+	{
+		public:
+			// Points per chunk and chunks read ahead for benchmarks read by a background thread
+			static unsigned chunkSize;
+			static unsigned chunkBuffers;
+	};
 
 	class Uniform : public Benchmark
 	{
@@ -87,6 +100,7 @@ namespace BenchTypeClasses
 			static constexpr unsigned querySize = BiologicalQuerySize;
 			static constexpr unsigned dimensions = 3;
 			static constexpr char fileName[] = "/home/kjlangen/nir-tree/data/biological";
+			static constexpr char binaryFileName[] = "/home/kjlangen/nir-tree/data/biological.bin";
 	};
 
 	class Forest : public Benchmark
@@ -123,6 +137,7 @@ namespace BenchTypeClasses
 			static constexpr unsigned querySize = 0;
 			static constexpr unsigned dimensions = 2;
 			static constexpr char fileName[] = "/home/kjlangen/nir-tree/data/microsoftbuildings";
+			static constexpr char binaryFileName[] = "/home/kjlangen/nir-tree/data/microsoftbuildings.bin";
 	};
 };
 
@@ -143,7 +158,7 @@ namespace BenchDetail
 	struct getBenchTag<BenchTypeClasses::California> : BenchTag::FileBackedReadAll {};
 
 	template <>
-	struct getBenchTag<BenchTypeClasses::Biological> : BenchTag::FileBackedReadAll {};
+	struct getBenchTag<BenchTypeClasses::Biological> : BenchTag::FileBackedBinary {};
 
 	template <>
 	struct getBenchTag<BenchTypeClasses::Forest> : BenchTag::FileBackedReadAll {};
@@ -155,7 +170,7 @@ namespace BenchDetail
 	struct getBenchTag<BenchTypeClasses::Gaia> : BenchTag::FileBackedReadAll {};
 
 	template <>
-	struct getBenchTag<BenchTypeClasses::MicrosoftBuildings> : BenchTag::FileBackedReadChunksAtATime {};
+	struct getBenchTag<BenchTypeClasses::MicrosoftBuildings> : BenchTag::FileBackedBinary {};
 
 }
 
@@ -166,21 +181,31 @@ class PointGenerator
 		PointGenerator(BenchTag::DistributionGenerated);
 		PointGenerator(BenchTag::FileBackedReadAll);
 		PointGenerator(BenchTag::FileBackedReadChunksAtATime);
+		PointGenerator(BenchTag::FileBackedBinary);
 
 		void reset(BenchTag::DistributionGenerated);
 		void reset(BenchTag::FileBackedReadAll);
 		void reset(BenchTag::FileBackedReadChunksAtATime);
+		void reset(BenchTag::FileBackedBinary);
 		std::optional<Point> nextPoint(BenchTag::DistributionGenerated);
 		std::optional<Point> nextPoint(BenchTag::FileBackedReadAll);
 		std::optional<Point> nextPoint(BenchTag::FileBackedReadChunksAtATime);
+		std::optional<Point> nextPoint(BenchTag::FileBackedBinary);
+		size_t fillChunk(BenchTag::FileBackedReadChunksAtATime, Point *chunk, size_t capacity);
+		size_t fillChunk(BenchTag::FileBackedBinary, Point *chunk, size_t capacity);
 
 		// Class members
 		unsigned benchmarkSize;
 		unsigned seed;
 		std::fstream backingFile;
 		unsigned offset;
+		unsigned filledPoints;
 
 		std::vector<Point> pointBuffer;
+		pointfile::Reader pointFile;
+
+		// Declared last so the reader stops before the files it reads from close
+		PointPrefetcher prefetcher;
 
 	public:
 		static_assert(std::is_base_of<BenchTypeClasses::Benchmark, T>::value && 
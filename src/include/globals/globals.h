@@ -5,6 +5,6 @@
 #define DIM 2
 #endif
 
-const unsigned dimensions = DIM;
+constexpr unsigned dimensions = DIM;
 
 #endif
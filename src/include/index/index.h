@@ -2,19 +2,96 @@
 #define __INDEX__
 
 #include <iostream>
+#include <string>
+#include <type_traits>
 #include <util/geometry.h>
 #include <util/statistics.h>
+#include <util/allocationProfile.h>
 
 class Index
 {
 	public:
 		virtual ~Index() {};
 
+#ifdef ALLOCPROFILE
+		// Allocations made by each insert, remove and search, see AllocationProfile
+		AllocationProfile allocationProfile;
+#endif
+
 		virtual std::vector<Point> exhaustiveSearch(Point requestedPoint) = 0;
-		virtual std::vector<Point> search(Point requestedPoint) CONST_IF_NOT_STAT = 0;
-		virtual std::vector<Point> search(Rectangle requestedRectangle) CONST_IF_NOT_STAT = 0;
+		virtual std::vector<Point> search(Point requestedPoint) const = 0;
+		virtual std::vector<Point> search(Rectangle requestedRectangle) const = 0;
+
+		// Answers a batch of range queries, one result vector per rectangle in the same order.
+		// Trees with a shared traversal override this, everyone else runs the queries one by one.
+		virtual std::vector<std::vector<Point>> searchBatch(const std::vector<Rectangle> &requestedRectangles) const
+		{
+			std::vector<std::vector<Point>> results;
+			results.reserve(requestedRectangles.size());
+			for (const Rectangle &r : requestedRectangles)
+			{
+				results.push_back(search(r));
+			}
+
+			return results;
+		}
+
+		// Calls visitor(const Point &) for every point inside the rectangle without building a
+		// result vector. Concrete trees provide an inlinable template of the same name, through
+		// the base class it dispatches once per query to searchVisit.
+		template <typename Visitor>
+		void search(const Rectangle &requestedRectangle, Visitor &&visitor) const
+		{
+			typedef std::remove_reference_t<Visitor> V;
+			searchVisit(requestedRectangle, [](void *v, const Point &p) { (*static_cast<V *>(v))(p); }, (void *) &visitor);
+		}
+
+		typedef void (*PointVisitor)(void *visitor, const Point &point);
+		virtual void searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const = 0;
+
+		// Returns the k points closest to the given point ordered by increasing distance, fewer
+		// if the index holds fewer than k points
+		virtual std::vector<Point> nearest(const Point &givenPoint, unsigned k) const = 0;
+
+		// Returns how many points lie inside the rectangle. Trees keeping subtree counts stop at
+		// branches wholly inside it, everyone else counts through a visitor search.
+		virtual unsigned count(const Rectangle &requestedRectangle) const
+		{
+			unsigned matchingPoints = 0;
+			search(requestedRectangle, [&matchingPoints](const Point &) { ++matchingPoints; });
+
+			return matchingPoints;
+		}
+
 		virtual void insert(Point givenPoint) = 0;
 		virtual void remove(Point givenPoint) = 0;
+
+		// Builds the index from scratch over the given points. Trees with a packed loader
+		// override this, everyone else falls back to inserting the points one at a time.
+		virtual void bulkLoad(std::vector<Point> &points)
+		{
+			for (const Point &p : points)
+			{
+				insert(p);
+			}
+		}
+
+		// Inserts a batch of points into a possibly non-empty index. Trees presort the batch along
+		// the Hilbert curve and reuse the last leaf while consecutive points keep falling in it.
+		virtual void insertBatch(const std::vector<Point> &points)
+		{
+			for (const Point &p : points)
+			{
+				insert(p);
+			}
+		}
+
+		// Writes the tree to a binary snapshot and reads one back, see snapshot. Loading replaces
+		// whatever the tree held and leaves it empty if the snapshot was written by another kind of
+		// tree or with other branch factors.
+		virtual bool save(const std::string &path) const = 0;
+		virtual bool load(const std::string &path) = 0;
+
 		virtual unsigned checksum() = 0;
 		virtual bool validate() = 0;
 		virtual void stat() = 0;
@@ -34,19 +34,39 @@ namespace nirtree
 	{
 		public:
 			Node *root;
-			Statistics stats;
+			ThreadStatistics stats;
+			NodeArena<Node> nodeArena;
+			const unsigned minBranchFactor;
+			const unsigned maxBranchFactor;
+			// Bytes each entry of a leaf and of an internal node takes, see nodesizing
+			static constexpr size_t leafEntryBytes = sizeof(Point);
+			static constexpr size_t branchEntryBytes = sizeof(Node::Branch);
 
 			// Constructors and destructors
 			NIRTree(unsigned minBranchFactor, unsigned maxBranchFactor);
-			NIRTree(Node *root);
 			~NIRTree();
 
 			// Datastructure interface
 			std::vector<Point> exhaustiveSearch(Point requestedPoint);
-			std::vector<Point> search(Point requestedPoint) CONST_IF_NOT_STAT;
-			std::vector<Point> search(Rectangle requestedRectangle) CONST_IF_NOT_STAT;
+			std::vector<Point> search(Point requestedPoint) const;
+			std::vector<Point> search(Rectangle requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &&visitor) const
+			{
+				root->search(requestedRectangle, visitor);
+			}
+			void searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
+			unsigned count(const Rectangle &requestedRectangle) const;
+			std::vector<std::vector<Point>> searchBatch(const std::vector<Rectangle> &requestedRectangles) const;
 			void insert(Point givenPoint);
 			void remove(Point givenPoint);
+			void bulkLoad(std::vector<Point> &points);
+			void insertBatch(const std::vector<Point> &points);
+
+			// Snapshots
+			bool save(const std::string &path) const;
+			bool load(const std::string &path);
 
 			// Miscellaneous
 			unsigned checksum();
@@ -23,6 +23,7 @@
 #include <list>
 #include <queue>
 #include <utility>
+#include <cstdint>
 #include <cmath>
 #include <cstring>
 #include <iostream>
@@ -34,6 +35,13 @@
 #include <util/graph.h>
 #include <util/debug.h>
 #include <util/statistics.h>
+#include <util/nodeArena.h>
+#include <util/queryContext.h>
+#include <util/nearest.h>
+#include <util/hilbert.h>
+#include <util/leafHint.h>
+#include <util/leafPoints.h>
+#include <util/snapshot.h>
 
 namespace nirtree
 {
@@ -52,15 +60,16 @@ namespace nirtree
 			};
 
 			NIRTree &treeRef;
-			unsigned minBranchFactor;
-			unsigned maxBranchFactor;
 
+			void pack(std::vector<Point>::iterator begin, std::vector<Point>::iterator end, unsigned height);
 
 		public:
 			struct Branch
 			{
 				Node *child;
 				IsotheticPolygon boundingPoly;
+				// Number of points below this branch
+				unsigned count = 0;
 			};
 
 			struct SplitResult
@@ -77,20 +86,20 @@ namespace nirtree
 
 			Node *parent;
 			std::vector<Branch> branches;
-			std::vector<Point> data;
+			LeafPoints data;
 
 			// Constructors and destructors
-			Node(NIRTree &treeRef);
-			Node(NIRTree &treeRef, unsigned minBranch, unsigned maxBranch, Node *p=nullptr);
-			void deleteSubtrees();
+			Node(NIRTree &treeRef, Node *p=nullptr);
 
 			// Helper functions
-			bool isLeaf();
+			bool isLeaf() const;
 			Rectangle boundingBox();
 			Branch locateBranch(Node *child);
 			void updateBranch(Node *child, IsotheticPolygon &boundingPoly);
 			void removeBranch(Node *child);
 			void removeData(Point givenPoint);
+			unsigned subtreeCount();
+			void propagateCount(int delta);
 			Node *chooseNode(Point givenPoint);
 			Node *findLeaf(Point givenPoint);
 			Partition partitionNode();
@@ -101,10 +110,17 @@ namespace nirtree
 
 			// Data structure interface functions
 			void exhaustiveSearch(Point &requestedPoint, std::vector<Point> &accumulator);
-			std::vector<Point> search(Point &requestedPoint);
-			std::vector<Point> search(Rectangle &requestedRectangle);
+			std::vector<Point> search(const Point &requestedPoint) const;
+			std::vector<Point> search(const Rectangle &requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
+			unsigned count(const Rectangle &requestedRectangle) const;
+			void searchBatch(const std::vector<Rectangle> &requestedRectangles, std::vector<std::vector<Point>> &accumulators) const;
 			Node *insert(Point givenPoint);
 			Node *remove(Point givenPoint);
+			Node *bulkLoad(std::vector<Point> &points);
+			Node *insertBatch(const std::vector<Point> &points);
 
 			// Miscellaneous
 			unsigned checksum();
@@ -113,7 +129,40 @@ namespace nirtree
 			void printTree(unsigned n=0);
 			unsigned height();
 			void stat();
+			void save(snapshot::Writer &writer) const;
+			bool load(snapshot::Reader &reader);
 	};
+
+	// Visits every point inside the rectangle. The traversal stack comes from this thread's query
+	// context so steady state queries make no heap allocations. Not counted in STAT.
+	template <typename Visitor>
+	void Node::search(const Rectangle &requestedRectangle, Visitor &visitor) const
+	{
+		std::vector<const Node *> &context = QueryContext<const Node>::local().stack;
+		size_t base = context.size();
+		context.push_back(this);
+
+		for (;context.size() > base;)
+		{
+			const Node *currentContext = context.back();
+			context.pop_back();
+
+			if (currentContext->isLeaf())
+			{
+				currentContext->data.forEachContained(requestedRectangle, visitor);
+			}
+			else
+			{
+				for (const Branch &branch : currentContext->branches)
+				{
+					if (branch.boundingPoly.intersectsRectangle(requestedRectangle))
+					{
+						context.push_back(branch.child);
+					}
+				}
+			}
+		}
+	}
 }
 
 #endif
@@ -17,6 +17,10 @@
 #include <globals/globals.h>
 #include <util/geometry.h>
 #include <util/statistics.h>
+#include <util/nodeArena.h>
+#include <util/queryContext.h>
+#include <util/nearest.h>
+#include <util/snapshot.h>
 
 namespace quadtree
 {
@@ -34,17 +38,19 @@ namespace quadtree
 
 			// Constructors and destructors
 			Node(QuadTree &treeRef, Point &givenPoint, Node *p=nullptr);
-			void deleteSubtrees();
 
 			// Helper functions
-			unsigned nextBranch(Point &givenPoint);
-			std::vector<unsigned> nextBranch(Rectangle &givenRectangle);
-			bool isLeaf();
+			unsigned nextBranch(const Point &givenPoint) const;
+			std::vector<unsigned> nextBranch(const Rectangle &givenRectangle) const;
+			bool isLeaf() const;
 
 			// Data structure interface functions
 			void exhaustiveSearch(Point &requestedPoint, std::vector<Point> &accumulator);
-			std::vector<Point> search(Point &requestedPoint);
-			std::vector<Point> search(Rectangle &requestedRectangle);
+			std::vector<Point> search(const Point &requestedPoint) const;
+			std::vector<Point> search(const Rectangle &requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
 			void insert(Point givenPoint);
 			void remove(Point givenPoint);
 
@@ -55,7 +61,58 @@ namespace quadtree
 			void printTree(unsigned n=0);
 			unsigned height();
 			void stat();
+			void save(snapshot::Writer &writer) const;
+			bool load(snapshot::Reader &reader);
 	};
+
+	// Visits every point inside the rectangle. The traversal stack comes from this thread's query
+	// context so steady state queries make no heap allocations. Not counted in STAT.
+	template <typename Visitor>
+	void Node::search(const Rectangle &requestedRectangle, Visitor &visitor) const
+	{
+		std::vector<const Node *> &context = QueryContext<const Node>::local().stack;
+		size_t base = context.size();
+		context.push_back(this);
+
+		for (;context.size() > base;)
+		{
+			const Node *currentContext = context.back();
+			context.pop_back();
+
+			if (requestedRectangle.containsPoint(currentContext->data))
+			{
+				visitor(currentContext->data);
+			}
+
+			// Same quadrant test as nextBranch without building an index vector. Bit d of the
+			// quadrant number picks the upper half in dimension d.
+			for (unsigned i = 0; i < currentContext->branches.size(); ++i)
+			{
+				if (currentContext->branches[i] == nullptr)
+				{
+					continue;
+				}
+
+				bool placeInQuad = true;
+				for (unsigned d = 0; d < dimensions && placeInQuad; ++d)
+				{
+					if ((1 << d) & i)
+					{
+						placeInQuad = requestedRectangle.upperRight[d] > currentContext->data[d];
+					}
+					else
+					{
+						placeInQuad = requestedRectangle.lowerLeft[d] <= currentContext->data[d];
+					}
+				}
+
+				if (placeInQuad)
+				{
+					context.push_back(currentContext->branches[i]);
+				}
+			}
+		}
+	}
 }
 
 #endif
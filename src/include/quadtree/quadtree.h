@@ -19,7 +19,8 @@ namespace quadtree
 	{
 		public:
 			Node *root;
-			Statistics stats;
+			ThreadStatistics stats;
+			NodeArena<Node> nodeArena;
 			unsigned quadrants;
 
 			// Constructors and destructors
@@ -29,10 +30,25 @@ namespace quadtree
 
 			// Datastructure interface
 			std::vector<Point> exhaustiveSearch(Point requestedPoint);
-			std::vector<Point> search(Point requestedPoint) CONST_IF_NOT_STAT;
-			std::vector<Point> search(Rectangle requestedRectangle) CONST_IF_NOT_STAT;
+			std::vector<Point> search(Point requestedPoint) const;
+			std::vector<Point> search(Rectangle requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &&visitor) const
+			{
+				if (root != nullptr)
+				{
+					root->search(requestedRectangle, visitor);
+				}
+			}
+			void searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
 			void insert(Point givenPoint);
 			void remove(Point givenPoint);
+			void insertBatch(const std::vector<Point> &points);
+
+			// Snapshots
+			bool save(const std::string &path) const;
+			bool load(const std::string &path);
 
 			// Miscellaneous
 			unsigned checksum();
@@ -7,6 +7,7 @@
 #include <limits>
 #include <queue>
 #include <utility>
+#include <cstdint>
 #include <cmath>
 #include <cstring>
 #include <iostream>
@@ -17,6 +18,11 @@
 #include <util/geometry.h>
 #include <util/debug.h>
 #include <util/statistics.h>
+#include <util/nodeArena.h>
+#include <util/packedBoxes.h>
+#include <util/queryContext.h>
+#include <util/nearest.h>
+#include <util/snapshot.h>
 
 namespace revisedrstartree
 {
@@ -42,15 +48,14 @@ namespace revisedrstartree
 			};
 
 			Node *parent;
-			std::vector<Branch> branches;
+			PackedBoxes<Branch> branches;
 			std::vector<Point> data;
 
 			// Constructors and destructors
 			Node(RevisedRStarTree &treeRef, Node *p=nullptr);
-			void deleteSubtrees();
 
 			// Helper functions
-			bool isLeaf();
+			bool isLeaf() const;
 			Rectangle boundingBox();
 			void removeBranch(Node *child);
 			void removeData(Point givenPoint);
@@ -67,8 +72,12 @@ namespace revisedrstartree
 
 			// Data structure interface functions
 			void exhaustiveSearch(Point &requestedPoint, std::vector<Point> &accumulator);
-			std::vector<Point> search(Point &requestedPoint);
-			std::vector<Point> search(Rectangle &requestedRectangle);
+			std::vector<Point> search(const Point &requestedPoint) const;
+			std::vector<Point> search(const Rectangle &requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
+			void searchBatch(const std::vector<Rectangle> &requestedRectangles, std::vector<std::vector<Point>> &accumulators) const;
 			Node *insert(Point givenPoint);
 			Node *remove(Point givenPoint);
 
@@ -79,7 +88,43 @@ namespace revisedrstartree
 			void printTree(unsigned n=0);
 			unsigned height();
 			void stat();
+			void save(snapshot::Writer &writer) const;
+			bool load(snapshot::Reader &reader);
 	};
+
+	// Visits every point inside the rectangle. The traversal stack comes from this thread's query
+	// context so steady state queries make no heap allocations. Not counted in STAT.
+	template <typename Visitor>
+	void Node::search(const Rectangle &requestedRectangle, Visitor &visitor) const
+	{
+		std::vector<const Node *> &context = QueryContext<const Node>::local().stack;
+		size_t base = context.size();
+		context.push_back(this);
+
+		for (;context.size() > base;)
+		{
+			const Node *currentContext = context.back();
+			context.pop_back();
+
+			if (currentContext->isLeaf())
+			{
+				for (const Point &dataPoint : currentContext->data)
+				{
+					if (requestedRectangle.containsPoint(dataPoint))
+					{
+						visitor(dataPoint);
+					}
+				}
+			}
+			else
+			{
+				currentContext->branches.forEachIntersecting(requestedRectangle, [&](size_t i)
+				{
+					context.push_back(currentContext->branches[i].child);
+				});
+			}
+		}
+	}
 }
 
 #endif
@@ -7,6 +7,8 @@
 #include <iostream>
 #include <utility>
 #include <util/geometry.h>
+#include <util/hilbert.h>
+#include <util/leafHint.h>
 #include <revisedrstartree/node.h>
 #include <index/index.h>
 #include <util/bmpPrinter.h>
@@ -18,10 +20,14 @@ namespace revisedrstartree
 	{
 		public:
 			Node *root;
-			Statistics stats;
+			ThreadStatistics stats;
+			NodeArena<Node> nodeArena;
 
 			const unsigned minBranchFactor;
 			const unsigned maxBranchFactor;
+			// Bytes each entry of a leaf and of an internal node takes, see nodesizing
+			static constexpr size_t leafEntryBytes = sizeof(Point);
+			static constexpr size_t branchEntryBytes = sizeof(Node::Branch) + PackedBoxes<Node::Branch>::packedEntryBytes;
 			const double s = 0.5;
 
 			// Constructors and destructors
@@ -30,10 +36,23 @@ namespace revisedrstartree
 
 			// Datastructure interface
 			std::vector<Point> exhaustiveSearch(Point requestedPoint);
-			std::vector<Point> search(Point requestedPoint) CONST_IF_NOT_STAT;
-			std::vector<Point> search(Rectangle requestedRectangle) CONST_IF_NOT_STAT;
+			std::vector<Point> search(Point requestedPoint) const;
+			std::vector<Point> search(Rectangle requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &&visitor) const
+			{
+				root->search(requestedRectangle, visitor);
+			}
+			void searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
+			std::vector<std::vector<Point>> searchBatch(const std::vector<Rectangle> &requestedRectangles) const;
 			void insert(Point givenPoint);
 			void remove(Point givenPoint);
+			void insertBatch(const std::vector<Point> &points);
+
+			// Snapshots
+			bool save(const std::string &path) const;
+			bool load(const std::string &path);
 
 			// Miscellaneous
 			unsigned checksum();
@@ -18,6 +18,13 @@
 #include <util/graph.h>
 #include <util/debug.h>
 #include <util/statistics.h>
+#include <util/nodeArena.h>
+#include <util/packedBoxes.h>
+#include <util/queryContext.h>
+#include <util/nearest.h>
+#include <util/hilbert.h>
+#include <util/leafHint.h>
+#include <util/snapshot.h>
 
 namespace rplustree
 {
@@ -37,8 +44,6 @@ namespace rplustree
 			};
 
 			RPlusTree &treeRef;
-			unsigned minBranchFactor;
-			unsigned maxBranchFactor;
 
 			static std::vector<unsigned> histogramSearch;
 			static std::vector<unsigned> histogramLeaves;
@@ -65,13 +70,11 @@ namespace rplustree
 			};
 
 			Node *parent;
-			std::vector<Branch> branches;
+			PackedBoxes<Branch> branches;
 			std::vector<Point> data;
 
 			// Constructors and destructors
-			Node(RPlusTree &treeRef);
-			Node(RPlusTree &treeRef, unsigned minBranch, unsigned maxBranch, Node *p=nullptr);
-			void deleteSubtrees();
+			Node(RPlusTree &treeRef, Node *p=nullptr);
 
 			// Helper functions
 			Rectangle boundingBox();
@@ -89,10 +92,14 @@ namespace rplustree
 
 			// Data structure interface functions
 			void exhaustiveSearch(Point &requestedPoint, std::vector<Point> &accumulator);
-			std::vector<Point> search(Point &requestedPoint);
-			std::vector<Point> search(Rectangle &requestedRectangle);
+			std::vector<Point> search(const Point &requestedPoint) const;
+			std::vector<Point> search(const Rectangle &requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
 			Node *insert(Point givenPoint);
 			Node *remove(Point givenPoint);
+			Node *insertBatch(const std::vector<Point> &points);
 
 			// Miscellaneous
 			unsigned checksum();
@@ -101,7 +108,43 @@ namespace rplustree
 			void printTree(unsigned n=0);
 			unsigned height();
 			void stat();
+			void save(snapshot::Writer &writer) const;
+			bool load(snapshot::Reader &reader);
 	};
+
+	// Visits every point inside the rectangle. The traversal stack comes from this thread's query
+	// context so steady state queries make no heap allocations. Not counted in STAT.
+	template <typename Visitor>
+	void Node::search(const Rectangle &requestedRectangle, Visitor &visitor) const
+	{
+		std::vector<const Node *> &context = QueryContext<const Node>::local().stack;
+		size_t base = context.size();
+		context.push_back(this);
+
+		for (;context.size() > base;)
+		{
+			const Node *currentContext = context.back();
+			context.pop_back();
+
+			if (currentContext->branches.size() == 0)
+			{
+				for (const Point &dataPoint : currentContext->data)
+				{
+					if (requestedRectangle.containsPoint(dataPoint))
+					{
+						visitor(dataPoint);
+					}
+				}
+			}
+			else
+			{
+				currentContext->branches.forEachIntersecting(requestedRectangle, [&](size_t i)
+				{
+					context.push_back(currentContext->branches[i].child);
+				});
+			}
+		}
+	}
 }
 
 #endif
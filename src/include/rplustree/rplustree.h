@@ -20,21 +20,38 @@ namespace rplustree
 	{
 		public:
 			Node *root;
+			NodeArena<Node> nodeArena;
+			const unsigned minBranchFactor;
+			const unsigned maxBranchFactor;
+			// Bytes each entry of a leaf and of an internal node takes, see nodesizing
+			static constexpr size_t leafEntryBytes = sizeof(Point);
+			static constexpr size_t branchEntryBytes = sizeof(Node::Branch) + PackedBoxes<Node::Branch>::packedEntryBytes;
 #ifdef STAT
-			Statistics stats;
+			ThreadStatistics stats;
 #endif
 
 			// Constructors and destructors
 			RPlusTree(unsigned minBranchFactor, unsigned maxBranchFactor);
-			RPlusTree(Node *root);
 			~RPlusTree();
 
 			// Datastructure interface
 			std::vector<Point> exhaustiveSearch(Point requestedPoint);
-			std::vector<Point> search(Point requestedPoint) CONST_IF_NOT_STAT;
-			std::vector<Point> search(Rectangle requestedRectangle) CONST_IF_NOT_STAT;
+			std::vector<Point> search(Point requestedPoint) const;
+			std::vector<Point> search(Rectangle requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &&visitor) const
+			{
+				root->search(requestedRectangle, visitor);
+			}
+			void searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
 			void insert(Point givenPoint);
 			void remove(Point givenPoint);
+			void insertBatch(const std::vector<Point> &points);
+
+			// Snapshots
+			bool save(const std::string &path) const;
+			bool load(const std::string &path);
 
 			// Miscellaneous
 			unsigned checksum();
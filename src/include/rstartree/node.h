@@ -7,15 +7,21 @@
 #include <map>
 #include <list>
 #include <utility>
+#include <cstdint>
 #include <cmath>
 #include <numeric>
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <memory>
-#include <variant>
 #include <globals/globals.h>
 #include <util/geometry.h>
 #include <util/statistics.h>
+#include <util/nodeArena.h>
+#include <util/packedBoxes.h>
+#include <util/queryContext.h>
+#include <util/nearest.h>
+#include <util/snapshot.h>
 
 namespace rstartree
 {
@@ -27,41 +33,52 @@ namespace rstartree
 
 			RStarTree &treeRef;
 
-			void searchSub(const Point &requestedPoint, std::vector<Point> &accumulator) CONST_IF_NOT_STAT;
-			void searchSub(const Rectangle &rectangle, std::vector<Point> &accumulator) CONST_IF_NOT_STAT;
+			void searchSub(const Point &requestedPoint, std::vector<Point> &accumulator) const;
+			void searchSub(const Rectangle &rectangle, std::vector<Point> &accumulator) const;
+			std::vector<Rectangle> entryBoxes() const;
+			Node *completeInsertion(Node *insertionPoint, std::vector<bool> &hasReinsertedOnLevel);
 
 		public:
 			class Branch
 			{
 				public:
 					Rectangle boundingBox;
-					Node *child;
+					// Resolved through the tree's node arena, see childOf
+					NodeHandle child;
+					// Number of points below this branch
+					unsigned count;
 
-					Branch(Rectangle boundingBox, Node *child) : boundingBox(boundingBox), child(child) {}
-					Branch(const Branch &other) : boundingBox(other.boundingBox), child(other.child) {}
+					Branch(Rectangle boundingBox, Node *child);
+					Branch(const Branch &other) : boundingBox(other.boundingBox), child(other.child), count(other.count) {}
 
 					bool operator==(const Branch &o) const;
 			};
-			typedef std::variant<Point, Branch> NodeEntry;
 
+			// Leaves only hold data and internal nodes only hold branches, whichever is not in use
+			// stays empty
 			Node *parent;
-			std::vector<NodeEntry> entries;
+			std::vector<Point, AlignedAllocator<Point>> data;
+			PackedBoxes<Branch> branches;
 			unsigned level;
 
 			// Constructors and destructors
 			Node(RStarTree &treeRef, Node *p=nullptr, unsigned level=0);
-			void deleteSubtrees();
 
 			// Helper functions
+			inline Node *childOf(const Branch &branch) const;
 			Rectangle boundingBox() const;
 			bool updateBoundingBox(Node *child, Rectangle updatedBoundingBox);
 			void removeChild(Node *child);
 			void removeData(const Point &givenPoint);
-			Node *chooseSubtree(const NodeEntry &nodeEntry);
+			unsigned subtreeCount() const;
+			void propagateCount(int delta);
+			Node *chooseSubtree(const Rectangle &givenBoundingBox, unsigned stoppingLevel);
+			inline Node *chooseSubtree(const Point &givenPoint) { return chooseSubtree(Rectangle(givenPoint, givenPoint), 0); }
 			Node *findLeaf(const Point &givenPoint);
 			inline bool isLeafNode() const { return level == 0; }
+			inline unsigned entryCount() const { return data.size() + branches.size(); }
 			double computeTotalMarginSum();
-			double computeTotalMarginSum(std::vector<NodeEntry *> ptrs);
+			double computeTotalMarginSum(const std::vector<Rectangle> &boundingBoxes);
 			unsigned chooseSplitLeafAxis();
 			unsigned chooseSplitNonLeafAxis();
 			unsigned chooseSplitAxis();
@@ -75,11 +92,17 @@ namespace rstartree
 			// Datastructure interface functions
 			void exhaustiveSearch(const Point &requestedPoint, std::vector<Point> &accumulator) const;
 
-			std::vector<Point> search(const Point &requestedPoint) CONST_IF_NOT_STAT;
-			std::vector<Point> search(const Rectangle &requestedRectangle) CONST_IF_NOT_STAT;
+			std::vector<Point> search(const Point &requestedPoint) const;
+			std::vector<Point> search(const Rectangle &requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
+			unsigned count(const Rectangle &requestedRectangle) const;
+			void searchBatch(const std::vector<Rectangle> &requestedRectangles, std::vector<std::vector<Point>> &accumulators) const;
 
 			// These return the root of the tree.
-			Node *insert(NodeEntry nodeEntry, std::vector<bool> &hasReinsertedOnLevel);
+			Node *insert(const Point &givenPoint, std::vector<bool> &hasReinsertedOnLevel);
+			Node *insert(const Branch &givenBranch, std::vector<bool> &hasReinsertedOnLevel);
 			Node *remove(Point &givenPoint, std::vector<bool> hasReinsertedOnLevel);
 
 			// Miscellaneous
@@ -88,13 +111,48 @@ namespace rstartree
 			void printTree() const;
 			unsigned height() const;
 			void stat() const;
+			void save(snapshot::Writer &writer) const;
+			bool load(snapshot::Reader &reader);
 
 			// Operators
 			bool operator<(const Node &otherNode) const;
 	};
 
-	Rectangle boxFromNodeEntry(const Node::NodeEntry &entry);
-	double computeOverlapGrowth(unsigned index, const std::vector<Node::NodeEntry> &entries, const Rectangle &rect);
+	// Visits every point inside the rectangle. The traversal stack comes from this thread's query
+	// context so steady state queries make no heap allocations. Not counted in STAT.
+	template <typename Visitor>
+	void Node::search(const Rectangle &requestedRectangle, Visitor &visitor) const
+	{
+		std::vector<const Node *> &context = QueryContext<const Node>::local().stack;
+		size_t base = context.size();
+		context.push_back(this);
+
+		for (;context.size() > base;)
+		{
+			const Node *currentContext = context.back();
+			context.pop_back();
+
+			if (currentContext->isLeafNode())
+			{
+				for (const Point &dataPoint : currentContext->data)
+				{
+					if (requestedRectangle.containsPoint(dataPoint))
+					{
+						visitor(dataPoint);
+					}
+				}
+			}
+			else
+			{
+				currentContext->branches.forEachIntersecting(requestedRectangle, [&](size_t i)
+				{
+					context.push_back(currentContext->childOf(currentContext->branches[i]));
+				});
+			}
+		}
+	}
+
+	double computeOverlapGrowth(unsigned index, const std::vector<Node::Branch> &branches, const Rectangle &rect);
 }
 
 #endif
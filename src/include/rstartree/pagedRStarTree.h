@@ -0,0 +1,147 @@
+#ifndef __PAGEDRSTARTREE__
+#define __PAGEDRSTARTREE__
+
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <globals/globals.h>
+#include <util/geometry.h>
+#include <util/simd.h>
+#include <util/nodeSizing.h>
+#include <util/queryContext.h>
+#include <rstartree/rstartree.h>
+
+namespace rstartree
+{
+	// A read-only R*-tree laid out in fixed size pages of a file which is mapped into memory and
+	// searched in place, so opening one is a single mmap however large the tree is and the page
+	// cache decides which parts of it stay resident. Page 0 holds the header and every other page
+	// one node, with children named by page number. Entries are kept one column per coordinate as
+	// in PackedBoxes so searches test them through the SIMD kernels straight off the mapping.
+	//
+	// Files are built from an RStarTree whose nodes each fit in a page, in the layout and byte order
+	// of the machine building them. Pages are a multiple of 4KB, 16KB holds four times the entries.
+	class PagedRStarTree
+	{
+		public:
+			// Every node page starts with this and its entries follow. A leaf keeps a column of
+			// coordinates per dimension, an internal node a column of lower and one of upper
+			// corners per dimension then the page numbers and point counts of its children.
+			struct Page
+			{
+				uint32_t level;
+				uint32_t count;
+			};
+
+			// Writes the tree out as a paged file, false if a node does not fit in a page
+			static bool build(const RStarTree &tree, const std::string &path, size_t pageBytes=nodesizing::pageBytes);
+
+			// Entries a page of each kind holds
+			static inline size_t leafSlots(size_t pageBytes) { return (pageBytes - sizeof(Page)) / (dimensions * sizeof(double)); }
+			static inline size_t branchSlots(size_t pageBytes) { return (pageBytes - sizeof(Page)) / (2 * dimensions * sizeof(double) + 2 * sizeof(uint32_t)); }
+
+			// Constructors and destructors
+			explicit PagedRStarTree(const std::string &path);
+			PagedRStarTree(const PagedRStarTree &) = delete;
+			PagedRStarTree &operator=(const PagedRStarTree &) = delete;
+			~PagedRStarTree();
+
+			// False if the file could not be mapped or is not a paged tree for this dimension
+			inline bool good() const { return mapping != nullptr; }
+			size_t size() const;
+
+			// Datastructure interface
+			std::vector<Point> search(const Point &requestedPoint) const;
+			std::vector<Point> search(const Rectangle &requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &&visitor) const;
+			unsigned count(const Rectangle &requestedRectangle) const;
+
+			// Miscellaneous
+			unsigned checksum() const;
+
+		private:
+			struct Header;
+
+			const Header &header() const;
+			inline const Page *page(uint32_t number) const { return reinterpret_cast<const Page *>(mapping + number * pageBytes); }
+			inline const double *columns(const Page *nodePage) const { return reinterpret_cast<const double *>(nodePage + 1); }
+			inline const uint32_t *childPages(const Page *nodePage) const { return reinterpret_cast<const uint32_t *>(columns(nodePage) + 2 * dimensions * branchCount); }
+			inline const uint32_t *childCounts(const Page *nodePage) const { return childPages(nodePage) + branchCount; }
+
+			const char *mapping;
+			size_t mappedBytes;
+			size_t pageBytes;
+			size_t leafCount;
+			size_t branchCount;
+			uint32_t rootPage;
+	};
+
+	// Visits every point inside the rectangle. The traversal stack comes from this thread's query
+	// context so steady state queries make no heap allocations.
+	template <typename Visitor>
+	void PagedRStarTree::search(const Rectangle &requestedRectangle, Visitor &&visitor) const
+	{
+		assert(good());
+
+		std::vector<const Page *> &context = QueryContext<const Page>::local().stack;
+		size_t base = context.size();
+		context.push_back(page(rootPage));
+
+		const double *blockLower[dimensions];
+		const double *blockUpper[dimensions];
+		for (;context.size() > base;)
+		{
+			const Page *currentPage = context.back();
+			context.pop_back();
+			const double *column = columns(currentPage);
+
+			if (currentPage->level == 0)
+			{
+				for (size_t blockBegin = 0; blockBegin < currentPage->count; blockBegin += 64)
+				{
+					unsigned blockSize = (unsigned) std::min((size_t) 64, currentPage->count - blockBegin);
+					for (unsigned d = 0; d < dimensions; ++d)
+					{
+						blockLower[d] = column + d * leafCount + blockBegin;
+					}
+
+					uint64_t mask = simd::containsMask(blockLower, blockSize, requestedRectangle.lowerLeft.values, requestedRectangle.upperRight.values);
+					for (; mask != 0; mask &= mask - 1)
+					{
+						size_t i = blockBegin + __builtin_ctzll(mask);
+						Point dataPoint;
+						for (unsigned d = 0; d < dimensions; ++d)
+						{
+							dataPoint[d] = column[d * leafCount + i];
+						}
+						visitor(dataPoint);
+					}
+				}
+			}
+			else
+			{
+				const uint32_t *children = childPages(currentPage);
+				for (size_t blockBegin = 0; blockBegin < currentPage->count; blockBegin += 64)
+				{
+					unsigned blockSize = (unsigned) std::min((size_t) 64, currentPage->count - blockBegin);
+					for (unsigned d = 0; d < dimensions; ++d)
+					{
+						blockLower[d] = column + 2 * d * branchCount + blockBegin;
+						blockUpper[d] = column + (2 * d + 1) * branchCount + blockBegin;
+					}
+
+					uint64_t mask = simd::intersectsMask(blockLower, blockUpper, blockSize, requestedRectangle.lowerLeft.values, requestedRectangle.upperRight.values);
+					for (; mask != 0; mask &= mask - 1)
+					{
+						context.push_back(page(children[blockBegin + __builtin_ctzll(mask)]));
+					}
+				}
+			}
+		}
+	}
+}
+
+#endif
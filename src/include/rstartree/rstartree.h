@@ -2,11 +2,15 @@
 #define __RSTARTREE__
 
 #include <cassert>
+#include <cmath>
 #include <vector>
+#include <algorithm>
 #include <stack>
 #include <iostream>
 #include <index/index.h>
 #include <util/geometry.h>
+#include <util/hilbert.h>
+#include <util/leafHint.h>
 #include <rstartree/node.h>
 #include <util/bmpPrinter.h>
 
@@ -18,9 +22,13 @@ namespace rstartree
 			static constexpr float p = 0.3; // For reinsertion entries. 0.3 by default
 
 			Node *root;
-			Statistics stats;
+			ThreadStatistics stats;
+			NodeArena<Node> nodeArena;
 			const unsigned minBranchFactor;
 			const unsigned maxBranchFactor;
+			// Bytes each entry of a leaf and of an internal node takes, see nodesizing
+			static constexpr size_t leafEntryBytes = sizeof(Point);
+			static constexpr size_t branchEntryBytes = sizeof(Node::Branch) + PackedBoxes<Node::Branch>::packedEntryBytes;
 
 			std::vector<bool> hasReinsertedOnLevel;
 
@@ -30,10 +38,25 @@ namespace rstartree
 
 			// Datastructure interface
 			std::vector<Point> exhaustiveSearch(Point requestedPoint);
-			std::vector<Point> search(Point requestedPoint) CONST_IF_NOT_STAT;
-			std::vector<Point> search(Rectangle requestedRectangle) CONST_IF_NOT_STAT;
+			std::vector<Point> search(Point requestedPoint) const;
+			std::vector<Point> search(Rectangle requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &&visitor) const
+			{
+				root->search(requestedRectangle, visitor);
+			}
+			void searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
+			unsigned count(const Rectangle &requestedRectangle) const;
+			std::vector<std::vector<Point>> searchBatch(const std::vector<Rectangle> &requestedRectangles) const;
 			void insert(Point givenPoint);
 			void remove(Point givenPoint);
+			void bulkLoad(std::vector<Point> &points);
+			void insertBatch(const std::vector<Point> &points);
+
+			// Snapshots
+			bool save(const std::string &path) const;
+			bool load(const std::string &path);
 
 			// Miscellaneous
 			unsigned checksum();
@@ -42,6 +65,11 @@ namespace rstartree
 			void stat();
 			void visualize();
 	};
+
+	inline Node *Node::childOf(const Branch &branch) const
+	{
+		return treeRef.nodeArena[branch.child];
+	}
 }
 
 #endif
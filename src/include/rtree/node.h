@@ -10,6 +10,13 @@
 #include <iostream>
 #include <util/geometry.h>
 #include <util/statistics.h>
+#include <util/nodeArena.h>
+#include <util/packedBoxes.h>
+#include <util/queryContext.h>
+#include <util/nearest.h>
+#include <util/hilbert.h>
+#include <util/leafHint.h>
+#include <util/snapshot.h>
 
 namespace rtree
 {
@@ -28,19 +35,15 @@ namespace rtree
 		};
 
 		RTree &treeRef;
-		unsigned minBranchFactor;
-		unsigned maxBranchFactor;
 
 		public:
 			Node *parent;
-			std::vector<Rectangle> boundingBoxes;
+			PackedBoxes<Rectangle> boundingBoxes;
 			std::vector<Node *> children;
 			std::vector<Point> data;
 
 			// Constructors and destructors
-			Node(RTree &treeRef);
-			Node(RTree &treeRef, unsigned minBranchFactor, unsigned maxBranchFactor, Node *p=nullptr);
-			void deleteSubtrees();
+			Node(RTree &treeRef, Node *p=nullptr);
 
 			// Helper functions
 			Rectangle boundingBox();
@@ -60,10 +63,15 @@ namespace rtree
 
 			// Datastructure interface functions
 			void exhaustiveSearch(Point &requestedPoint, std::vector<Point> &accumulator);
-			std::vector<Point> search(Point &requestedPoint);
-			std::vector<Point> search(Rectangle &requestedRectangle);
+			std::vector<Point> search(const Point &requestedPoint) const;
+			std::vector<Point> search(const Rectangle &requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
 			Node *insert(Point givenPoint);
 			Node *remove(Point givenPoint);
+			Node *bulkLoad(std::vector<Point> &points);
+			Node *insertBatch(const std::vector<Point> &points);
 
 			// Miscellaneous
 			unsigned checksum();
@@ -72,7 +80,43 @@ namespace rtree
 			void printTree(unsigned n=0);
 			unsigned height();
 			void stat();
+			void save(snapshot::Writer &writer) const;
+			bool load(snapshot::Reader &reader);
 	};
+
+	// Visits every point inside the rectangle. The traversal stack comes from this thread's query
+	// context so steady state queries make no heap allocations. Not counted in STAT.
+	template <typename Visitor>
+	void Node::search(const Rectangle &requestedRectangle, Visitor &visitor) const
+	{
+		std::vector<const Node *> &context = QueryContext<const Node>::local().stack;
+		size_t base = context.size();
+		context.push_back(this);
+
+		for (;context.size() > base;)
+		{
+			const Node *currentContext = context.back();
+			context.pop_back();
+
+			if (currentContext->children.size() == 0)
+			{
+				for (const Point &dataPoint : currentContext->data)
+				{
+					if (requestedRectangle.containsPoint(dataPoint))
+					{
+						visitor(dataPoint);
+					}
+				}
+			}
+			else
+			{
+				currentContext->boundingBoxes.forEachIntersecting(requestedRectangle, [&](size_t i)
+				{
+					context.push_back(currentContext->children[i]);
+				});
+			}
+		}
+	}
 }
 
 #endif
@@ -6,6 +6,7 @@
 #include <stack>
 #include <iostream>
 #include <utility>
+#include <chrono>
 #include <util/geometry.h>
 #include <rtree/node.h>
 #include <index/index.h>
@@ -17,19 +18,40 @@ namespace rtree
 	{
 		public:
 			Node *root;
-			Statistics stats;
+			ThreadStatistics stats;
+			NodeArena<Node> nodeArena;
+			const unsigned minBranchFactor;
+			const unsigned maxBranchFactor;
+			// Bytes each entry of a leaf and of an internal node takes, see nodesizing
+			static constexpr size_t leafEntryBytes = sizeof(Point);
+			static constexpr size_t branchEntryBytes = sizeof(Rectangle) + sizeof(Node *) + PackedBoxes<Rectangle>::packedEntryBytes;
+#ifdef STAT
+			double buildTime = 0.0;
+#endif
 
 			// Constructors and destructors
 			RTree(unsigned minBranchFactor, unsigned maxBranchFactor);
-			RTree(Node *root);
 			~RTree();
 
 			// Datastructure interface
 			std::vector<Point> exhaustiveSearch(Point requestedPoint);
-			std::vector<Point> search(Point requestedPoint) CONST_IF_NOT_STAT;
-			std::vector<Point> search(Rectangle requestedRectangle) CONST_IF_NOT_STAT;
+			std::vector<Point> search(Point requestedPoint) const;
+			std::vector<Point> search(Rectangle requestedRectangle) const;
+			template <typename Visitor>
+			void search(const Rectangle &requestedRectangle, Visitor &&visitor) const
+			{
+				root->search(requestedRectangle, visitor);
+			}
+			void searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const;
+			std::vector<Point> nearest(const Point &givenPoint, unsigned k) const;
 			void insert(Point givenPoint);
 			void remove(Point givenPoint);
+			void bulkLoad(std::vector<Point> &points);
+			void insertBatch(const std::vector<Point> &points);
+
+			// Snapshots
+			bool save(const std::string &path) const;
+			bool load(const std::string &path);
 
 			// Miscellaneous
 			unsigned checksum();
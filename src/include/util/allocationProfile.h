@@ -0,0 +1,152 @@
+#ifndef __ALLOCATIONPROFILE__
+#define __ALLOCATIONPROFILE__
+
+#include <vector>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+
+namespace allocationprofile
+{
+	// Allocations made so far by the calling thread
+	struct Counters
+	{
+		uint64_t allocations = 0;
+		uint64_t bytes = 0;
+	};
+
+	inline Counters &threadCounters()
+	{
+		thread_local Counters counters;
+		return counters;
+	}
+
+	// Every heap allocation goes through here when building with ALLOCPROFILE, the replaced
+	// global operator new calls it as do the few containers which take memory from malloc
+	inline void countAllocation(size_t bytes)
+	{
+#ifdef ALLOCPROFILE
+		Counters &counters = threadCounters();
+		counters.allocations++;
+		counters.bytes += bytes;
+#else
+		(void) bytes;
+#endif
+	}
+}
+
+// Histograms of the allocations and bytes allocated by each insert, remove, point search and
+// range search made on a tree. Operations record what their thread allocated between the start
+// and the end of the call so searches from several threads may record at once.
+class AllocationProfile
+{
+	public:
+		enum Operation { Insert, Remove, Search, RangeSearch, operationCount };
+
+		void record(Operation operation, const allocationprofile::Counters &made) const
+		{
+			std::lock_guard<std::mutex> lock(recordLock);
+			Histograms &histograms = operations[operation];
+
+			if (made.allocations >= histograms.allocations.size())
+			{
+				histograms.allocations.resize(made.allocations + 1, 0);
+			}
+			histograms.allocations[made.allocations]++;
+
+			// Bytes bucket k holds operations allocating less than 2^k bytes but at least 2^(k - 1)
+			unsigned bucket = made.bytes == 0 ? 0 : 64 - __builtin_clzll(made.bytes);
+			if (bucket >= histograms.bytes.size())
+			{
+				histograms.bytes.resize(bucket + 1, 0);
+			}
+			histograms.bytes[bucket]++;
+
+			histograms.calls++;
+			histograms.totalAllocations += made.allocations;
+			histograms.totalBytes += made.bytes;
+		}
+
+		friend std::ostream& operator<<(std::ostream &os, const AllocationProfile &profile)
+		{
+			static const char *names[operationCount] = {"Insert", "Remove", "Search", "Range Search"};
+
+			std::lock_guard<std::mutex> lock(profile.recordLock);
+			for (unsigned o = 0; o < operationCount; ++o)
+			{
+				const Histograms &histograms = profile.operations[o];
+				if (histograms.calls == 0)
+				{
+					continue;
+				}
+
+				os << "Allocations per " << names[o] << ": " << (double) histograms.totalAllocations / histograms.calls;
+				os << ", " << (double) histograms.totalBytes / histograms.calls << " bytes over " << histograms.calls << " calls" << std::endl;
+				os << "Histogram of Allocations per " << names[o] << " Follows:" << std::endl;
+				for (unsigned i = 0; i < histograms.allocations.size(); ++i)
+				{
+					if (histograms.allocations[i] > 0)
+					{
+						os << "  " << i << " : " << histograms.allocations[i] << std::endl;
+					}
+				}
+				os << "Histogram of Bytes Allocated per " << names[o] << " Follows:" << std::endl;
+				for (unsigned k = 0; k < histograms.bytes.size(); ++k)
+				{
+					if (histograms.bytes[k] > 0)
+					{
+						os << "  <" << (uint64_t(1) << k) << " : " << histograms.bytes[k] << std::endl;
+					}
+				}
+			}
+
+			return os;
+		}
+
+	private:
+		struct Histograms
+		{
+			std::vector<uint64_t> allocations;
+			std::vector<uint64_t> bytes;
+			uint64_t calls = 0;
+			uint64_t totalAllocations = 0;
+			uint64_t totalBytes = 0;
+		};
+
+		mutable std::mutex recordLock;
+		mutable Histograms operations[operationCount];
+};
+
+// Records the allocations its thread makes from construction to destruction as one operation
+class AllocationScope
+{
+	public:
+		AllocationScope(const AllocationProfile &profile, AllocationProfile::Operation operation) :
+			profile(profile), operation(operation), start(allocationprofile::threadCounters()) {}
+
+		~AllocationScope()
+		{
+			allocationprofile::Counters now = allocationprofile::threadCounters();
+			allocationprofile::Counters made;
+			made.allocations = now.allocations - start.allocations;
+			made.bytes = now.bytes - start.bytes;
+
+			// Keep the histograms' own growth out of the counts
+			profile.record(operation, made);
+			allocationprofile::threadCounters() = now;
+		}
+
+	private:
+		const AllocationProfile &profile;
+		const AllocationProfile::Operation operation;
+		const allocationprofile::Counters start;
+};
+
+#ifdef ALLOCPROFILE
+	#define ALLOCSCOPE(profile, operation) AllocationScope allocationScope(profile, AllocationProfile::operation)
+#else
+	#define ALLOCSCOPE(profile, operation)
+#endif
+
+#endif
@@ -41,9 +41,9 @@ class BMPPrinter
 		std::string bmpIdGenerator();
 
 		bool whitePixel(const unsigned x, const unsigned y);
-		void registerPoint(Point &point, Colour colour);
+		void registerPoint(const Point &point, Colour colour);
 		void registerQuadrants(Point &point, Rectangle limits, Colour colour);
-		void registerRectangle(Rectangle &boundingBox, Colour colour);
+		void registerRectangle(const Rectangle &boundingBox, Colour colour);
 		void registerRectangleArray(std::vector<Rectangle> &boundingBoxes);
 		void registerPolygon(IsotheticPolygon &polygon, Colour colour);
 
@@ -27,6 +27,7 @@
 #include <iterator>
 #include <functional>
 #include <util/debug.h>
+#include <util/smallVector.h>
 #include <globals/globals.h>
 
 class Point
@@ -73,12 +74,79 @@ class Point
 
 };
 
-bool operator<(const Point &lhs, const Point &rhs);
-bool operator>(const Point &lhs, const Point &rhs);
-bool operator<=(const Point &lhs, const Point &rhs);
-bool operator>=(const Point &lhs, const Point &rhs);
-bool operator==(const Point &lhs, const Point &rhs);
-bool operator!=(const Point &lhs, const Point &rhs);
+// Coordinate access and comparisons sit in the innermost loop of every search so they are
+// defined inline. Each comparison folds every dimension together with & rather than returning at
+// the first failing one, with dimensions known at compile time that is a short straight line of
+// compares the compiler unrolls and vectorises instead of a loop of branches.
+inline double &Point::operator[](unsigned index)
+{
+	return values[index];
+}
+
+inline const double Point::operator[](unsigned index) const
+{
+	return values[index];
+}
+
+inline bool operator<(const Point &lhs, const Point &rhs)
+{
+	bool result = true;
+	for (unsigned d = 0; d < dimensions; ++d)
+	{
+		result &= !(lhs[d] >= rhs[d]);
+	}
+
+	return result;
+}
+
+inline bool operator>(const Point &lhs, const Point &rhs)
+{
+	bool result = true;
+	for (unsigned d = 0; d < dimensions; ++d)
+	{
+		result &= !(lhs[d] <= rhs[d]);
+	}
+
+	return result;
+}
+
+inline bool operator<=(const Point &lhs, const Point &rhs)
+{
+	bool result = true;
+	for (unsigned d = 0; d < dimensions; ++d)
+	{
+		result &= !(lhs[d] > rhs[d]);
+	}
+
+	return result;
+}
+
+inline bool operator>=(const Point &lhs, const Point &rhs)
+{
+	bool result = true;
+	for (unsigned d = 0; d < dimensions; ++d)
+	{
+		result &= !(lhs[d] < rhs[d]);
+	}
+
+	return result;
+}
+
+inline bool operator==(const Point &lhs, const Point &rhs)
+{
+	bool result = true;
+	for (unsigned d = 0; d < dimensions; ++d)
+	{
+		result &= lhs[d] == rhs[d];
+	}
+
+	return result;
+}
+
+inline bool operator!=(const Point &lhs, const Point &rhs)
+{
+	return !(lhs == rhs);
+}
 
 class Rectangle
 {
@@ -113,6 +181,7 @@ class Rectangle
 		bool strictContainsPoint(const Point &givenPoint) const;
 		bool containsRectangle(const Rectangle &givenRectangle) const;
 		Point centrePoint() const;
+		double minDistance(const Point &givenPoint) const;
 		Rectangle copyExpand(const Point &givenPoint) const;
 		Rectangle intersection(const Rectangle &clippingRectangle) const;
 		std::vector<Rectangle> fragmentRectangle(const Rectangle &clippingRectangle) const;
@@ -125,6 +194,36 @@ class Rectangle
 bool operator==(const Rectangle &lhs, const Rectangle &rhs);
 bool operator!=(const Rectangle &lhs, const Rectangle &rhs);
 
+// The same goes for the containment and intersection tests every search makes per entry
+inline bool Rectangle::intersectsRectangle(const Rectangle &givenRectangle) const
+{
+	// Compute the range intersections
+	bool interval = true;
+	for (unsigned d = 0; d < dimensions; ++d)
+	{
+		interval &=
+			((lowerLeft[d] <= givenRectangle.lowerLeft[d]) & (givenRectangle.lowerLeft[d] <= upperRight[d])) |
+			((givenRectangle.lowerLeft[d] <= lowerLeft[d]) & (lowerLeft[d] <= givenRectangle.upperRight[d]));
+	}
+
+	return interval;
+}
+
+inline bool Rectangle::containsPoint(const Point &givenPoint) const
+{
+	return (lowerLeft <= givenPoint) & (givenPoint <= upperRight);
+}
+
+inline bool Rectangle::strictContainsPoint(const Point &givenPoint) const
+{
+	return (lowerLeft < givenPoint) & (givenPoint < upperRight);
+}
+
+inline bool Rectangle::containsRectangle(const Rectangle &givenRectangle) const
+{
+	return containsPoint(givenRectangle.lowerLeft) & containsPoint(givenRectangle.upperRight);
+}
+
 class IsotheticPolygon
 {
 	public:
@@ -134,8 +233,11 @@ class IsotheticPolygon
 			double area;
 		};
 
+		// Most polygons are a single rectangle or two so those are kept inline in the polygon
+		typedef SmallVector<Rectangle, 2> RectangleSet;
+
 		Rectangle boundingBox;
-		std::vector<Rectangle> basicRectangles;
+		RectangleSet basicRectangles;
 
 		IsotheticPolygon();
 		explicit IsotheticPolygon(const Rectangle &baseRectangle);
@@ -151,6 +253,7 @@ class IsotheticPolygon
 		bool intersectsPolygon(const IsotheticPolygon &givenPolygon) const;
 		bool borderOnlyIntersectsRectangle(const Rectangle &givenRectangle) const;
 		bool containsPoint(const Point &givenPoint) const ;
+		double minDistance(const Point &givenPoint) const;
 		bool disjoint(const IsotheticPolygon &givenPolygon) const;
 		std::vector<Rectangle> intersection(const Rectangle &givenRectangle) const;
 		void intersection(const IsotheticPolygon &constraintPolygon);
@@ -0,0 +1,23 @@
+#ifndef __HILBERT__
+#define __HILBERT__
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <util/geometry.h>
+
+// Hilbert curve keys in any number of dimensions. Each coordinate is quantized to
+// 64 / dimensions bits (at most 32) over a bounding box and the Hilbert index is computed with Skilling's
+// transpose method, so keys always fit in 64 bits.
+namespace hilbert
+{
+	static constexpr unsigned bitsPerDimension = dimensions >= 64 ? 1 : std::min(32u, 64 / dimensions);
+
+	uint64_t key(const Point &point, const Rectangle &bounds);
+
+	// Sorts the points along the Hilbert curve through their bounding box
+	void sort(std::vector<Point> &points);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef __LEAFHINT__
+#define __LEAFHINT__
+
+#include <algorithm>
+
+// Decides when a batched insert should pay for a root to leaf lookup to refresh its leaf hint.
+// A hint that goes unused backs off exponentially so a stream of points that keeps missing does
+// not pay for an extra lookup on every insert.
+class LeafHintPolicy
+{
+	public:
+		static constexpr unsigned maxBackoff = 64;
+
+		inline void hit()
+		{
+			++hits;
+			backoff = 0;
+		}
+
+		// Called after each insert that could not use the hint
+		inline bool shouldRefresh()
+		{
+			if (skip > 0)
+			{
+				--skip;
+				return false;
+			}
+
+			// The last refresh went unused so wait longer before the next one
+			if (refreshed && hits == 0)
+			{
+				backoff = std::min(2 * backoff + 1, maxBackoff);
+				skip = backoff;
+				refreshed = false;
+				return false;
+			}
+
+			refreshed = true;
+			hits = 0;
+			return true;
+		}
+
+	private:
+		unsigned hits = 0;
+		unsigned backoff = 0;
+		unsigned skip = 0;
+		bool refreshed = false;
+};
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef __LEAFPOINTS__
+#define __LEAFPOINTS__
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <util/geometry.h>
+#include <util/simd.h>
+
+// The points held by a leaf. They stay in a vector of points so the rest of the tree can keep
+// reading them as one, and building with SOALEAVES additionally keeps a contiguous column per
+// dimension which range scans test several points at a time through the SIMD kernels.
+class LeafPoints
+{
+	public:
+		typedef std::vector<Point>::const_iterator const_iterator;
+
+		inline size_t size() const { return points.size(); }
+		inline bool empty() const { return points.empty(); }
+		inline const Point &operator[](size_t index) const { return points[index]; }
+		inline const Point &back() const { return points.back(); }
+		inline const_iterator begin() const { return points.begin(); }
+		inline const_iterator end() const { return points.end(); }
+		inline operator const std::vector<Point> &() const { return points; }
+
+		void push_back(const Point &point)
+		{
+			points.push_back(point);
+#ifdef SOALEAVES
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				columns[d].push_back(point[d]);
+			}
+#endif
+		}
+
+		void pop_back()
+		{
+			points.pop_back();
+#ifdef SOALEAVES
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				columns[d].pop_back();
+			}
+#endif
+		}
+
+		// Moves the last point into the hole so the order of the others is not kept
+		void removeAt(size_t index)
+		{
+			points[index] = points.back();
+			points.pop_back();
+#ifdef SOALEAVES
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				columns[d][index] = columns[d].back();
+				columns[d].pop_back();
+			}
+#endif
+		}
+
+		void clear()
+		{
+			points.clear();
+#ifdef SOALEAVES
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				columns[d].clear();
+			}
+#endif
+		}
+
+		template <typename Iterator>
+		void assign(Iterator first, Iterator last)
+		{
+			clear();
+			for (; first != last; ++first)
+			{
+				push_back(*first);
+			}
+		}
+
+		// Hands every point inside the rectangle to the visitor in storage order
+		template <typename Visitor>
+		void forEachContained(const Rectangle &requestedRectangle, Visitor &&visit) const
+		{
+#ifdef SOALEAVES
+			const double *blockColumns[dimensions];
+			for (size_t blockBegin = 0; blockBegin < points.size(); blockBegin += 64)
+			{
+				unsigned blockSize = (unsigned) std::min((size_t) 64, points.size() - blockBegin);
+				for (unsigned d = 0; d < dimensions; ++d)
+				{
+					blockColumns[d] = columns[d].data() + blockBegin;
+				}
+
+				uint64_t mask = simd::containsMask(blockColumns, blockSize, requestedRectangle.lowerLeft.values, requestedRectangle.upperRight.values);
+				for (; mask != 0; mask &= mask - 1)
+				{
+					visit(points[blockBegin + __builtin_ctzll(mask)]);
+				}
+			}
+#else
+			for (const Point &point : points)
+			{
+				if (requestedRectangle.containsPoint(point))
+				{
+					visit(point);
+				}
+			}
+#endif
+		}
+
+	private:
+		std::vector<Point> points;
+#ifdef SOALEAVES
+		std::vector<double> columns[dimensions];
+#endif
+};
+
+#endif
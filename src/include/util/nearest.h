@@ -0,0 +1,60 @@
+#ifndef __NEAREST__
+#define __NEAREST__
+
+#include <queue>
+#include <vector>
+#include <util/geometry.h>
+
+// Priority queue for best-first k nearest neighbour search. Nodes are keyed on the minimum
+// distance from the query point to their region and points on their own distance, so the next
+// point to come off the queue is always the closest one not yet reported.
+template <typename T>
+class NearestQueue
+{
+	public:
+		class Entry
+		{
+			public:
+				double distance;
+				bool isPoint;
+				T node;
+				Point point;
+		};
+
+		inline bool empty() const
+		{
+			return queue.empty();
+		}
+
+		inline void pushNode(double distance, const T &node)
+		{
+			queue.push({distance, false, node, Point::atOrigin});
+		}
+
+		inline void pushPoint(double distance, const Point &point)
+		{
+			queue.push({distance, true, T(), point});
+		}
+
+		inline Entry pop()
+		{
+			Entry entry = queue.top();
+			queue.pop();
+
+			return entry;
+		}
+
+	private:
+		class Further
+		{
+			public:
+				inline bool operator()(const Entry &a, const Entry &b) const
+				{
+					return a.distance > b.distance;
+				}
+		};
+
+		std::priority_queue<Entry, std::vector<Entry>, Further> queue;
+};
+
+#endif
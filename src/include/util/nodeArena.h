@@ -0,0 +1,228 @@
+#ifndef __NODEARENA__
+#define __NODEARENA__
+
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <new>
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <sys/mman.h>
+#include <util/allocationProfile.h>
+
+// Names a node by its slab and slot within that slab rather than by address, half the size of a
+// pointer for trees which keep one per child
+typedef uint32_t NodeHandle;
+
+// Slab allocator for the nodes of a single tree. Nodes are carved out of large slabs so that
+// nodes created together sit together, destroyed nodes are reused before the arena grows, and
+// the whole tree is torn down by one sequential sweep over the slabs rather than a recursive
+// walk freeing one node at a time. Building with HUGEPAGES makes every slab a 2MB aligned block
+// advised onto transparent huge pages.
+//
+// Every node also has a NodeHandle. The low bits of a handle pick the slot, as many as the
+// largest slab needs, and the high bits pick the slab, which leaves room for billions of nodes.
+template <typename T>
+class NodeArena
+{
+	public:
+		static constexpr size_t hugePageSize = 2 * 1024 * 1024;
+		static constexpr size_t minSlabNodes = 32;
+
+		NodeArena() = default;
+		NodeArena(const NodeArena &) = delete;
+		NodeArena &operator=(const NodeArena &) = delete;
+
+		~NodeArena()
+		{
+			clear();
+		}
+
+		template <typename... Args>
+		T *create(Args &&...args)
+		{
+			void *slot;
+			if (freeSlots != nullptr)
+			{
+				slot = freeSlots;
+				freeSlots = freeSlots->next;
+				--freeCount;
+			}
+			else
+			{
+				if (slabs.empty() || slabs.back().used == slabs.back().capacity)
+				{
+					grow();
+				}
+
+				Slab &slab = slabs.back();
+				slot = slab.memory + slab.used * slotSize;
+				++slab.used;
+			}
+
+			return new (slot) T(std::forward<Args>(args)...);
+		}
+
+		void destroy(T *node)
+		{
+			node->~T();
+
+			FreeSlot *slot = reinterpret_cast<FreeSlot *>(node);
+			slot->next = freeSlots;
+			freeSlots = slot;
+			++freeCount;
+		}
+
+		// The node named by handle, found by indexing into its slab without any search
+		inline T *operator[](NodeHandle handle) const
+		{
+			const Slab &slab = slabs[handle >> slotBits];
+			return reinterpret_cast<T *>(slab.memory + (handle & slotMask) * slotSize);
+		}
+
+		// The handle of a node living in this arena, found by searching the slabs by address
+		NodeHandle handle(const T *node) const
+		{
+			const char *address = reinterpret_cast<const char *>(node);
+			auto slab = std::upper_bound(slabsByAddress.begin(), slabsByAddress.end(), address, [](const char *address, const std::pair<char *, NodeHandle> &slab) { return address < slab.first; });
+			assert(slab != slabsByAddress.begin());
+			--slab;
+			assert(address < slab->first + slabs[slab->second].capacity * slotSize);
+
+			return (slab->second << slotBits) | (NodeHandle) ((address - slab->first) / slotSize);
+		}
+
+		// Destroys every node still alive and hands the slabs back
+		void clear()
+		{
+			if constexpr (!std::is_trivially_destructible<T>::value)
+			{
+				// Free slots hold no node so gather them up to skip during the sweep
+				std::vector<char *> freed;
+				freed.reserve(freeCount);
+				for (FreeSlot *slot = freeSlots; slot != nullptr; slot = slot->next)
+				{
+					freed.push_back(reinterpret_cast<char *>(slot));
+				}
+				std::sort(freed.begin(), freed.end());
+
+				for (Slab &slab : slabs)
+				{
+					for (size_t i = 0; i < slab.used; ++i)
+					{
+						char *slot = slab.memory + i * slotSize;
+						if (!std::binary_search(freed.begin(), freed.end(), slot))
+						{
+							reinterpret_cast<T *>(slot)->~T();
+						}
+					}
+				}
+			}
+
+			for (Slab &slab : slabs)
+			{
+				release(slab);
+			}
+
+			slabs.clear();
+			slabsByAddress.clear();
+			freeSlots = nullptr;
+			freeCount = 0;
+		}
+
+		// Bytes held in slabs whether or not a node currently lives in them
+		size_t bytes() const
+		{
+			size_t total = 0;
+			for (const Slab &slab : slabs)
+			{
+				total += slab.capacity * slotSize;
+			}
+
+			return total;
+		}
+
+		size_t liveNodes() const
+		{
+			size_t used = 0;
+			for (const Slab &slab : slabs)
+			{
+				used += slab.used;
+			}
+
+			return used - freeCount;
+		}
+
+	private:
+		struct FreeSlot
+		{
+			FreeSlot *next;
+		};
+
+		struct Slab
+		{
+			char *memory;
+			size_t capacity;
+			size_t used;
+		};
+
+		static constexpr size_t slotSize = sizeof(T) > sizeof(FreeSlot) ? sizeof(T) : sizeof(FreeSlot);
+		static_assert(alignof(T) <= alignof(std::max_align_t), "NodeArena slabs are only max_align_t aligned");
+
+		static constexpr size_t maxSlabNodes = hugePageSize / slotSize > 0 ? hugePageSize / slotSize : 1;
+
+		static constexpr unsigned bitsFor(size_t count)
+		{
+			return count <= 1 ? 0 : 1 + bitsFor((count + 1) / 2);
+		}
+
+		static constexpr unsigned slotBits = bitsFor(maxSlabNodes);
+		static constexpr NodeHandle slotMask = (NodeHandle(1) << slotBits) - 1;
+
+		// Slabs double from small so that small trees stay small, up to a huge page worth of nodes
+		void grow()
+		{
+			size_t maxCapacity = maxSlabNodes;
+			assert(slabs.size() < (size_t(1) << (32 - slotBits)));
+#ifdef HUGEPAGES
+			size_t capacity = maxCapacity;
+			size_t bytes = (capacity * slotSize + hugePageSize - 1) / hugePageSize * hugePageSize;
+			allocationprofile::countAllocation(bytes);
+			char *memory = static_cast<char *>(std::aligned_alloc(hugePageSize, bytes));
+			if (memory == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+#ifdef MADV_HUGEPAGE
+			madvise(memory, bytes, MADV_HUGEPAGE);
+#endif
+#else
+			size_t capacity = slabs.empty() ? minSlabNodes : std::min(2 * slabs.back().capacity, maxCapacity);
+			char *memory = static_cast<char *>(::operator new(capacity * slotSize));
+#endif
+
+			std::pair<char *, NodeHandle> byAddress(memory, (NodeHandle) slabs.size());
+			slabsByAddress.insert(std::upper_bound(slabsByAddress.begin(), slabsByAddress.end(), byAddress), byAddress);
+			slabs.push_back({memory, capacity, 0});
+		}
+
+		static void release(Slab &slab)
+		{
+#ifdef HUGEPAGES
+			std::free(slab.memory);
+#else
+			::operator delete(slab.memory);
+#endif
+		}
+
+		std::vector<Slab> slabs;
+		// Slab start addresses in increasing order alongside their index in slabs
+		std::vector<std::pair<char *, NodeHandle>> slabsByAddress;
+		FreeSlot *freeSlots = nullptr;
+		size_t freeCount = 0;
+};
+
+#endif
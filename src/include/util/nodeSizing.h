@@ -0,0 +1,80 @@
+#ifndef __NODESIZING__
+#define __NODESIZING__
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <util/allocationProfile.h>
+
+namespace nodesizing
+{
+	constexpr size_t cacheLineBytes = 64;
+	constexpr size_t pageBytes = 4096;
+
+	// Fanouts derived from a target node size in bytes, a multiple of the cache line such as a
+	// page, rather than given directly. Every entry of a node, leaf or internal, has to fit along
+	// with the one extra entry a node holds while it overflows. The smallest fanout is half of the
+	// largest as with the defaults.
+	template <typename Tree>
+	unsigned maxFanout(size_t nodeBytes)
+	{
+		size_t entryBytes = std::max(Tree::leafEntryBytes, Tree::branchEntryBytes);
+		return (unsigned) std::max(nodeBytes / entryBytes, (size_t) 5) - 1;
+	}
+
+	template <typename Tree>
+	unsigned minFanout(size_t nodeBytes)
+	{
+		return maxFanout<Tree>(nodeBytes) / 2;
+	}
+}
+
+// Allocator for the entries of a node. Blocks start on a cache line, or on a page once they
+// span one, so that entries sized by nodesizing occupy exactly the lines or pages they were
+// sized for. Blocks smaller than a line come from malloc as usual.
+template <typename T>
+class AlignedAllocator
+{
+	public:
+		typedef T value_type;
+
+		AlignedAllocator() = default;
+		template <typename U>
+		AlignedAllocator(const AlignedAllocator<U> &) {}
+
+		T *allocate(size_t count)
+		{
+			size_t bytes = count * sizeof(T);
+			size_t alignment = bytes >= nodesizing::pageBytes ? nodesizing::pageBytes : nodesizing::cacheLineBytes;
+			void *memory;
+			allocationprofile::countAllocation(bytes);
+			if (bytes < nodesizing::cacheLineBytes)
+			{
+				memory = std::malloc(bytes);
+			}
+			else
+			{
+				memory = std::aligned_alloc(alignment, (bytes + alignment - 1) / alignment * alignment);
+			}
+
+			if (memory == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+
+			return static_cast<T *>(memory);
+		}
+
+		void deallocate(T *memory, size_t)
+		{
+			std::free(memory);
+		}
+
+		template <typename U>
+		bool operator==(const AlignedAllocator<U> &) const { return true; }
+		template <typename U>
+		bool operator!=(const AlignedAllocator<U> &) const { return false; }
+};
+
+#endif
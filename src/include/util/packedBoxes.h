@@ -0,0 +1,383 @@
+#ifndef __PACKEDBOXES__
+#define __PACKEDBOXES__
+
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <cassert>
+#include <limits>
+#include <algorithm>
+#include <iterator>
+#include <util/geometry.h>
+#include <util/simd.h>
+#include <util/nodeSizing.h>
+
+// The entries of an internal node, either bare rectangles or branches carrying a boundingBox,
+// alongside their boxes packed into one lower and one upper corner column per dimension. The
+// columns share one buffer, stride codes apart, so the node pays for a single extra vector.
+// Entries read as usual but every change goes through here so the columns never fall out of
+// step, which lets search test all children of a node at once through the SIMD kernels.
+//
+// Building with QUANTIZEDBOXES=8 or 16 packs each corner as an 8 or 16 bit code relative to a
+// frame around all of the boxes instead of as a double. Codes are rounded outward so the packed
+// boxes only ever grow and searches may follow a few extra children but never miss one, the
+// entries themselves keep their exact boxes for updates and for the checks made at leaves.
+template <typename Entry>
+class PackedBoxes
+{
+	public:
+		typedef typename std::vector<Entry>::const_iterator const_iterator;
+#if QUANTIZEDBOXES == 16
+		typedef uint16_t Code;
+#elif defined(QUANTIZEDBOXES)
+		typedef uint8_t Code;
+#else
+		typedef double Code;
+#endif
+		typedef std::vector<Code, AlignedAllocator<Code>> Columns;
+
+		// Bytes the packed corners add to every entry
+		static constexpr size_t packedEntryBytes = 2 * dimensions * sizeof(Code);
+
+		inline size_t size() const { return entries.size(); }
+		inline bool empty() const { return entries.empty(); }
+		inline const Entry &operator[](size_t index) const { return entries[index]; }
+		inline const Entry &back() const { return entries.back(); }
+		inline const_iterator begin() const { return entries.begin(); }
+		inline const_iterator end() const { return entries.end(); }
+		inline operator const std::vector<Entry> &() const { return entries; }
+
+		void push_back(const Entry &entry)
+		{
+			if (entries.size() == stride)
+			{
+				restride(std::max((size_t) 4, 2 * stride));
+			}
+			entries.push_back(entry);
+			pack(entries.size() - 1);
+		}
+
+		void pop_back()
+		{
+			entries.pop_back();
+		}
+
+		void clear()
+		{
+			entries.clear();
+		}
+
+		void set(size_t index, const Entry &entry)
+		{
+			entries[index] = entry;
+			pack(index);
+		}
+
+		void setBoundingBox(size_t index, const Rectangle &boundingBox)
+		{
+			boxOf(entries[index]) = boundingBox;
+			pack(index);
+		}
+
+		// Moves the last entry into the hole so the order of the others is not kept
+		void removeAt(size_t index)
+		{
+			entries[index] = entries.back();
+			for (unsigned c = 0; c < 2 * dimensions; ++c)
+			{
+				column(c)[index] = column(c)[entries.size() - 1];
+			}
+			pop_back();
+		}
+
+		// Removes the entry keeping the order of the others
+		void erase(size_t index)
+		{
+			erase(index, index + 1);
+		}
+
+		// Removes the entries in [first, last) keeping the order of the others
+		void erase(size_t first, size_t last)
+		{
+			for (unsigned c = 0; c < 2 * dimensions; ++c)
+			{
+				std::copy(column(c) + last, column(c) + entries.size(), column(c) + first);
+			}
+			entries.erase(entries.begin() + first, entries.begin() + last);
+		}
+
+		void reserve(size_t capacity)
+		{
+			entries.reserve(capacity);
+			if (capacity > stride)
+			{
+				restride(capacity);
+			}
+		}
+
+		template <typename Iterator>
+		void assign(Iterator first, Iterator last)
+		{
+			entries.clear();
+			size_t count = std::distance(first, last);
+			if (count > stride)
+			{
+				restride(count);
+			}
+			entries.assign(first, last);
+			repack();
+		}
+
+		void assign(const std::vector<Entry> &givenEntries)
+		{
+			assign(givenEntries.begin(), givenEntries.end());
+		}
+
+		template <typename Compare>
+		void sort(Compare compare)
+		{
+			std::sort(entries.begin(), entries.end(), compare);
+			repack();
+		}
+
+		// Bytes taken by the packed corners on top of the entries themselves
+		size_t packedBytes() const
+		{
+			return columns.capacity() * sizeof(Code);
+		}
+
+		// Calls visit with the index of every entry whose box intersects the rectangle, in order
+		template <typename Visitor>
+		void forEachIntersecting(const Rectangle &requestedRectangle, Visitor &&visit) const
+		{
+			forEachMatching(requestedRectangle.lowerLeft.values, requestedRectangle.upperRight.values, visit);
+		}
+
+		// Calls visit with the index of every entry whose box contains the point, in order
+		template <typename Visitor>
+		void forEachContaining(const Point &requestedPoint, Visitor &&visit) const
+		{
+			forEachMatching(requestedPoint.values, requestedPoint.values, visit);
+		}
+
+	private:
+		static inline const Rectangle &boxOf(const Rectangle &boundingBox) { return boundingBox; }
+		static inline Rectangle &boxOf(Rectangle &boundingBox) { return boundingBox; }
+		template <typename Branch>
+		static inline const Rectangle &boxOf(const Branch &branch) { return branch.boundingBox; }
+		template <typename Branch>
+		static inline Rectangle &boxOf(Branch &branch) { return branch.boundingBox; }
+
+		// Column 2d holds the lower and column 2d + 1 the upper corners along dimension d
+		inline Code *column(unsigned c) { return columns.data() + c * stride; }
+		inline const Code *column(unsigned c) const { return columns.data() + c * stride; }
+
+		// Spreads the columns out to hold capacity entries each
+		void restride(size_t capacity)
+		{
+			Columns restrided(2 * dimensions * capacity);
+			for (unsigned c = 0; c < 2 * dimensions; ++c)
+			{
+				std::copy(column(c), column(c) + entries.size(), restrided.data() + c * capacity);
+			}
+			columns.swap(restrided);
+			stride = capacity;
+		}
+
+#ifdef QUANTIZEDBOXES
+		static constexpr int maxCode = std::numeric_limits<Code>::max();
+
+		// Code c along dimension d stands for the coordinate origin[d] + c * step[d]
+		inline double decode(unsigned d, int code) const { return origin[d] + code * step[d]; }
+
+		// The largest code standing for a coordinate at most value, -1 when even code 0 is above it
+		int lastCodeAtMost(unsigned d, double value) const
+		{
+			int code = value >= origin[d] ? maxCode : -1;
+			if (step[d] > 0.0)
+			{
+				code = (int) std::floor(std::min(std::max((value - origin[d]) * inverseStep[d], -1.0), (double) maxCode));
+			}
+
+			// The estimate can be a code off either way after rounding
+			for (; code < maxCode && decode(d, code + 1) <= value; ++code) {}
+			for (; code >= 0 && decode(d, code) > value; --code) {}
+			return code;
+		}
+
+		// The smallest code standing for a coordinate at least value, maxCode + 1 when there is none
+		int firstCodeAtLeast(unsigned d, double value) const
+		{
+			int code = value <= origin[d] ? 0 : maxCode + 1;
+			if (step[d] > 0.0)
+			{
+				code = (int) std::ceil(std::min(std::max((value - origin[d]) * inverseStep[d], 0.0), (double) maxCode + 1));
+			}
+
+			for (; code > 0 && decode(d, code - 1) >= value; --code) {}
+			for (; code <= maxCode && decode(d, code) < value; ++code) {}
+			return code;
+		}
+
+		// Fits the frame around every box so that codes 0 and maxCode reach its edges
+		void refit()
+		{
+			Rectangle frame = boxOf(entries[0]);
+			for (const Entry &entry : entries)
+			{
+				frame.expand(boxOf(entry));
+			}
+
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				assert(std::isfinite(frame.lowerLeft[d]) && std::isfinite(frame.upperRight[d]));
+				origin[d] = frame.lowerLeft[d];
+				step[d] = (frame.upperRight[d] - frame.lowerLeft[d]) / maxCode;
+				for (; decode(d, maxCode) < frame.upperRight[d]; step[d] = std::nextafter(step[d], std::numeric_limits<double>::infinity())) {}
+				inverseStep[d] = step[d] > 0.0 ? 1.0 / step[d] : 0.0;
+			}
+		}
+
+		bool insideFrame(const Rectangle &boundingBox) const
+		{
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				if (boundingBox.lowerLeft[d] < origin[d] || decode(d, maxCode) < boundingBox.upperRight[d])
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		void pack(size_t index)
+		{
+			// A box leaving the frame moves the frame and so every other code with it
+			if (entries.size() == 1 || !insideFrame(boxOf(entries[index])))
+			{
+				repack();
+				return;
+			}
+
+			const Rectangle &boundingBox = boxOf(entries[index]);
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				column(2 * d)[index] = (Code) lastCodeAtMost(d, boundingBox.lowerLeft[d]);
+				column(2 * d + 1)[index] = (Code) firstCodeAtLeast(d, boundingBox.upperRight[d]);
+			}
+		}
+
+		void repack()
+		{
+			if (entries.empty())
+			{
+				return;
+			}
+
+			refit();
+			for (size_t i = 0; i < entries.size(); ++i)
+			{
+				const Rectangle &boundingBox = boxOf(entries[i]);
+				for (unsigned d = 0; d < dimensions; ++d)
+				{
+					column(2 * d)[i] = (Code) lastCodeAtMost(d, boundingBox.lowerLeft[d]);
+					column(2 * d + 1)[i] = (Code) firstCodeAtLeast(d, boundingBox.upperRight[d]);
+				}
+			}
+		}
+
+		template <typename Visitor>
+		void forEachMatching(const double *lowerLeft, const double *upperRight, Visitor &visit) const
+		{
+			if (entries.empty())
+			{
+				return;
+			}
+
+			// Turn the query into codes, a box then matches when its lower code is at most the
+			// query's upper code and its upper code at least the query's lower code
+			Code queryLower[dimensions];
+			Code queryUpper[dimensions];
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				int lowerCode = firstCodeAtLeast(d, lowerLeft[d]);
+				int upperCode = lastCodeAtMost(d, upperRight[d]);
+				if (lowerCode > maxCode || upperCode < 0)
+				{
+					return;
+				}
+				queryLower[d] = (Code) lowerCode;
+				queryUpper[d] = (Code) upperCode;
+			}
+
+			const Code *blockLower[dimensions];
+			const Code *blockUpper[dimensions];
+			for (size_t blockBegin = 0; blockBegin < entries.size(); blockBegin += 64)
+			{
+				unsigned blockSize = (unsigned) std::min((size_t) 64, entries.size() - blockBegin);
+				for (unsigned d = 0; d < dimensions; ++d)
+				{
+					blockLower[d] = column(2 * d) + blockBegin;
+					blockUpper[d] = column(2 * d + 1) + blockBegin;
+				}
+
+				uint64_t mask = simd::intersectsMask(blockLower, blockUpper, blockSize, queryLower, queryUpper);
+				for (; mask != 0; mask &= mask - 1)
+				{
+					visit(blockBegin + __builtin_ctzll(mask));
+				}
+			}
+		}
+
+		double origin[dimensions];
+		double step[dimensions];
+		double inverseStep[dimensions];
+#else
+		void pack(size_t index)
+		{
+			const Rectangle &boundingBox = boxOf(entries[index]);
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				column(2 * d)[index] = boundingBox.lowerLeft[d];
+				column(2 * d + 1)[index] = boundingBox.upperRight[d];
+			}
+		}
+
+		void repack()
+		{
+			for (size_t i = 0; i < entries.size(); ++i)
+			{
+				pack(i);
+			}
+		}
+
+		template <typename Visitor>
+		void forEachMatching(const double *lowerLeft, const double *upperRight, Visitor &visit) const
+		{
+			const double *blockLower[dimensions];
+			const double *blockUpper[dimensions];
+			for (size_t blockBegin = 0; blockBegin < entries.size(); blockBegin += 64)
+			{
+				unsigned blockSize = (unsigned) std::min((size_t) 64, entries.size() - blockBegin);
+				for (unsigned d = 0; d < dimensions; ++d)
+				{
+					blockLower[d] = column(2 * d) + blockBegin;
+					blockUpper[d] = column(2 * d + 1) + blockBegin;
+				}
+
+				uint64_t mask = simd::intersectsMask(blockLower, blockUpper, blockSize, lowerLeft, upperRight);
+				for (; mask != 0; mask &= mask - 1)
+				{
+					visit(blockBegin + __builtin_ctzll(mask));
+				}
+			}
+		}
+#endif
+
+		std::vector<Entry> entries;
+		Columns columns;
+		size_t stride = 0;
+};
+
+#endif
@@ -0,0 +1,217 @@
+#ifndef __POINTFILE__
+#define __POINTFILE__
+
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <util/geometry.h>
+
+// Binary point files, read by mapping them instead of parsing text. A file is a 24 byte header,
+// the magic string then the point count as 64 bits and the dimension as 32 bits followed by 32
+// unused bits, and then every point as its coordinates one after another. Everything is little
+// endian whatever machine wrote it.
+namespace pointfile
+{
+	constexpr char magic[8] = {'N', 'I', 'R', 'P', 'O', 'I', 'N', 'T'};
+	constexpr size_t headerBytes = 24;
+
+	inline uint64_t littleEndian(uint64_t bits)
+	{
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		return __builtin_bswap64(bits);
+#else
+		return bits;
+#endif
+	}
+
+	inline uint64_t decode64(const char *bytes)
+	{
+		uint64_t bits;
+		std::memcpy(&bits, bytes, sizeof(bits));
+		return littleEndian(bits);
+	}
+
+	inline void encode64(uint64_t value, char *bytes)
+	{
+		uint64_t bits = littleEndian(value);
+		std::memcpy(bytes, &bits, sizeof(bits));
+	}
+
+	inline double decodeDouble(const char *bytes)
+	{
+		uint64_t bits = decode64(bytes);
+		double value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	inline void encodeDouble(double value, char *bytes)
+	{
+		uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		encode64(bits, bytes);
+	}
+
+	// Maps a point file read only and hands its points out in place
+	class Reader
+	{
+		public:
+			Reader() = default;
+			Reader(const Reader &) = delete;
+			Reader &operator=(const Reader &) = delete;
+
+			~Reader()
+			{
+				if (mapping != nullptr)
+				{
+					munmap(const_cast<char *>(mapping), mappedBytes);
+				}
+			}
+
+			// False unless the whole file maps and holds as many points as its header says
+			bool open(const std::string &path)
+			{
+				int file = ::open(path.c_str(), O_RDONLY);
+				if (file < 0)
+				{
+					return false;
+				}
+
+				struct stat fileStatus;
+				if (fstat(file, &fileStatus) == 0 && (size_t) fileStatus.st_size >= headerBytes)
+				{
+					void *memory = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+					if (memory != MAP_FAILED)
+					{
+						mapping = static_cast<const char *>(memory);
+						mappedBytes = fileStatus.st_size;
+					}
+				}
+				::close(file);
+
+				if (mapping == nullptr)
+				{
+					return false;
+				}
+
+				// Points are read once front to back so let the kernel read ahead aggressively
+				madvise(const_cast<char *>(mapping), mappedBytes, MADV_SEQUENTIAL);
+
+				count = decode64(mapping + 8);
+				pointDimensions = (uint32_t) decode64(mapping + 16);
+				if (std::memcmp(mapping, magic, sizeof(magic)) != 0 || pointDimensions == 0 || count > (mappedBytes - headerBytes) / (pointDimensions * sizeof(double)))
+				{
+					munmap(const_cast<char *>(mapping), mappedBytes);
+					mapping = nullptr;
+					return false;
+				}
+
+				return true;
+			}
+
+			inline size_t size() const { return count; }
+			inline unsigned dimensions() const { return pointDimensions; }
+
+			// Dimensions beyond the compiled ones are dropped
+			inline Point point(size_t index) const
+			{
+				Point p;
+				const char *coordinates = mapping + headerBytes + index * pointDimensions * sizeof(double);
+				for (unsigned d = 0; d < pointDimensions && d < ::dimensions; ++d)
+				{
+					p[d] = decodeDouble(coordinates + d * sizeof(double));
+				}
+
+				return p;
+			}
+
+		private:
+			const char *mapping = nullptr;
+			size_t mappedBytes = 0;
+			size_t count = 0;
+			unsigned pointDimensions = 0;
+	};
+
+	// Streams points out to a point file through one large buffer. The count in the header is
+	// filled in once every point has been written.
+	class Writer
+	{
+		public:
+			static constexpr size_t bufferBytes = 1 << 20;
+
+			Writer(const std::string &path, unsigned pointDimensions) :
+				file(std::fopen(path.c_str(), "wb")), ok(file != nullptr), count(0), pointDimensions(pointDimensions)
+			{
+				buffer.reserve(bufferBytes);
+				buffer.resize(headerBytes, 0);
+				std::memcpy(buffer.data(), magic, sizeof(magic));
+				encode64(pointDimensions, buffer.data() + 16);
+			}
+
+			Writer(const Writer &) = delete;
+			Writer &operator=(const Writer &) = delete;
+
+			~Writer()
+			{
+				close();
+			}
+
+			void write(const double *coordinates)
+			{
+				size_t end = buffer.size();
+				buffer.resize(end + pointDimensions * sizeof(double));
+				for (unsigned d = 0; d < pointDimensions; ++d)
+				{
+					encodeDouble(coordinates[d], buffer.data() + end + d * sizeof(double));
+				}
+				++count;
+
+				if (buffer.size() >= bufferBytes)
+				{
+					flush();
+				}
+			}
+
+			// Flushes, fills in the count and closes the file, false if any write failed
+			bool close()
+			{
+				if (file != nullptr)
+				{
+					flush();
+					char countBytes[8];
+					encode64(count, countBytes);
+					ok = ok && std::fseek(file, 8, SEEK_SET) == 0 && std::fwrite(countBytes, 1, sizeof(countBytes), file) == sizeof(countBytes);
+					ok = std::fclose(file) == 0 && ok;
+					file = nullptr;
+				}
+
+				return ok;
+			}
+
+			inline size_t size() const { return count; }
+
+		private:
+			void flush()
+			{
+				if (ok && !buffer.empty())
+				{
+					ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+				}
+				buffer.clear();
+			}
+
+			std::FILE *file;
+			bool ok;
+			size_t count;
+			unsigned pointDimensions;
+			std::vector<char> buffer;
+	};
+}
+
+#endif
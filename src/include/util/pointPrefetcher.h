@@ -0,0 +1,172 @@
+#ifndef __POINTPREFETCHER__
+#define __POINTPREFETCHER__
+
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+#include <util/geometry.h>
+
+// Reads points ahead of whoever consumes them. A background thread fills a ring of buffers a
+// chunk at a time while the consumer takes points out of the oldest full one, so reading and
+// parsing overlap with the work done on each point and the consumer only waits when it catches
+// up with the reader. Chunks are produced by a fill function which writes up to a chunk of
+// points and returns how many it wrote, zero once there are no more.
+class PointPrefetcher
+{
+	public:
+		typedef std::function<size_t(Point *, size_t)> Fill;
+
+		PointPrefetcher() = default;
+		PointPrefetcher(const PointPrefetcher &) = delete;
+		PointPrefetcher &operator=(const PointPrefetcher &) = delete;
+
+		~PointPrefetcher()
+		{
+			stop();
+		}
+
+		// Starts reading from the beginning, stopping any reader already running
+		void start(size_t chunkPoints, unsigned bufferCount, Fill fill)
+		{
+			stop();
+
+			buffers.resize(std::max(bufferCount, 1u));
+			counts.assign(buffers.size(), 0);
+			for (std::vector<Point> &buffer : buffers)
+			{
+				buffer.resize(std::max(chunkPoints, (size_t) 1));
+			}
+			filled = 0;
+			released = 0;
+			finished = false;
+			holding = false;
+			cursor = 0;
+			currentCount = 0;
+
+			reader = std::thread(&PointPrefetcher::run, this, std::move(fill));
+		}
+
+		// Waits for the reader to give up its current chunk and finish, nothing more is handed
+		// out until the next start
+		void stop()
+		{
+			if (reader.joinable())
+			{
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					stopping = true;
+				}
+				changed.notify_all();
+				reader.join();
+				stopping = false;
+			}
+
+			filled = released;
+			finished = true;
+			holding = false;
+			cursor = 0;
+			currentCount = 0;
+		}
+
+		// False once every point has been handed out
+		inline bool next(Point &p)
+		{
+			if (cursor == currentCount && !advance())
+			{
+				return false;
+			}
+
+			p = current[cursor++];
+			return true;
+		}
+
+	private:
+		// Gives the chunk being read back to the reader and waits for the next one
+		bool advance()
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			if (holding)
+			{
+				++released;
+				holding = false;
+				changed.notify_all();
+			}
+
+			changed.wait(guard, [this]{ return filled > released || finished; });
+			if (filled == released)
+			{
+				return false;
+			}
+
+			size_t slot = released % buffers.size();
+			current = buffers[slot].data();
+			currentCount = counts[slot];
+			cursor = 0;
+			holding = true;
+			return true;
+		}
+
+		void run(Fill fill)
+		{
+			for (size_t chunk = 0;; ++chunk)
+			{
+				// PP1 [Wait for a buffer the consumer has finished with]
+				size_t slot = chunk % buffers.size();
+				{
+					std::unique_lock<std::mutex> guard(lock);
+					changed.wait(guard, [this, chunk]{ return chunk < released + buffers.size() || stopping; });
+					if (stopping)
+					{
+						return;
+					}
+				}
+
+				// PP2 [Fill it without holding the lock]
+				size_t count = fill(buffers[slot].data(), buffers[slot].size());
+
+				// PP3 [Hand it over, or say there is nothing more]
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					if (count == 0)
+					{
+						finished = true;
+					}
+					else
+					{
+						counts[slot] = count;
+						filled = chunk + 1;
+					}
+				}
+				changed.notify_all();
+
+				if (count == 0)
+				{
+					return;
+				}
+			}
+		}
+
+		std::vector<std::vector<Point>> buffers;
+		std::vector<size_t> counts;
+
+		// Shared with the reader under the lock, chunks are numbered from the start of the stream
+		std::mutex lock;
+		std::condition_variable changed;
+		size_t filled = 0;
+		size_t released = 0;
+		bool finished = true;
+		bool stopping = false;
+
+		// Only touched by the consumer
+		const Point *current = nullptr;
+		size_t cursor = 0;
+		size_t currentCount = 0;
+		bool holding = false;
+
+		std::thread reader;
+};
+
+#endif
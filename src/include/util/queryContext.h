@@ -0,0 +1,23 @@
+#ifndef __QUERYCONTEXT__
+#define __QUERYCONTEXT__
+
+#include <vector>
+
+// Per-thread traversal stack shared by every visitor search over trees of node type N. Each
+// search pushes above whatever is already on the stack and pops back down to it, so a visitor
+// may start another search of its own. Once the stack has grown to the deepest traversal seen
+// on this thread, searches stop allocating.
+template <typename N>
+class QueryContext
+{
+	public:
+		std::vector<N *> stack;
+
+		static inline QueryContext &local()
+		{
+			thread_local QueryContext context;
+			return context;
+		}
+};
+
+#endif
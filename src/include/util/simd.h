@@ -0,0 +1,111 @@
+#ifndef __SIMD__
+#define __SIMD__
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <globals/globals.h>
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Kernels over coordinates kept one column per dimension. Each tests up to 64 consecutive
+// entries and returns a mask with bit i set when entry i passes. AVX2 tests four entries per
+// instruction and SSE2 two, whatever is left over falls through to the scalar loop.
+namespace simd
+{
+	// Boxes given as lower and upper corner columns which intersect [lowerLeft, upperRight], that
+	// is lower[d] <= upperRight[d] and lowerLeft[d] <= upper[d] along every dimension d
+	inline uint64_t intersectsMask(const double *const lower[dimensions], const double *const upper[dimensions], unsigned count, const double *lowerLeft, const double *upperRight)
+	{
+		uint64_t mask = 0;
+		unsigned i = 0;
+
+#if defined(__AVX2__)
+		for (; i + 4 <= count; i += 4)
+		{
+			__m256d inside = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				inside = _mm256_and_pd(inside, _mm256_cmp_pd(_mm256_loadu_pd(lower[d] + i), _mm256_set1_pd(upperRight[d]), _CMP_LE_OQ));
+				inside = _mm256_and_pd(inside, _mm256_cmp_pd(_mm256_loadu_pd(upper[d] + i), _mm256_set1_pd(lowerLeft[d]), _CMP_GE_OQ));
+			}
+			mask |= (uint64_t) _mm256_movemask_pd(inside) << i;
+		}
+#elif defined(__SSE2__)
+		for (; i + 2 <= count; i += 2)
+		{
+			__m128d inside = _mm_castsi128_pd(_mm_set1_epi64x(-1));
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				inside = _mm_and_pd(inside, _mm_cmple_pd(_mm_loadu_pd(lower[d] + i), _mm_set1_pd(upperRight[d])));
+				inside = _mm_and_pd(inside, _mm_cmpge_pd(_mm_loadu_pd(upper[d] + i), _mm_set1_pd(lowerLeft[d])));
+			}
+			mask |= (uint64_t) _mm_movemask_pd(inside) << i;
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			bool inside = true;
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				inside = inside && lower[d][i] <= upperRight[d] && lowerLeft[d] <= upper[d][i];
+			}
+			mask |= (uint64_t) inside << i;
+		}
+
+		return mask;
+	}
+
+	// The same test on boxes whose corners are small unsigned integer codes. Each dimension
+	// narrows a byte per entry which the compiler vectorises, and the bytes are then gathered into
+	// the mask with movemask where SSE2 or AVX2 is available.
+	template <typename Code>
+	inline uint64_t intersectsMask(const Code *const lower[dimensions], const Code *const upper[dimensions], unsigned count, const Code *lowerLeft, const Code *upperRight)
+	{
+		static_assert(std::is_unsigned<Code>::value, "Codes are unsigned integers");
+		alignas(32) uint8_t inside[64];
+		std::memset(inside, 0xFF, sizeof(inside));
+
+		for (unsigned d = 0; d < dimensions; ++d)
+		{
+			const Code *lowerColumn = lower[d];
+			const Code *upperColumn = upper[d];
+			Code queryLower = lowerLeft[d];
+			Code queryUpper = upperRight[d];
+			for (unsigned i = 0; i < count; ++i)
+			{
+				inside[i] &= -(uint8_t) ((lowerColumn[i] <= queryUpper) & (queryLower <= upperColumn[i]));
+			}
+		}
+
+		uint64_t mask = 0;
+#if defined(__AVX2__)
+		mask = (uint32_t) _mm256_movemask_epi8(_mm256_load_si256((const __m256i *) inside));
+		mask |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_load_si256((const __m256i *) (inside + 32))) << 32;
+#elif defined(__SSE2__)
+		for (unsigned i = 0; i < 64; i += 16)
+		{
+			mask |= (uint64_t) (uint16_t) _mm_movemask_epi8(_mm_load_si128((const __m128i *) (inside + i))) << i;
+		}
+#else
+		for (unsigned i = 0; i < count; ++i)
+		{
+			mask |= (uint64_t) (inside[i] & 1) << i;
+		}
+#endif
+
+		// Entries past count were never tested
+		return count == 64 ? mask : mask & ((uint64_t(1) << count) - 1);
+	}
+
+	// Points given as coordinate columns which lie within [lowerLeft, upperRight]. A point is a
+	// box with equal corners so this is the intersection test on the same columns twice.
+	inline uint64_t containsMask(const double *const columns[dimensions], unsigned count, const double *lowerLeft, const double *upperRight)
+	{
+		return intersectsMask(columns, columns, count, lowerLeft, upperRight);
+	}
+}
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef __SMALLVECTOR__
+#define __SMALLVECTOR__
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <util/allocationProfile.h>
+
+// A vector which keeps up to N items inside the object itself and only moves them out to the
+// heap once it grows past that, so small ones are copied without allocating and read without a
+// pointer chase. Items must be trivially copyable as they are moved around with memcpy.
+template <typename T, unsigned N>
+class SmallVector
+{
+	static_assert(std::is_trivially_copyable<T>::value, "SmallVector items are copied with memcpy");
+	static_assert(N > 0, "SmallVector needs room for at least one inline item");
+
+	public:
+		typedef T *iterator;
+		typedef const T *const_iterator;
+
+		SmallVector() : count(0), capacity(N) {}
+
+		SmallVector(const SmallVector &other) : SmallVector()
+		{
+			assign(other.begin(), other.end());
+		}
+
+		SmallVector(SmallVector &&other) : SmallVector()
+		{
+			steal(other);
+		}
+
+		~SmallVector()
+		{
+			release();
+		}
+
+		SmallVector &operator=(const SmallVector &other)
+		{
+			if (this != &other)
+			{
+				assign(other.begin(), other.end());
+			}
+
+			return *this;
+		}
+
+		SmallVector &operator=(SmallVector &&other)
+		{
+			if (this != &other)
+			{
+				release();
+				steal(other);
+			}
+
+			return *this;
+		}
+
+		inline unsigned size() const { return count; }
+		inline bool empty() const { return count == 0; }
+		inline bool spilled() const { return capacity > N; }
+		inline T *data() { return spilled() ? storage.heap : reinterpret_cast<T *>(storage.inlineItems); }
+		inline const T *data() const { return spilled() ? storage.heap : reinterpret_cast<const T *>(storage.inlineItems); }
+		inline iterator begin() { return data(); }
+		inline iterator end() { return data() + count; }
+		inline const_iterator begin() const { return data(); }
+		inline const_iterator end() const { return data() + count; }
+		inline T &operator[](unsigned index) { assert(index < count); return data()[index]; }
+		inline const T &operator[](unsigned index) const { assert(index < count); return data()[index]; }
+		inline T &front() { return (*this)[0]; }
+		inline const T &front() const { return (*this)[0]; }
+		inline T &back() { return (*this)[count - 1]; }
+		inline const T &back() const { return (*this)[count - 1]; }
+
+		// Bytes held on the heap, nothing while the items still fit inline
+		inline size_t heapBytes() const { return spilled() ? capacity * sizeof(T) : 0; }
+
+		void reserve(unsigned requestedCapacity)
+		{
+			if (requestedCapacity <= capacity)
+			{
+				return;
+			}
+
+			allocationprofile::countAllocation(requestedCapacity * sizeof(T));
+			T *grown = static_cast<T *>(std::malloc(requestedCapacity * sizeof(T)));
+			if (grown == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+			std::memcpy(static_cast<void *>(grown), static_cast<const void *>(data()), count * sizeof(T));
+			if (spilled())
+			{
+				std::free(storage.heap);
+			}
+			storage.heap = grown;
+			capacity = requestedCapacity;
+		}
+
+		void push_back(const T &item)
+		{
+			if (count == capacity)
+			{
+				// The item may live in our own storage so copy it before growing
+				T copy = item;
+				reserve(2 * capacity);
+				data()[count++] = copy;
+				return;
+			}
+
+			data()[count++] = item;
+		}
+
+		template <typename... Args>
+		void emplace_back(Args &&... args)
+		{
+			push_back(T(std::forward<Args>(args)...));
+		}
+
+		void pop_back()
+		{
+			assert(count > 0);
+			--count;
+		}
+
+		void clear()
+		{
+			count = 0;
+		}
+
+		template <typename Iterator>
+		void assign(Iterator first, Iterator last)
+		{
+			clear();
+			for (; first != last; ++first)
+			{
+				push_back(*first);
+			}
+		}
+
+		void swap(SmallVector &other)
+		{
+			SmallVector swapped(std::move(other));
+			other = std::move(*this);
+			*this = std::move(swapped);
+		}
+
+	private:
+		void release()
+		{
+			if (spilled())
+			{
+				std::free(storage.heap);
+			}
+			count = 0;
+			capacity = N;
+		}
+
+		// Takes the items of other leaving it empty, other's heap buffer is handed over as is
+		void steal(SmallVector &other)
+		{
+			if (other.spilled())
+			{
+				storage.heap = other.storage.heap;
+				capacity = other.capacity;
+			}
+			else
+			{
+				std::memcpy(storage.inlineItems, other.storage.inlineItems, other.count * sizeof(T));
+			}
+			count = other.count;
+
+			other.count = 0;
+			other.capacity = N;
+		}
+
+		union Storage
+		{
+			alignas(T) unsigned char inlineItems[N * sizeof(T)];
+			T *heap;
+		} storage;
+		unsigned count;
+		unsigned capacity;
+};
+
+#endif
@@ -0,0 +1,184 @@
+#ifndef __SNAPSHOT__
+#define __SNAPSHOT__
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <globals/globals.h>
+
+// Binary snapshots of an index so that a tree is built once and then read back instead of
+// being rebuilt point by point on every run. A snapshot is a header naming the tree, the
+// dimension and the branch factors followed by every node in preorder, each tree laying out its
+// own nodes. Values are written as they sit in memory so a snapshot only reads back on the
+// machine and build that wrote it, which the header checks as far as it can.
+namespace snapshot
+{
+	enum TreeTag : uint32_t { RTreeTag, RPlusTreeTag, RStarTreeTag, NIRTreeTag, QuadTreeTag, RevisedRStarTreeTag };
+
+	constexpr char magic[8] = {'N', 'I', 'R', 'S', 'N', 'A', 'P', '\0'};
+	constexpr uint32_t version = 1;
+
+	// Streams values to a file through one large buffer so writes reach the file sequentially
+	class Writer
+	{
+		public:
+			static constexpr size_t bufferBytes = 1 << 20;
+
+			explicit Writer(const std::string &path) : file(std::fopen(path.c_str(), "wb")), ok(file != nullptr)
+			{
+				buffer.reserve(bufferBytes);
+			}
+
+			Writer(const Writer &) = delete;
+			Writer &operator=(const Writer &) = delete;
+
+			~Writer()
+			{
+				close();
+			}
+
+			template <typename T>
+			void write(const T &value)
+			{
+				write(&value, 1);
+			}
+
+			template <typename T>
+			void write(const T *values, size_t count)
+			{
+				static_assert(std::is_trivially_copyable<T>::value, "Snapshots hold values as they sit in memory");
+				const char *bytes = reinterpret_cast<const char *>(values);
+				buffer.insert(buffer.end(), bytes, bytes + count * sizeof(T));
+				if (buffer.size() >= bufferBytes)
+				{
+					flush();
+				}
+			}
+
+			// Flushes and closes the file, false if any write failed
+			bool close()
+			{
+				if (file != nullptr)
+				{
+					flush();
+					ok = std::fclose(file) == 0 && ok;
+					file = nullptr;
+				}
+
+				return ok;
+			}
+
+		private:
+			void flush()
+			{
+				if (ok && !buffer.empty())
+				{
+					ok = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+				}
+				buffer.clear();
+			}
+
+			std::FILE *file;
+			bool ok;
+			std::vector<char> buffer;
+	};
+
+	// Takes a whole snapshot into memory with a single read and hands values out of it in order.
+	// Reads past the end fail rather than run off the buffer so that a truncated or corrupt
+	// snapshot is refused instead of building a broken tree.
+	class Reader
+	{
+		public:
+			explicit Reader(const std::string &path) : offset(0), ok(false)
+			{
+				std::FILE *file = std::fopen(path.c_str(), "rb");
+				if (file == nullptr)
+				{
+					return;
+				}
+
+				if (std::fseek(file, 0, SEEK_END) == 0)
+				{
+					long size = std::ftell(file);
+					if (size >= 0 && std::fseek(file, 0, SEEK_SET) == 0)
+					{
+						bytes.resize(size);
+						ok = std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size();
+					}
+				}
+				std::fclose(file);
+			}
+
+			template <typename T>
+			bool read(T &value)
+			{
+				return read(&value, 1);
+			}
+
+			template <typename T>
+			bool read(T *values, size_t count)
+			{
+				static_assert(std::is_trivially_copyable<T>::value, "Snapshots hold values as they sit in memory");
+				if (!ok || count > (bytes.size() - offset) / sizeof(T))
+				{
+					ok = false;
+					return false;
+				}
+
+				std::memcpy(static_cast<void *>(values), bytes.data() + offset, count * sizeof(T));
+				offset += count * sizeof(T);
+				return true;
+			}
+
+			// Replaces the contents of values with the next count values
+			template <typename T, typename Allocator>
+			bool read(std::vector<T, Allocator> &values, size_t count)
+			{
+				if (!ok || count > (bytes.size() - offset) / sizeof(T))
+				{
+					ok = false;
+					return false;
+				}
+
+				values.resize(count);
+				return read(values.data(), count);
+			}
+
+			inline bool good() const { return ok; }
+			inline bool atEnd() const { return ok && offset == bytes.size(); }
+
+		private:
+			std::vector<char> bytes;
+			size_t offset;
+			bool ok;
+	};
+
+	inline void writeHeader(Writer &writer, TreeTag tree, uint32_t minBranchFactor, uint32_t maxBranchFactor)
+	{
+		writer.write(magic, sizeof(magic));
+		writer.write(version);
+		writer.write((uint32_t) tree);
+		writer.write((uint32_t) dimensions);
+		writer.write(minBranchFactor);
+		writer.write(maxBranchFactor);
+	}
+
+	// False unless the snapshot was written by the same kind of tree with the same dimension and
+	// branch factors
+	inline bool readHeader(Reader &reader, TreeTag tree, uint32_t minBranchFactor, uint32_t maxBranchFactor)
+	{
+		char readMagic[sizeof(magic)];
+		uint32_t fields[5];
+		if (!reader.read(readMagic, sizeof(readMagic)) || !reader.read(fields, 5))
+		{
+			return false;
+		}
+
+		return std::memcmp(readMagic, magic, sizeof(magic)) == 0 && fields[0] == version && fields[1] == tree && fields[2] == dimensions && fields[3] == minBranchFactor && fields[4] == maxBranchFactor;
+	}
+}
+
+#endif
@@ -1,13 +1,15 @@
 #ifndef __STATISTICS__
 #define __STATISTICS__
 
-#define unlikely(x) __builtin_expect((x),0)
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include <ostream>
 
-#ifndef STAT
-	#define CONST_IF_NOT_STAT const
-#else
-	#define CONST_IF_NOT_STAT 
-#endif
+#define unlikely(x) __builtin_expect((x),0)
 
 class Statistics {
 	public:
@@ -71,6 +73,14 @@ class Statistics {
 			nodesSearched++;
 		}
 
+		void merge(const Statistics &other)
+		{
+			mergeHistogram(histogramSearch, other.histogramSearch);
+			mergeHistogram(histogramLeaves, other.histogramLeaves);
+			mergeHistogram(histogramRangeSearch, other.histogramRangeSearch);
+			mergeHistogram(histogramRangeLeaves, other.histogramRangeLeaves);
+		}
+
 		friend std::ostream& operator<<(std::ostream &os, const Statistics &stats)
         {
 			os << "Histogram of Searched Nodes Follows:" << std::endl;
@@ -110,6 +120,19 @@ class Statistics {
         }
 
 	private:
+		static void mergeHistogram(std::vector<unsigned> &into, const std::vector<unsigned> &from)
+		{
+			if (from.size() > into.size())
+			{
+				into.resize(from.size(), 0);
+			}
+
+			for (unsigned i = 0; i < from.size(); ++i)
+			{
+				into[i] += from[i];
+			}
+		}
+
 		std::vector<unsigned> histogramSearch;
 		std::vector<unsigned> histogramLeaves;
 		std::vector<unsigned> histogramRangeSearch;
@@ -118,11 +141,86 @@ class Statistics {
 		unsigned leavesSearched;
 };
 
+// Search statistics for a tree that may be searched from several threads at once. Each thread
+// records into its own Statistics so searches stay const and lock free, and the per-thread
+// histograms are only merged when they are printed. Print after the searching threads are done.
+class ThreadStatistics {
+	public:
+		ThreadStatistics() : id(nextId++) {}
+		ThreadStatistics(const ThreadStatistics &) = delete;
+		ThreadStatistics &operator=(const ThreadStatistics &) = delete;
+
+		template <bool isRange>
+		inline void resetSearchTracker() const
+		{
+			local().resetSearchTracker<isRange>();
+		}
+
+		inline void markLeafSearched() const
+		{
+			local().markLeafSearched();
+		}
+
+		inline void markNonLeafNodeSearched() const
+		{
+			local().markNonLeafNodeSearched();
+		}
+
+		Statistics merged() const
+		{
+			Statistics total;
+			std::lock_guard<std::mutex> lock(registryLock);
+			for (const auto &threadStatistics : registry)
+			{
+				total.merge(*threadStatistics);
+			}
+
+			return total;
+		}
+
+		friend std::ostream& operator<<(std::ostream &os, const ThreadStatistics &stats)
+		{
+			return os << stats.merged();
+		}
+
+	private:
+		// Ids are never reused so a thread's cache can never alias a newer tree at the same address
+		Statistics &local() const
+		{
+			thread_local uint64_t cachedId = 0;
+			thread_local Statistics *cachedStatistics = nullptr;
+			if (cachedId == id)
+			{
+				return *cachedStatistics;
+			}
+
+			thread_local std::unordered_map<uint64_t, Statistics *> owned;
+			Statistics *&threadStatistics = owned[id];
+			if (threadStatistics == nullptr)
+			{
+				std::lock_guard<std::mutex> lock(registryLock);
+				registry.emplace_back(new Statistics());
+				threadStatistics = registry.back().get();
+			}
+
+			cachedId = id;
+			cachedStatistics = threadStatistics;
+			return *threadStatistics;
+		}
+
+		static inline std::atomic<uint64_t> nextId{1};
+
+		const uint64_t id;
+		mutable std::mutex registryLock;
+		mutable std::vector<std::unique_ptr<Statistics>> registry;
+};
+
 #ifdef STAT
 	#include <iostream>
 
 	#define STATEXEC(e) e
 	#define STATMEM(mem) std::cout << "Memory Usage: " << (mem / 1024) << "KB, " << (mem / (1024 * 1024)) << "MB, " << (mem / (1024 * 1024 * 1024)) << "GB" << std::endl
+	#define STATARENA(bytes, nodes) std::cout << "Node Arena: " << (bytes / 1024) << "KB, " << (bytes / (1024 * 1024)) << "MB in slabs holding " << nodes << " nodes" << std::endl
 	#define STATHEIGHT(height) std::cout << "Tree Height: " << height << std::endl
 	#define STATSIZE(n) std::cout << "Tree Nodes: " << n << std::endl
 	#define STATSINGULAR(n) std::cout << "Tree Nodes w/fanout=1: " << n << std::endl
@@ -133,6 +231,8 @@ class Statistics {
 	#define STATAVGCOVER(c) std::cout << "Avg Coverage Per Node: " << c << std::endl;
 	#define STATAVGOVERLAP(o) std::cout << "Avg Overlap Per Node: " << o << std::endl;
 	#define STATFANHIST() std::cout << "Histogram of Fanout Follows: " << std::endl
+	#define STATBUILDTIME(t) std::cout << "Build Time: " << t << "s" << std::endl
+	#define STATUTILIZATION(u) std::cout << "Node Utilization: " << (u * 100.0) << "%" << std::endl
 	#define STATLINES(n) std::cout << "Bounding Lines: " << n << std::endl
 	#define STATTOTALPOLYSIZE(n) std::cout << "Total Polygon Size: " << n << std::endl
 	#define STATPOLYHIST() std::cout << "Histogram of Polygon Sizes Follows:" << std::endl
@@ -144,12 +244,15 @@ class Statistics {
 #else 
 	#define STATEXEC(e)
 	#define STATMEM(mem)
+	#define STATARENA(bytes, nodes)
 	#define STATHEIGHT(height)
 	#define STATSIZE(n)
 	#define STATSINGULAR(n)
 	#define STATLEAF(n)
 	#define STATBRANCH(branches)
 	#define STATFANHIST()
+	#define STATBUILDTIME(t)
+	#define STATUTILIZATION(u)
 	#define STATLINES(n)
 	#define STATTOTALPOLYSIZE(n)
 	#define STATPOLYHIST()
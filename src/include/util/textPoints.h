@@ -0,0 +1,158 @@
+#ifndef __TEXTPOINTS__
+#define __TEXTPOINTS__
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <omp.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <util/geometry.h>
+
+// Text data files of whitespace separated coordinates, parsed in parallel straight out of a
+// mapping of the file. The file is cut into one chunk per thread at line ends, every chunk first
+// counts its numbers so it knows which coordinate it starts at and then parses them in place into
+// the points. Reading the text file is then bound by memory bandwidth instead of one stream.
+namespace textpoints
+{
+	inline bool isSpace(char c)
+	{
+		return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+	}
+
+	// Parses the number starting at begin and returns where it ends, or begin if it is not one
+	inline const char *parseDouble(const char *begin, const char *end, double &value)
+	{
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+		std::from_chars_result result = std::from_chars(begin, end, value);
+		return result.ec == std::errc() ? result.ptr : begin;
+#else
+		// Without floating point from_chars fall back to strtod on a terminated copy of the
+		// number, the mapping has no terminator of its own
+		char token[64];
+		size_t length = std::min((size_t) (end - begin), sizeof(token) - 1);
+		std::memcpy(token, begin, length);
+		token[length] = '\0';
+		char *next;
+		value = std::strtod(token, &next);
+		return begin + (next - token);
+#endif
+	}
+
+	// Reads the first count points of the file into points, false if it cannot be mapped, holds
+	// fewer numbers or holds something that is not a number. Coordinates beyond the compiled
+	// dimensions are dropped.
+	inline bool read(const std::string &path, unsigned pointDimensions, size_t count, Point *points)
+	{
+		int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return false;
+		}
+
+		const char *text = nullptr;
+		size_t textBytes = 0;
+		struct stat fileStatus;
+		if (fstat(file, &fileStatus) == 0 && fileStatus.st_size > 0)
+		{
+			void *memory = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (memory != MAP_FAILED)
+			{
+				text = static_cast<const char *>(memory);
+				textBytes = fileStatus.st_size;
+			}
+		}
+		::close(file);
+
+		if (text == nullptr)
+		{
+			return pointDimensions > 0 && count == 0;
+		}
+
+		madvise(const_cast<char *>(text), textBytes, MADV_SEQUENTIAL);
+
+		// TP1 [Cut the file into a chunk per thread at line ends]
+		const char *textEnd = text + textBytes;
+		const unsigned chunkCount = omp_get_max_threads();
+		std::vector<const char *> bounds(chunkCount + 1, textEnd);
+		bounds[0] = text;
+		for (unsigned c = 1; c < chunkCount; ++c)
+		{
+			const char *cut = std::max(text + textBytes / chunkCount * c, bounds[c - 1]);
+			const char *lineEnd = static_cast<const char *>(std::memchr(cut, '\n', textEnd - cut));
+			bounds[c] = lineEnd == nullptr ? textEnd : lineEnd + 1;
+		}
+
+		// TP2 [Count the numbers in every chunk]
+		// Each is a run of anything but whitespace, the sums give the coordinate each chunk starts at
+		std::vector<size_t> firstValue(chunkCount + 1, 0);
+		#pragma omp parallel for schedule(static, 1)
+		for (unsigned c = 0; c < chunkCount; ++c)
+		{
+			size_t values = 0;
+			bool inValue = false;
+			for (const char *cursor = bounds[c]; cursor < bounds[c + 1]; ++cursor)
+			{
+				bool space = isSpace(*cursor);
+				values += inValue && space;
+				inValue = !space;
+			}
+			firstValue[c + 1] = values + inValue;
+		}
+
+		for (unsigned c = 0; c < chunkCount; ++c)
+		{
+			firstValue[c + 1] += firstValue[c];
+		}
+
+		const size_t wanted = count * pointDimensions;
+		if (pointDimensions == 0 || firstValue[chunkCount] < wanted)
+		{
+			munmap(const_cast<char *>(text), textBytes);
+			return false;
+		}
+
+		// TP3 [Parse every chunk straight into its points]
+		bool ok = true;
+		#pragma omp parallel for schedule(static, 1) reduction(&&:ok)
+		for (unsigned c = 0; c < chunkCount; ++c)
+		{
+			const char *cursor = bounds[c];
+			const char *chunkEnd = bounds[c + 1];
+			for (size_t value = firstValue[c]; value < wanted; ++value)
+			{
+				for (; cursor < chunkEnd && isSpace(*cursor); ++cursor) {}
+				if (cursor == chunkEnd)
+				{
+					break;
+				}
+
+				double coordinate;
+				const char *next = parseDouble(cursor, chunkEnd, coordinate);
+				if (next == cursor || (next < chunkEnd && !isSpace(*next)))
+				{
+					ok = false;
+					break;
+				}
+				cursor = next;
+
+				unsigned d = value % pointDimensions;
+				if (d < dimensions)
+				{
+					points[value / pointDimensions][d] = coordinate;
+				}
+			}
+		}
+
+		munmap(const_cast<char *>(text), textBytes);
+
+		return ok;
+	}
+}
+
+#endif
@@ -6,10 +6,12 @@
 #include <rplustree/rplustree.h>
 #include <rstartree/rstartree.h>
 #include <nirtree/nirtree.h>
+#include <revisedrstartree/revisedrstartree.h>
+#include <util/nodeSizing.h>
 #include <bench/randomPoints.h>
 #include <unistd.h>
 
-void parameters(std::map<std::string, unsigned> &configU, std::map<std::string, double> configD)
+void parameters(std::map<std::string, unsigned> &configU, std::map<std::string, double> configD, std::map<std::string, std::string> configS)
 {
 	std::string treeTypes[] = {"R_TREE", "R_PLUS_TREE", "R_STAR_TREE", "NIR_TREE", "QUAD_TREE", "REVISED_R_STAR_TREE"};
 	std::string benchTypes[] = {"UNIFORM", "SKEW", "CLUSTER", "CALIFORNIA", "BIOLOGICAL", "FOREST", "CANADA", "GAIA", "MICROSOFTBUILDINGS"};
@@ -18,14 +20,31 @@ void parameters(std::map<std::string, unsigned> &configU, std::map<std::string,
 	std::cout << "  tree = " << treeTypes[configU["tree"]] << std::endl;
 	std::cout << "  benchmark = " << benchTypes[configU["distribution"]] << std::endl;
 	std::cout << "  min/max branches = " << configU["minfanout"] << "/" << configU["maxfanout"] << std::endl;
+	std::cout << "  node bytes = " << configU["nodebytes"] << std::endl;
 	std::cout << "  n = " << configU["size"] << std::endl;
 	std::cout << "  dimensions = " << dimensions << std::endl;
 	std::cout << "  seed = " << configU["seed"] << std::endl;
 	std::cout << "  search rectangles = " << configU["rectanglescount"] << std::endl;
+	std::cout << "  bulk load = " << (configU["bulkload"] ? "on" : "off") << std::endl;
+	std::cout << "  insert batch size = " << configU["insertbatch"] << std::endl;
+	std::cout << "  search batch size = " << configU["searchbatch"] << std::endl;
+	std::cout << "  nearest neighbours = " << configU["knn"] << std::endl;
+	std::cout << "  count = " << (configU["count"] ? "on" : "off") << std::endl;
+	std::cout << "  parallel search threads = " << configU["threads"] << std::endl;
+	std::cout << "  read ahead = " << configU["chunkbuffers"] << " chunks of " << configU["chunksize"] << " points" << std::endl;
 	std::cout << "  visualization = " << (configU["visualization"] ? "on" : "off") << std::endl;
+	std::cout << "  snapshot = " << (configS["snapshot"].empty() ? "off" : configS["snapshot"]) << std::endl;
+	std::cout << "  paged tree = " << (configS["paged"].empty() ? "off" : configS["paged"]) << std::endl;
 	std::cout << "### ### ### ### ### ###" << std::endl << std::endl;
 }
 
+template <typename Tree>
+void fanoutFromNodeBytes(std::map<std::string, unsigned> &configU)
+{
+	configU["minfanout"] = nodesizing::minFanout<Tree>(configU["nodebytes"]);
+	configU["maxfanout"] = nodesizing::maxFanout<Tree>(configU["nodebytes"]);
+}
+
 int main(int argc, char *argv[])
 {
 	// Process command line options
@@ -41,10 +60,23 @@ int main(int argc, char *argv[])
 	configU.emplace("seed", 3141);
 	configU.emplace("rectanglescount", 5000);
 	configU.emplace("visualization", false);
+	configU.emplace("bulkload", false);
+	configU.emplace("insertbatch", 0);
+	configU.emplace("searchbatch", 0);
+	configU.emplace("knn", 0);
+	configU.emplace("count", false);
+	configU.emplace("threads", 0);
+	configU.emplace("nodebytes", 0);
+	configU.emplace("chunksize", 10000);
+	configU.emplace("chunkbuffers", 4);
 
 	std::map<std::string, double> configD;
 
-	while ((option = getopt(argc, argv, "t:m:a:b:n:s:r:v:")) != -1)
+	std::map<std::string, std::string> configS;
+	configS.emplace("snapshot", "");
+	configS.emplace("paged", "");
+
+	while ((option = getopt(argc, argv, "t:m:a:b:n:s:r:v:li:q:k:cj:p:f:g:e:u:")) != -1)
 	{
 		switch (option)
 		{
@@ -88,6 +120,61 @@ int main(int argc, char *argv[])
 				configU["visualization"] = true;
 				break;
 			}
+			case 'l': // Bulk load
+			{
+				configU["bulkload"] = true;
+				break;
+			}
+			case 'i': // Insert batch size
+			{
+				configU["insertbatch"] = atoi(optarg);
+				break;
+			}
+			case 'q': // Search batch size
+			{
+				configU["searchbatch"] = atoi(optarg);
+				break;
+			}
+			case 'k': // Nearest neighbours
+			{
+				configU["knn"] = atoi(optarg);
+				break;
+			}
+			case 'c': // Count
+			{
+				configU["count"] = true;
+				break;
+			}
+			case 'j': // Parallel search threads
+			{
+				configU["threads"] = atoi(optarg);
+				break;
+			}
+			case 'p': // Node size in bytes
+			{
+				configU["nodebytes"] = atoi(optarg);
+				break;
+			}
+			case 'f': // Snapshot file
+			{
+				configS["snapshot"] = optarg;
+				break;
+			}
+			case 'g': // Paged R*-tree file
+			{
+				configS["paged"] = optarg;
+				break;
+			}
+			case 'e': // Read ahead chunk size
+			{
+				configU["chunksize"] = atoi(optarg);
+				break;
+			}
+			case 'u': // Read ahead chunks
+			{
+				configU["chunkbuffers"] = atoi(optarg);
+				break;
+			}
 			default:
 			{
 				std::cout << "Bad option. Usage:" << std::endl;
@@ -99,14 +186,56 @@ int main(int argc, char *argv[])
 				std::cout << "    -s  Specifies benchmark seed if benchmark type is randomly generated" << std::endl;
 				std::cout << "    -r  Specifies number of rectangles to search in benchmark if size is not constant for benchmark type" << std::endl;
 				std::cout << "    -v  Turns visualization on or off for first two dimensions of the selected tree" << std::endl;
+				std::cout << "    -l  Bulk loads the selected tree instead of inserting points one at a time" << std::endl;
+				std::cout << "    -i  Inserts points in batches of the given size, e.g. 10000 to match chunked file reads" << std::endl;
+				std::cout << "    -q  Searches rectangles in batches of the given size sharing one traversal per batch" << std::endl;
+				std::cout << "    -k  Also finds the given number of nearest neighbours of each search point" << std::endl;
+				std::cout << "    -c  Also counts the points in each search rectangle without retrieving them" << std::endl;
+				std::cout << "    -j  Repeats the point and rectangle searches split across the given number of threads" << std::endl;
+				std::cout << "    -p  Derives fanouts from a node size in bytes, a multiple of 64 such as 4096 for a page, instead of -a and -b" << std::endl;
+				std::cout << "    -f  Loads the selected tree from the given snapshot file, or builds it and saves it there if there is none yet" << std::endl;
+				std::cout << "    -g  Writes the R*-tree out as pages to the given file and repeats the range searches on it mapped back in" << std::endl;
+				std::cout << "    -e  Points per chunk read ahead in the background for chunked and binary file benchmarks" << std::endl;
+				std::cout << "    -u  Number of chunks read ahead in the background for chunked and binary file benchmarks" << std::endl;
 				return 1;
 			}
 		}
 	}
 
+	// Fit the fanouts to the node size if one was given
+	if (configU["nodebytes"] != 0)
+	{
+		if (configU["nodebytes"] % nodesizing::cacheLineBytes != 0)
+		{
+			std::cout << "Node size must be a multiple of " << nodesizing::cacheLineBytes << " bytes." << std::endl;
+			return 1;
+		}
+
+		if (configU["tree"] == R_TREE)
+		{
+			fanoutFromNodeBytes<rtree::RTree>(configU);
+		}
+		else if (configU["tree"] == R_PLUS_TREE)
+		{
+			fanoutFromNodeBytes<rplustree::RPlusTree>(configU);
+		}
+		else if (configU["tree"] == R_STAR_TREE)
+		{
+			fanoutFromNodeBytes<rstartree::RStarTree>(configU);
+		}
+		else if (configU["tree"] == NIR_TREE)
+		{
+			fanoutFromNodeBytes<nirtree::NIRTree>(configU);
+		}
+		else if (configU["tree"] == REVISED_R_STAR_TREE)
+		{
+			fanoutFromNodeBytes<revisedrstartree::RevisedRStarTree>(configU);
+		}
+	}
+
 	// Print test parameters
-	parameters(configU, configD);
+	parameters(configU, configD, configS);
 
 	// Run the benchmark
-	randomPoints(configU, configD);
+	randomPoints(configU, configD, configS);
 }
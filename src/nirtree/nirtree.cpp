@@ -16,20 +16,14 @@
 
 namespace nirtree
 {
-	NIRTree::NIRTree(unsigned minBranchFactor, unsigned maxBranchFactor)
+	NIRTree::NIRTree(unsigned minBranchFactor, unsigned maxBranchFactor) : minBranchFactor(minBranchFactor), maxBranchFactor(maxBranchFactor)
 	{
-		root = new Node(*this, minBranchFactor, maxBranchFactor);
-	}
-
-	NIRTree::NIRTree(Node *root)
-	{
-		this->root = root;
+		root = nodeArena.create(*this);
 	}
 
 	NIRTree::~NIRTree()
 	{
-		root->deleteSubtrees();
-		delete root;
+		// The node arena tears every node down in one sweep
 	}
 
 	std::vector<Point> NIRTree::exhaustiveSearch(Point requestedPoint)
@@ -40,26 +34,88 @@ namespace nirtree
 		return v;
 	}
 
-	std::vector<Point> NIRTree::search(Point requestedPoint) CONST_IF_NOT_STAT
+	std::vector<Point> NIRTree::search(Point requestedPoint) const
 	{
+		ALLOCSCOPE(allocationProfile, Search);
 		return root->search(requestedPoint);
 	}
 
-	std::vector<Point> NIRTree::search(Rectangle requestedRectangle) CONST_IF_NOT_STAT
+	std::vector<Point> NIRTree::search(Rectangle requestedRectangle) const
 	{
+		ALLOCSCOPE(allocationProfile, RangeSearch);
 		return root->search(requestedRectangle);
 	}
 
+	void NIRTree::searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const
+	{
+		search(requestedRectangle, [visit, visitor](const Point &p) { visit(visitor, p); });
+	}
+
+	std::vector<Point> NIRTree::nearest(const Point &givenPoint, unsigned k) const
+	{
+		return root->nearest(givenPoint, k);
+	}
+
+	std::vector<std::vector<Point>> NIRTree::searchBatch(const std::vector<Rectangle> &requestedRectangles) const
+	{
+		std::vector<std::vector<Point>> accumulators(requestedRectangles.size());
+		root->searchBatch(requestedRectangles, accumulators);
+
+		return accumulators;
+	}
+
+	unsigned NIRTree::count(const Rectangle &requestedRectangle) const
+	{
+		return root->count(requestedRectangle);
+	}
+
 	void NIRTree::insert(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Insert);
 		root = root->insert(givenPoint);
 	}
 
 	void NIRTree::remove(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Remove);
 		root = root->remove(givenPoint);
 	}
 
+	void NIRTree::bulkLoad(std::vector<Point> &points)
+	{
+		root = root->bulkLoad(points);
+	}
+
+	void NIRTree::insertBatch(const std::vector<Point> &points)
+	{
+		root = root->insertBatch(points);
+	}
+
+	bool NIRTree::save(const std::string &path) const
+	{
+		snapshot::Writer writer(path);
+		snapshot::writeHeader(writer, snapshot::NIRTreeTag, minBranchFactor, maxBranchFactor);
+		root->save(writer);
+
+		return writer.close();
+	}
+
+	bool NIRTree::load(const std::string &path)
+	{
+		snapshot::Reader reader(path);
+		nodeArena.clear();
+		root = nodeArena.create(*this);
+
+		if (!snapshot::readHeader(reader, snapshot::NIRTreeTag, minBranchFactor, maxBranchFactor) || !root->load(reader) || !reader.atEnd())
+		{
+			nodeArena.clear();
+			root = nodeArena.create(*this);
+			return false;
+		}
+
+		return true;
+	}
+
 	unsigned NIRTree::checksum()
 	{
 		return root->checksum();
@@ -17,39 +17,13 @@
 
 namespace nirtree
 {
-	Node::Node(NIRTree &treeRef) :
+	Node::Node(NIRTree &treeRef, Node *p) :
 		treeRef(treeRef)
 	{
-		minBranchFactor = 0;
-		maxBranchFactor = 0;
-		parent = nullptr;
-	}
-
-	Node::Node(NIRTree &treeRef, unsigned minBranch, unsigned maxBranch, Node *p) :
-		treeRef(treeRef)
-	{
-		minBranchFactor = minBranch;
-		maxBranchFactor = maxBranch;
 		parent = p;
 	}
 
-	void Node::deleteSubtrees()
-	{
-		if (branches.size() == 0)
-		{
-			return;
-		}
-		else
-		{
-			for (Branch &branch : branches)
-			{
-				branch.child->deleteSubtrees();
-				delete branch.child;
-			}
-		}
-	}
-
-	bool Node::isLeaf()
+	bool Node::isLeaf() const
 	{
 		if (branches.size() == 0 && data.size() >= 0)
 		{
@@ -114,7 +88,7 @@ namespace nirtree
 		for (childIndex = 0; branches[childIndex].child != child && childIndex < branchesSize; ++childIndex) {}
 
 		// Update the child
-		branches[childIndex] = {child, boundingPoly};
+		branches[childIndex] = {child, boundingPoly, branches[childIndex].count};
 	}
 
 	void Node::removeBranch(Node *child)
@@ -125,7 +99,7 @@ namespace nirtree
 		for (childIndex = 0; branches[childIndex].child != child && childIndex < branchesSize; ++childIndex) {}
 
 		// Delete the child by deleting it and overwriting its branch
-		delete child;
+		treeRef.nodeArena.destroy(child);
 		branches[childIndex] = branches.back();
 		branches.pop_back();
 	}
@@ -138,8 +112,41 @@ namespace nirtree
 		for (pointIndex = 0; data[pointIndex] != givenPoint && pointIndex < dataSize; ++pointIndex) {}
 
 		// Delete the point by overwriting it
-		data[pointIndex] = data.back();
-		data.pop_back();
+		data.removeAt(pointIndex);
+		propagateCount(-1);
+	}
+
+	unsigned Node::subtreeCount()
+	{
+		if (isLeaf())
+		{
+			return data.size();
+		}
+
+		unsigned sum = 0;
+		for (Branch &branch : branches)
+		{
+			sum += branch.count;
+		}
+
+		return sum;
+	}
+
+	// Every point added to or removed from a leaf has to reach the counts of all its ancestors'
+	// branches. Splits only redistribute points so they recount the new branches instead.
+	void Node::propagateCount(int delta)
+	{
+		for (Node *node = this; node->parent != nullptr; node = node->parent)
+		{
+			for (Branch &branch : node->parent->branches)
+			{
+				if (branch.child == node)
+				{
+					branch.count += delta;
+					break;
+				}
+			}
+		}
 	}
 
 	void Node::exhaustiveSearch(Point &requestedPoint, std::vector<Point> &accumulator)
@@ -147,7 +154,7 @@ namespace nirtree
 		if (isLeaf())
 		{
 			// We are a leaf so add our data points when they are the search point
-			for (Point &dataPoint : data)
+			for (const Point &dataPoint : data)
 			{
 				if (requestedPoint == dataPoint)
 				{
@@ -167,14 +174,14 @@ namespace nirtree
 		}
 	}
 
-	std::vector<Point> Node::search(Point &requestedPoint)
+	std::vector<Point> Node::search(const Point &requestedPoint) const
 	{
 		std::vector<Point> accumulator;
 
 		// Initialize our context stack
-		std::stack<Node *> context;
+		std::stack<const Node *> context;
 		context.push(this);
-		Node *currentContext;
+		const Node *currentContext;
 
 		for (;!context.empty();)
 		{
@@ -184,7 +191,7 @@ namespace nirtree
 			if (currentContext->isLeaf())
 			{
 				// We are a leaf so add our data points when they are the search point
-				for (Point &dataPoint : currentContext->data)
+				for (const Point &dataPoint : currentContext->data)
 				{
 					if (requestedPoint == dataPoint)
 					{
@@ -198,7 +205,7 @@ namespace nirtree
 			else
 			{
 				// Determine which branches we need to follow
-				for (Branch &branch : currentContext->branches)
+				for (const Branch &branch : currentContext->branches)
 				{
 					if (branch.boundingPoly.containsPoint(requestedPoint))
 					{
@@ -219,14 +226,14 @@ namespace nirtree
 		return accumulator;
 	}
 
-	std::vector<Point> Node::search(Rectangle &requestedRectangle)
+	std::vector<Point> Node::search(const Rectangle &requestedRectangle) const
 	{
 		std::vector<Point> accumulator;
 
 		// Initialize our context stack
-		std::stack<Node *> context;
+		std::stack<const Node *> context;
 		context.push(this);
-		Node *currentContext;
+		const Node *currentContext;
 
 		for (;!context.empty();)
 		{
@@ -236,13 +243,7 @@ namespace nirtree
 			if (currentContext->isLeaf())
 			{
 				// We are a leaf so add our data points when they are within the search rectangle
-				for (Point &dataPoint : currentContext->data)
-				{
-					if (requestedRectangle.containsPoint(dataPoint))
-					{
-						accumulator.push_back(dataPoint);
-					}
-				}
+				currentContext->data.forEachContained(requestedRectangle, [&accumulator](const Point &dataPoint) { accumulator.push_back(dataPoint); });
 
 #ifdef STAT
 				treeRef.stats.markLeafSearched();
@@ -251,7 +252,7 @@ namespace nirtree
 			else
 			{
 				// Determine which branches we need to follow
-				for (Branch &branch : currentContext->branches)
+				for (const Branch &branch : currentContext->branches)
 				{
 					if (branch.boundingPoly.intersectsRectangle(requestedRectangle))
 					{
@@ -271,6 +272,68 @@ namespace nirtree
 		return accumulator;
 	}
 
+	// Answers many range queries in one traversal. Queries are taken 64 at a time and every node
+	// on the stack carries a mask of the queries still intersecting it, so upper levels are visited
+	// once per chunk instead of once per query.
+	void Node::searchBatch(const std::vector<Rectangle> &requestedRectangles, std::vector<std::vector<Point>> &accumulators) const
+	{
+		// Initialize our context stack
+		std::stack<std::pair<const Node *, uint64_t>> context;
+
+		for (unsigned chunkBegin = 0; chunkBegin < requestedRectangles.size(); chunkBegin += 64)
+		{
+			const Rectangle *chunk = requestedRectangles.data() + chunkBegin;
+			std::vector<Point> *chunkAccumulators = accumulators.data() + chunkBegin;
+			unsigned chunkSize = std::min(64u, (unsigned) (requestedRectangles.size() - chunkBegin));
+			uint64_t allQueries = chunkSize == 64 ? ~uint64_t(0) : (uint64_t(1) << chunkSize) - 1;
+
+			context.push({this, allQueries});
+			for (;!context.empty();)
+			{
+				const Node *currentContext = context.top().first;
+				uint64_t activeQueries = context.top().second;
+				context.pop();
+
+				if (currentContext->isLeaf())
+				{
+					// Hand each data point to every active query containing it
+					for (const Point &dataPoint : currentContext->data)
+					{
+						for (uint64_t queries = activeQueries; queries != 0; queries &= queries - 1)
+						{
+							unsigned q = __builtin_ctzll(queries);
+							if (chunk[q].containsPoint(dataPoint))
+							{
+								chunkAccumulators[q].push_back(dataPoint);
+							}
+						}
+					}
+				}
+				else
+				{
+					// Follow each branch with only the queries that still intersect it
+					for (const Branch &branch : currentContext->branches)
+					{
+						uint64_t branchQueries = 0;
+						for (uint64_t queries = activeQueries; queries != 0; queries &= queries - 1)
+						{
+							unsigned q = __builtin_ctzll(queries);
+							if (branch.boundingPoly.intersectsRectangle(chunk[q]))
+							{
+								branchQueries |= uint64_t(1) << q;
+							}
+						}
+
+						if (branchQueries != 0)
+						{
+							context.push({branch.child, branchQueries});
+						}
+					}
+				}
+			}
+		}
+	}
+
 	// Always called on root, this = root
 	// This top-to-bottom sweep is only for adjusting bounding boxes to contain the point and
 	// choosing a particular leaf
@@ -360,7 +423,7 @@ namespace nirtree
 			{
 				// FL2 [Search leaf node for record]
 				// Check each entry to see if it matches E
-				for (Point &dataPoint : currentContext->data)
+				for (const Point &dataPoint : currentContext->data)
 				{
 					if (dataPoint == givenPoint)
 					{
@@ -386,45 +449,131 @@ namespace nirtree
 		return nullptr;
 	}
 
-	Node::Partition Node::partitionNode()
+	// Splits along the most variate dimension at the mean of the given points
+	static Node::Partition variancePartition(std::vector<Point>::const_iterator begin, std::vector<Point>::const_iterator end)
 	{
 		nirtree::Node::Partition defaultPartition;
-		unsigned costMetric = std::numeric_limits<unsigned>::max();
 		double totalMass = 0.0;
 
-		if (isLeaf())
+		// Setup variance values
+		Point variance = Point::atOrigin;
+		Point average = Point::atOrigin;
+		Point sumOfSquares = Point::atOrigin;
+
+		for (auto iter = begin; iter != end; ++iter)
 		{
-			// Setup variance values
-			Point variance = Point::atOrigin;
-			Point average = Point::atOrigin;
-			Point sumOfSquares = Point::atOrigin;
+			average += *iter;
+			sumOfSquares += *iter * *iter;
+			totalMass += 1.0;
+		}
+
+		// Compute final terms
+		average /= totalMass;
+		sumOfSquares /= totalMass;
 
-			for (Point &dataPoint : data)
+		// Compute final variance
+		variance = sumOfSquares - average * average;
+
+		// Choose most variate dimension
+		defaultPartition.dimension = 0;
+		for (unsigned d = 0; d < dimensions; ++d)
+		{
+			if (variance[d] > variance[defaultPartition.dimension])
 			{
-				average += dataPoint;
-				sumOfSquares += dataPoint * dataPoint;
-				totalMass += 1.0;
+				defaultPartition.dimension = d;
 			}
+		}
+		defaultPartition.location = average[defaultPartition.dimension];
+
+		return defaultPartition;
+	}
 
-			// Compute final terms
-			average /= totalMass;
-			sumOfSquares /= totalMass;
+	// Cuts [begin, end) into groupCount runs of near equal size. Each cut is made along the most
+	// variate dimension at the count median rather than the mean so runs are guaranteed to fit in
+	// their subtree. Runs only ever touch along a cut so their bounding boxes are disjoint.
+	static void partitionPoints(std::vector<Point>::iterator begin, std::vector<Point>::iterator end, unsigned groupCount, std::vector<std::vector<Point>::iterator> &groupEnds)
+	{
+		if (groupCount == 1)
+		{
+			groupEnds.push_back(end);
+			return;
+		}
 
-			// Compute final variance
-			variance = sumOfSquares - average * average;
+		unsigned dimension = variancePartition(begin, end).dimension;
+		unsigned leftGroupCount = groupCount / 2;
+		auto cut = begin + (unsigned) (((unsigned long) (end - begin) * leftGroupCount) / groupCount);
 
-			// Choose most variate dimension
-			defaultPartition.dimension = 0;
-			for (unsigned d = 0; d < dimensions; ++d)
-			{
-				if (variance[d] > variance[defaultPartition.dimension])
-				{
-					defaultPartition.dimension = d;
-				}
-			}
-			defaultPartition.location = average[defaultPartition.dimension];
+		std::nth_element(begin, cut, end, [dimension](const Point &a, const Point &b) { return a[dimension] < b[dimension]; });
 
-			return defaultPartition;
+		partitionPoints(begin, cut, leftGroupCount, groupEnds);
+		partitionPoints(cut, end, groupCount - leftGroupCount, groupEnds);
+	}
+
+	void Node::pack(std::vector<Point>::iterator begin, std::vector<Point>::iterator end, unsigned height)
+	{
+		unsigned long pointsCount = end - begin;
+
+		// Leaves just take their run of points
+		if (height == 0)
+		{
+			assert(pointsCount <= treeRef.maxBranchFactor);
+			data.assign(begin, end);
+			return;
+		}
+
+		// Use as few children as can hold our points while keeping every leaf at the same depth
+		unsigned long childCapacity = 1;
+		for (unsigned i = 0; i < height; ++i)
+		{
+			childCapacity *= treeRef.maxBranchFactor;
+		}
+		unsigned childCount = (unsigned) ((pointsCount + childCapacity - 1) / childCapacity);
+		assert(childCount <= treeRef.maxBranchFactor);
+
+		std::vector<std::vector<Point>::iterator> groupEnds;
+		partitionPoints(begin, end, childCount, groupEnds);
+
+		branches.reserve(childCount);
+		for (auto groupEnd : groupEnds)
+		{
+			Node *child = treeRef.nodeArena.create(treeRef, this);
+			child->pack(begin, groupEnd, height - 1);
+			branches.push_back({child, IsotheticPolygon(child->boundingBox()), child->subtreeCount()});
+			begin = groupEnd;
+		}
+	}
+
+	// Always called on an empty root, this = root
+	Node *Node::bulkLoad(std::vector<Point> &points)
+	{
+		assert(parent == nullptr && branches.empty() && data.empty());
+
+		if (points.empty())
+		{
+			return this;
+		}
+
+		// Smallest height that will hold every point
+		unsigned height = 0;
+		for (unsigned long capacity = treeRef.maxBranchFactor; capacity < points.size(); capacity *= treeRef.maxBranchFactor)
+		{
+			++height;
+		}
+
+		pack(points.begin(), points.end(), height);
+
+		return this;
+	}
+
+	Node::Partition Node::partitionNode()
+	{
+		nirtree::Node::Partition defaultPartition;
+		unsigned costMetric = std::numeric_limits<unsigned>::max();
+		double totalMass = 0.0;
+
+		if (isLeaf())
+		{
+			return variancePartition(data.begin(), data.end());
 		}
 		else
 		{
@@ -486,7 +635,7 @@ namespace nirtree
 			referencePoly = IsotheticPolygon(boundingBox());
 		}
 
-		SplitResult split = {{new Node(treeRef, minBranchFactor, maxBranchFactor, parent), referencePoly}, {new Node(treeRef, minBranchFactor, maxBranchFactor, parent), referencePoly}};
+		SplitResult split = {{treeRef.nodeArena.create(treeRef, parent), referencePoly}, {treeRef.nodeArena.create(treeRef, parent), referencePoly}};
 
 		split.leftBranch.boundingPoly.maxLimit(p.location, p.dimension);
 		split.rightBranch.boundingPoly.minLimit(p.location, p.dimension);
@@ -497,7 +646,7 @@ namespace nirtree
 		if (isLeaf())
 		{
 			bool containedLeft, containedRight;
-			for (Point &dataPoint : data)
+			for (const Point &dataPoint : data)
 			{
 				containedLeft = split.leftBranch.boundingPoly.containsPoint(dataPoint);
 				containedRight = split.rightBranch.boundingPoly.containsPoint(dataPoint);
@@ -542,7 +691,7 @@ namespace nirtree
 				{
 					Node::SplitResult downwardSplit = branch.child->splitNode(p);
 
-					delete branch.child;
+					treeRef.nodeArena.destroy(branch.child);
 
 					if (downwardSplit.leftBranch.child->data.size() > 0 || downwardSplit.leftBranch.child->branches.size() > 0)
 					{
@@ -560,6 +709,9 @@ namespace nirtree
 			branches.clear();
 		}
 
+		split.leftBranch.count = split.leftBranch.child->subtreeCount();
+		split.rightBranch.count = split.rightBranch.child->subtreeCount();
+
 		return split;
 	}
 
@@ -600,7 +752,7 @@ namespace nirtree
 			}
 
 			// Early exit if this node does not overflow
-			if (dataSize <= currentContext->maxBranchFactor && branchesSize <= currentContext->maxBranchFactor)
+			if (dataSize <= currentContext->treeRef.maxBranchFactor && branchesSize <= currentContext->treeRef.maxBranchFactor)
 			{
 				propagationSplit = {{nullptr, IsotheticPolygon()}, {nullptr, IsotheticPolygon()}};
 				break;
@@ -622,6 +774,83 @@ namespace nirtree
 		return propagationSplit;
 	}
 
+	// Best-first k nearest neighbour search, closest first
+	std::vector<Point> Node::nearest(const Point &givenPoint, unsigned k) const
+	{
+		std::vector<Point> neighbours;
+		NearestQueue<const Node *> queue;
+		queue.pushNode(0.0, this);
+
+		// Points only come off the queue once nothing closer can still be found
+		for (;!queue.empty() && neighbours.size() < k;)
+		{
+			NearestQueue<const Node *>::Entry entry = queue.pop();
+
+			if (entry.isPoint)
+			{
+				neighbours.push_back(entry.point);
+				continue;
+			}
+
+			const Node *currentContext = entry.node;
+
+			if (currentContext->isLeaf())
+			{
+				for (const Point &dataPoint : currentContext->data)
+				{
+					queue.pushPoint(dataPoint.distance(givenPoint), dataPoint);
+				}
+			}
+			else
+			{
+				for (const Branch &branch : currentContext->branches)
+				{
+					queue.pushNode(branch.boundingPoly.minDistance(givenPoint), branch.child);
+				}
+			}
+		}
+
+		return neighbours;
+	}
+
+	// Counts the points inside the rectangle. Branches whose polygon lies wholly inside it
+	// contribute their subtree count without being descended.
+	unsigned Node::count(const Rectangle &requestedRectangle) const
+	{
+		unsigned matchingPoints = 0;
+
+		std::vector<const Node *> &context = QueryContext<const Node>::local().stack;
+		size_t base = context.size();
+		context.push_back(this);
+
+		for (;context.size() > base;)
+		{
+			const Node *currentContext = context.back();
+			context.pop_back();
+
+			if (currentContext->isLeaf())
+			{
+				currentContext->data.forEachContained(requestedRectangle, [&matchingPoints](const Point &) { ++matchingPoints; });
+			}
+			else
+			{
+				for (const Branch &branch : currentContext->branches)
+				{
+					if (requestedRectangle.containsRectangle(branch.boundingPoly.boundingBox))
+					{
+						matchingPoints += branch.count;
+					}
+					else if (branch.boundingPoly.intersectsRectangle(requestedRectangle))
+					{
+						context.push_back(branch.child);
+					}
+				}
+			}
+		}
+
+		return matchingPoints;
+	}
+
 	// Always called on root, this = root
 	Node *Node::insert(Point givenPoint)
 	{
@@ -633,24 +862,22 @@ namespace nirtree
 		{
 			// Add just the data
 			adjustContext->data.push_back(givenPoint);
+			adjustContext->propagateCount(1);
 		}
 
-		// There is no guarantee that the root will still exist after adjustment so backup branch factors
-		unsigned backupMinBranchFactor = minBranchFactor;
-		unsigned backupMaxBranchFactor = maxBranchFactor;
 		Node::SplitResult finalSplit = adjustContext->adjustTree();
 
 		// Grow the tree taller if we need to
 		if (finalSplit.leftBranch.child != nullptr && finalSplit.rightBranch.child != nullptr)
 		{
-			Node *newRoot = new Node(treeRef, backupMinBranchFactor, backupMaxBranchFactor, nullptr);
+			Node *newRoot = treeRef.nodeArena.create(treeRef);
 
 			finalSplit.leftBranch.child->parent = newRoot;
 			newRoot->branches.push_back(finalSplit.leftBranch);
 			finalSplit.rightBranch.child->parent = newRoot;
 			newRoot->branches.push_back(finalSplit.rightBranch);
 
-			delete this;
+			treeRef.nodeArena.destroy(this);
 
 			return newRoot;
 		}
@@ -658,6 +885,46 @@ namespace nirtree
 		return this;
 	}
 
+	// Always called on root, this = root
+	Node *Node::insertBatch(const std::vector<Point> &points)
+	{
+		// IB1 [Order the batch along the Hilbert curve so consecutive points share leaves]
+		std::vector<Point> sortedPoints(points);
+		hilbert::sort(sortedPoints);
+
+		Node *root = this;
+		Node *leafHint = nullptr;
+		LeafHintPolicy policy;
+		IsotheticPolygon leafHintPoly;
+
+		for (const Point &point : sortedPoints)
+		{
+			// IB2 [Reuse the last leaf if its polygon covers the point and it has room]
+			// A covered point never reshapes polygons so there is nothing to propagate upward
+			if (leafHint != nullptr && leafHint->data.size() < leafHint->treeRef.maxBranchFactor && (leafHint->parent == nullptr || leafHintPoly.containsPoint(point)))
+			{
+				leafHint->data.push_back(point);
+				leafHint->propagateCount(1);
+				policy.hit();
+				continue;
+			}
+
+			// IB3 [Otherwise insert normally and refresh the hint unless hints keep going unused]
+			root = root->insert(point);
+			leafHint = nullptr;
+			if (policy.shouldRefresh())
+			{
+				leafHint = root->findLeaf(point);
+				if (leafHint->parent != nullptr)
+				{
+					leafHintPoly = leafHint->parent->locateBranch(leafHint).boundingPoly;
+				}
+			}
+		}
+
+		return root;
+	}
+
 	// To be called on a leaf
 	void Node::condenseTree()
 	{
@@ -700,7 +967,7 @@ namespace nirtree
 		if (branches.size() == 1)
 		{
 			Node *newRoot = branches[0].child;
-			delete this;
+			treeRef.nodeArena.destroy(this);
 			newRoot->parent = nullptr;
 			return newRoot;
 		}
@@ -708,13 +975,88 @@ namespace nirtree
 		return this;
 	}
 
+	// A node is its branch count followed by the polygons of its branches, each as its bounding
+	// box, rectangle count and rectangles, and then each child in turn, or for a leaf a branch
+	// count of zero followed by its point count and points. Branch counts are recomputed.
+	void Node::save(snapshot::Writer &writer) const
+	{
+		writer.write((uint32_t) branches.size());
+		if (branches.empty())
+		{
+			const std::vector<Point> &points = data;
+			writer.write((uint32_t) points.size());
+			writer.write(points.data(), points.size());
+			return;
+		}
+
+		for (const Branch &branch : branches)
+		{
+			const IsotheticPolygon &polygon = branch.boundingPoly;
+			writer.write(polygon.boundingBox);
+			writer.write((uint32_t) polygon.basicRectangles.size());
+			writer.write(polygon.basicRectangles.begin(), polygon.basicRectangles.size());
+		}
+		for (const Branch &branch : branches)
+		{
+			branch.child->save(writer);
+		}
+	}
+
+	// Always called on a fresh node
+	bool Node::load(snapshot::Reader &reader)
+	{
+		uint32_t branchCount;
+		if (!reader.read(branchCount))
+		{
+			return false;
+		}
+
+		if (branchCount == 0)
+		{
+			uint32_t dataCount;
+			std::vector<Point> points;
+			if (!reader.read(dataCount) || !reader.read(points, dataCount))
+			{
+				return false;
+			}
+			data.assign(points.begin(), points.end());
+
+			return true;
+		}
+
+		branches.resize(branchCount);
+		std::vector<Rectangle> rectangles;
+		for (Branch &branch : branches)
+		{
+			uint32_t rectangleCount;
+			if (!reader.read(branch.boundingPoly.boundingBox) || !reader.read(rectangleCount) || !reader.read(rectangles, rectangleCount))
+			{
+				return false;
+			}
+			branch.boundingPoly.basicRectangles.assign(rectangles.begin(), rectangles.end());
+			branch.child = nullptr;
+		}
+
+		for (Branch &branch : branches)
+		{
+			branch.child = treeRef.nodeArena.create(treeRef, this);
+			if (!branch.child->load(reader))
+			{
+				return false;
+			}
+			branch.count = branch.child->subtreeCount();
+		}
+
+		return true;
+	}
+
 	unsigned Node::checksum()
 	{
 		unsigned sum = 0;
 
 		if (isLeaf())
 		{
-			for (Point &dataPoint : data)
+			for (const Point &dataPoint : data)
 			{
 				for (unsigned d = 0; d < dimensions; ++d)
 				{
@@ -736,11 +1078,11 @@ namespace nirtree
 
 	bool Node::validate(Node *expectedParent, unsigned index)
 	{
-		if (parent != expectedParent || branches.size() > maxBranchFactor || data.size() > maxBranchFactor)
+		if (parent != expectedParent || branches.size() > treeRef.maxBranchFactor || data.size() > treeRef.maxBranchFactor)
 		{
 			std::cout << "node = " << (void *)this << std::endl;
 			std::cout << "parent = " << (void *)parent << " expectedParent = " << (void *)expectedParent << std::endl;
-			std::cout << "maxBranchFactor = " << maxBranchFactor << std::endl;
+			std::cout << "maxBranchFactor = " << treeRef.maxBranchFactor << std::endl;
 			std::cout << "branches.size() = " << branches.size() << std::endl;
 			std::cout << "data.size() = " << data.size() << std::endl;
 			assert(parent == expectedParent);
@@ -748,7 +1090,7 @@ namespace nirtree
 
 		if (expectedParent != nullptr)
 		{
-			for (Point &dataPoint : data)
+			for (const Point &dataPoint : data)
 			{
 				if (!parent->branches[index].boundingPoly.containsPoint(dataPoint))
 				{
@@ -793,7 +1135,7 @@ namespace nirtree
 			std::cout << indendtation << "		" << branch.boundingPoly << std::endl;
 		}
 		std::cout << indendtation << "    Data: ";
-		for (Point &dataPoint : data)
+		for (const Point &dataPoint : data)
 		{
 			std::cout << dataPoint;
 		}
@@ -857,7 +1199,7 @@ namespace nirtree
 		std::vector<unsigned long> histogramPolygon;
 		histogramPolygon.resize(10000, 0);
 		std::vector<unsigned long> histogramFanout;
-		histogramFanout.resize(maxBranchFactor, 0);
+		histogramFanout.resize(treeRef.maxBranchFactor, 0);
 
 		double coverage = 0.0;
 
@@ -900,6 +1242,7 @@ namespace nirtree
 					polygonSize = currentContext->branches[i].boundingPoly.basicRectangles.size();
 					++histogramPolygon[polygonSize];
 					totalPolygonSize += polygonSize;
+					memoryFootprint += currentContext->branches[i].boundingPoly.basicRectangles.heapBytes();
 
 					for (Rectangle r : currentContext->branches[i].boundingPoly.basicRectangles)
 					{
@@ -917,6 +1260,7 @@ namespace nirtree
 		// Print out what we have found
 		STATEXEC(std::cout << "### Statistics ###" << std::endl);
 		STATMEM(memoryFootprint);
+		STATARENA(treeRef.nodeArena.bytes(), treeRef.nodeArena.liveNodes());
 		STATHEIGHT(height());
 		STATSIZE(totalNodes);
 		STATSINGULAR(singularBranches);
@@ -15,19 +15,7 @@ namespace quadtree
 		}
 	}
 
-	void Node::deleteSubtrees()
-	{
-		for (Node *branch : branches)
-		{
-			if (branch != nullptr)
-			{
-				branch->deleteSubtrees();
-				delete branch;
-			}
-		}
-	}
-
-	unsigned Node::nextBranch(Point &givenPoint)
+	unsigned Node::nextBranch(const Point &givenPoint) const
 	{
 		unsigned branchIndex = 0;
 
@@ -42,7 +30,7 @@ namespace quadtree
 		return branchIndex;
 	}
 
-	std::vector<unsigned> Node::nextBranch(Rectangle &givenRectangle)
+	std::vector<unsigned> Node::nextBranch(const Rectangle &givenRectangle) const
 	{
 		std::vector<unsigned> nextIndexes;
 
@@ -76,7 +64,7 @@ namespace quadtree
 		return nextIndexes;
 	}
 
-	bool Node::isLeaf()
+	bool Node::isLeaf() const
 	{
 		for (Node *branch : branches)
 		{
@@ -109,14 +97,14 @@ namespace quadtree
 		}
 	}
 
-	std::vector<Point> Node::search(Point &requestedPoint)
+	std::vector<Point> Node::search(const Point &requestedPoint) const
 	{
 		std::vector<Point> accumulator;
 
 		// Initialize our context stack
-		std::stack<Node *> context;
+		std::stack<const Node *> context;
 		context.push(this);
-		Node *currentContext;
+		const Node *currentContext;
 
 		for (;!context.empty();)
 		{
@@ -156,14 +144,14 @@ namespace quadtree
 		return accumulator;
 	}
 
-	std::vector<Point> Node::search(Rectangle &requestedRectangle)
+	std::vector<Point> Node::search(const Rectangle &requestedRectangle) const
 	{
 		std::vector<Point> accumulator;
 
 		// Initialize our context stack
-		std::stack<Node *> context;
+		std::stack<const Node *> context;
 		context.push(this);
-		Node *currentContext;
+		const Node *currentContext;
 
 		for (;!context.empty();)
 		{
@@ -203,6 +191,58 @@ namespace quadtree
 		return accumulator;
 	}
 
+	// Best-first k nearest neighbour search, closest first. Quadrants have no stored bounds so
+	// each node travels through the queue with the region implied by its ancestors.
+	std::vector<Point> Node::nearest(const Point &givenPoint, unsigned k) const
+	{
+		std::vector<Point> neighbours;
+		NearestQueue<std::pair<const Node *, Rectangle>> queue;
+		queue.pushNode(0.0, {this, Rectangle(Point::atNegInfinity, Point::atInfinity)});
+
+		// Points only come off the queue once nothing closer can still be found
+		for (;!queue.empty() && neighbours.size() < k;)
+		{
+			NearestQueue<std::pair<const Node *, Rectangle>>::Entry entry = queue.pop();
+
+			if (entry.isPoint)
+			{
+				neighbours.push_back(entry.point);
+				continue;
+			}
+
+			const Node *currentContext = entry.node.first;
+			const Rectangle &region = entry.node.second;
+
+			queue.pushPoint(currentContext->data.distance(givenPoint), currentContext->data);
+
+			// Bit d of the quadrant number picks the upper half of the region in dimension d
+			for (unsigned i = 0; i < currentContext->branches.size(); ++i)
+			{
+				if (currentContext->branches[i] == nullptr)
+				{
+					continue;
+				}
+
+				Rectangle quadrant = region;
+				for (unsigned d = 0; d < dimensions; ++d)
+				{
+					if ((1 << d) & i)
+					{
+						quadrant.lowerLeft[d] = currentContext->data[d];
+					}
+					else
+					{
+						quadrant.upperRight[d] = currentContext->data[d];
+					}
+				}
+
+				queue.pushNode(quadrant.minDistance(givenPoint), {currentContext->branches[i], quadrant});
+			}
+		}
+
+		return neighbours;
+	}
+
 	// Always called on root, this = root
 	void Node::insert(Point givenPoint)
 	{
@@ -220,7 +260,7 @@ namespace quadtree
 
 			if (currentContext->branches[nextIndex] == nullptr)
 			{
-				currentContext->branches[nextIndex] = new Node(treeRef, givenPoint, currentContext);
+				currentContext->branches[nextIndex] = treeRef.nodeArena.create(treeRef, givenPoint, currentContext);
 				break;
 			}
 			else
@@ -235,6 +275,48 @@ namespace quadtree
 		// Quadtrees don't support deletion!
 	}
 
+	// A node is its point followed by whether each quadrant holds a child and then each child in
+	// turn
+	void Node::save(snapshot::Writer &writer) const
+	{
+		writer.write(data);
+		for (const Node *branch : branches)
+		{
+			writer.write((uint8_t) (branch != nullptr));
+		}
+		for (const Node *branch : branches)
+		{
+			if (branch != nullptr)
+			{
+				branch->save(writer);
+			}
+		}
+	}
+
+	// Always called on a fresh node
+	bool Node::load(snapshot::Reader &reader)
+	{
+		std::vector<uint8_t> present;
+		if (!reader.read(data) || !reader.read(present, branches.size()))
+		{
+			return false;
+		}
+
+		for (unsigned i = 0; i < branches.size(); ++i)
+		{
+			if (present[i])
+			{
+				branches[i] = treeRef.nodeArena.create(treeRef, data, this);
+				if (!branches[i]->load(reader))
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
 	unsigned Node::checksum()
 	{
 		unsigned sum = 0;
@@ -359,6 +441,7 @@ namespace quadtree
 		// Print out what we have found
 		STATEXEC(std::cout << "### Statistics ###" << std::endl);
 		STATMEM(memoryFootprint);
+		STATARENA(treeRef.nodeArena.bytes(), treeRef.nodeArena.liveNodes());
 		STATHEIGHT(height());
 		STATSINGULAR(singularBranches);
 		STATLEAF(totalLeaves);
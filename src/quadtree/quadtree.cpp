@@ -21,8 +21,7 @@ namespace quadtree
 
 	QuadTree::~QuadTree()
 	{
-		root->deleteSubtrees();
-		delete root;
+		// The node arena tears every node down in one sweep
 	}
 
 	std::vector<Point> QuadTree::exhaustiveSearch(Point requestedPoint)
@@ -33,18 +32,36 @@ namespace quadtree
 		return v;
 	}
 
-	std::vector<Point> QuadTree::search(Point requestedPoint) CONST_IF_NOT_STAT
+	std::vector<Point> QuadTree::search(Point requestedPoint) const
 	{
+		ALLOCSCOPE(allocationProfile, Search);
 		return root->search(requestedPoint);
 	}
 
-	std::vector<Point> QuadTree::search(Rectangle requestedRectangle) CONST_IF_NOT_STAT
+	std::vector<Point> QuadTree::search(Rectangle requestedRectangle) const
 	{
+		ALLOCSCOPE(allocationProfile, RangeSearch);
 		return root->search(requestedRectangle);
 	}
 
+	void QuadTree::searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const
+	{
+		search(requestedRectangle, [visit, visitor](const Point &p) { visit(visitor, p); });
+	}
+
+	std::vector<Point> QuadTree::nearest(const Point &givenPoint, unsigned k) const
+	{
+		if (root == nullptr)
+		{
+			return {};
+		}
+
+		return root->nearest(givenPoint, k);
+	}
+
 	void QuadTree::insert(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Insert);
 		// Root special case
 		if (root != nullptr)
 		{
@@ -52,15 +69,139 @@ namespace quadtree
 		}
 		else
 		{
-			root = new Node(*this, givenPoint);
+			root = nodeArena.create(*this, givenPoint);
+		}
+	}
+
+	// Regions along an insertion path are open below and closed above to match nextBranch
+	static bool regionContainsPoint(const Rectangle &region, const Point &givenPoint)
+	{
+		for (unsigned d = 0; d < dimensions; ++d)
+		{
+			if (givenPoint[d] <= region.lowerLeft[d] || region.upperRight[d] < givenPoint[d])
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// The batch is not presorted here. A point quadtree takes its shape from insertion order and
+	// sorted input degenerates it into long chains, so only the insertion path is reused.
+	void QuadTree::insertBatch(const std::vector<Point> &points)
+	{
+		// The last insertion path along with the region each node on it covers
+		std::vector<std::pair<Node *, Rectangle>> path;
+
+		for (Point point : points)
+		{
+			// Root special case
+			if (root == nullptr)
+			{
+				root = nodeArena.create(*this, point);
+				continue;
+			}
+
+			if (path.empty())
+			{
+				path.emplace_back(root, Rectangle(Point::atNegInfinity, Point::atInfinity));
+			}
+
+			// QB1 [Back up to the deepest node on the last path whose region holds the point]
+			while (!regionContainsPoint(path.back().second, point))
+			{
+				path.pop_back();
+			}
+
+			// QB2 [Descend from there as a regular insert would]
+			for (;;)
+			{
+				Node *node = path.back().first;
+				unsigned nextIndex = node->nextBranch(point);
+
+				Rectangle region = path.back().second;
+				for (unsigned d = 0; d < dimensions; ++d)
+				{
+					if ((nextIndex >> d) & 1)
+					{
+						region.lowerLeft[d] = node->data[d];
+					}
+					else
+					{
+						region.upperRight[d] = node->data[d];
+					}
+				}
+
+				bool placed = node->branches[nextIndex] == nullptr;
+				if (placed)
+				{
+					node->branches[nextIndex] = nodeArena.create(*this, point, node);
+				}
+				path.emplace_back(node->branches[nextIndex], region);
+
+				if (placed)
+				{
+					break;
+				}
+			}
 		}
 	}
 
 	void QuadTree::remove(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Remove);
 		root->remove(givenPoint);
 	}
 
+	// Quadtrees have no branch factors and may have no root so the nodes follow whether there is one
+	bool QuadTree::save(const std::string &path) const
+	{
+		snapshot::Writer writer(path);
+		snapshot::writeHeader(writer, snapshot::QuadTreeTag, 0, 0);
+		writer.write((uint8_t) (root != nullptr));
+		if (root != nullptr)
+		{
+			root->save(writer);
+		}
+
+		return writer.close();
+	}
+
+	bool QuadTree::load(const std::string &path)
+	{
+		snapshot::Reader reader(path);
+		nodeArena.clear();
+		root = nullptr;
+
+		uint8_t hasRoot;
+		if (!snapshot::readHeader(reader, snapshot::QuadTreeTag, 0, 0) || !reader.read(hasRoot))
+		{
+			return false;
+		}
+
+		if (hasRoot)
+		{
+			Point origin = Point::atOrigin;
+			root = nodeArena.create(*this, origin);
+			if (!root->load(reader))
+			{
+				nodeArena.clear();
+				root = nullptr;
+				return false;
+			}
+		}
+
+		if (!reader.atEnd())
+		{
+			nodeArena.clear();
+			root = nullptr;
+			return false;
+		}
+
+		return true;
+	}
+
 	unsigned QuadTree::checksum()
 	{
 		return root->checksum();
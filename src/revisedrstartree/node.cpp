@@ -9,23 +9,7 @@ namespace revisedrstartree
 		originalCentre = Point::atOrigin;
 	}
 
-	void Node::deleteSubtrees()
-	{
-		if (branches.size() == 0)
-		{
-			return;
-		}
-		else
-		{
-			for (Branch &branch : branches)
-			{
-				branch.child->deleteSubtrees();
-				delete branch.child;
-			}
-		}
-	}
-
-	bool Node::isLeaf()
+	bool Node::isLeaf() const
 	{
 		if (branches.size() == 0 && data.size() >= 0)
 		{
@@ -74,9 +58,8 @@ namespace revisedrstartree
 		for (childIndex = 0; branches[childIndex].child != child && childIndex < branchesSize; ++childIndex) {}
 
 		// Delete the child by deleting it and overwriting its branch
-		delete child;
-		branches[childIndex] = branches.back();
-		branches.pop_back();
+		treeRef.nodeArena.destroy(child);
+		branches.removeAt(childIndex);
 	}
 
 	void Node::removeData(Point givenPoint)
@@ -108,7 +91,7 @@ namespace revisedrstartree
 		else
 		{
 			// Determine which branches we need to follow
-			for (Branch &branch : branches)
+			for (const Branch &branch : branches)
 			{
 				// Recurse
 				branch.child->exhaustiveSearch(requestedPoint, accumulator);
@@ -116,14 +99,14 @@ namespace revisedrstartree
 		}
 	}
 
-	std::vector<Point> Node::search(Point &requestedPoint)
+	std::vector<Point> Node::search(const Point &requestedPoint) const
 	{
 		std::vector<Point> accumulator;
 
 		// Initialize our context stack
-		std::stack<Node *> context;
+		std::stack<const Node *> context;
 		context.push(this);
-		Node *currentContext;
+		const Node *currentContext;
 
 		for (;!context.empty();)
 		{
@@ -133,7 +116,7 @@ namespace revisedrstartree
 			if (currentContext->isLeaf())
 			{
 				// We are a leaf so add our data points when they are the search point
-				for (Point &dataPoint : currentContext->data)
+				for (const Point &dataPoint : currentContext->data)
 				{
 					if (requestedPoint == dataPoint)
 					{
@@ -147,14 +130,11 @@ namespace revisedrstartree
 			else
 			{
 				// Determine which branches we need to follow
-				for (Branch &branch : currentContext->branches)
+				currentContext->branches.forEachContaining(requestedPoint, [&](size_t i)
 				{
-					if (branch.boundingBox.containsPoint(requestedPoint))
-					{
-						// Add to the nodes we will check
-						context.push(branch.child);
-					}
-				}
+					// Add to the nodes we will check
+					context.push(currentContext->branches[i].child);
+				});
 #ifdef STAT
 				treeRef.stats.markNonLeafNodeSearched();
 #endif
@@ -168,14 +148,14 @@ namespace revisedrstartree
 		return accumulator;
 	}
 
-	std::vector<Point> Node::search(Rectangle &requestedRectangle)
+	std::vector<Point> Node::search(const Rectangle &requestedRectangle) const
 	{
 		std::vector<Point> accumulator;
 
 		// Initialize our context stack
-		std::stack<Node *> context;
+		std::stack<const Node *> context;
 		context.push(this);
-		Node *currentContext;
+		const Node *currentContext;
 
 		for (;!context.empty();)
 		{
@@ -185,7 +165,7 @@ namespace revisedrstartree
 			if (currentContext->isLeaf())
 			{
 				// We are a leaf so add our data points when they are within the search rectangle
-				for (Point &dataPoint : currentContext->data)
+				for (const Point &dataPoint : currentContext->data)
 				{
 					if (requestedRectangle.containsPoint(dataPoint))
 					{
@@ -200,14 +180,11 @@ namespace revisedrstartree
 			else
 			{
 				// Determine which branches we need to follow
-				for (Branch &branch : currentContext->branches)
+				currentContext->branches.forEachIntersecting(requestedRectangle, [&](size_t i)
 				{
-					if (branch.boundingBox.intersectsRectangle(requestedRectangle))
-					{
-						// Add to the nodes we will check
-						context.push(branch.child);
-					}
-				}
+					// Add to the nodes we will check
+					context.push(currentContext->branches[i].child);
+				});
 #ifdef STAT
 				treeRef.stats.markNonLeafNodeSearched();
 #endif
@@ -220,6 +197,68 @@ namespace revisedrstartree
 		return accumulator;
 	}
 
+	// Answers many range queries in one traversal. Queries are taken 64 at a time and every node
+	// on the stack carries a mask of the queries still intersecting it, so upper levels are visited
+	// once per chunk instead of once per query.
+	void Node::searchBatch(const std::vector<Rectangle> &requestedRectangles, std::vector<std::vector<Point>> &accumulators) const
+	{
+		// Initialize our context stack
+		std::stack<std::pair<const Node *, uint64_t>> context;
+
+		for (unsigned chunkBegin = 0; chunkBegin < requestedRectangles.size(); chunkBegin += 64)
+		{
+			const Rectangle *chunk = requestedRectangles.data() + chunkBegin;
+			std::vector<Point> *chunkAccumulators = accumulators.data() + chunkBegin;
+			unsigned chunkSize = std::min(64u, (unsigned) (requestedRectangles.size() - chunkBegin));
+			uint64_t allQueries = chunkSize == 64 ? ~uint64_t(0) : (uint64_t(1) << chunkSize) - 1;
+
+			context.push({this, allQueries});
+			for (;!context.empty();)
+			{
+				const Node *currentContext = context.top().first;
+				uint64_t activeQueries = context.top().second;
+				context.pop();
+
+				if (currentContext->isLeaf())
+				{
+					// Hand each data point to every active query containing it
+					for (const Point &dataPoint : currentContext->data)
+					{
+						for (uint64_t queries = activeQueries; queries != 0; queries &= queries - 1)
+						{
+							unsigned q = __builtin_ctzll(queries);
+							if (chunk[q].containsPoint(dataPoint))
+							{
+								chunkAccumulators[q].push_back(dataPoint);
+							}
+						}
+					}
+				}
+				else
+				{
+					// Follow each branch with only the queries that still intersect it
+					for (const Branch &branch : currentContext->branches)
+					{
+						uint64_t branchQueries = 0;
+						for (uint64_t queries = activeQueries; queries != 0; queries &= queries - 1)
+						{
+							unsigned q = __builtin_ctzll(queries);
+							if (branch.boundingBox.intersectsRectangle(chunk[q]))
+							{
+								branchQueries |= uint64_t(1) << q;
+							}
+						}
+
+						if (branchQueries != 0)
+						{
+							context.push({branch.child, branchQueries});
+						}
+					}
+				}
+			}
+		}
+	}
+
 	void Node::chooseNodeHelper(unsigned limitIndex, Point &givenPoint, unsigned &chosenIndex, bool &success, std::vector<bool> &candidates, std::vector<double> &deltas, unsigned startIndex, bool useMarginDelta)
 	{
 		candidates[startIndex] = true;
@@ -317,11 +356,11 @@ namespace revisedrstartree
 				else
 				{
 					// Sort the entries in ascending order of their margin delta
-					std::sort(context->branches.begin(), context->branches.end(), [givenPoint](Branch &a, Branch &b){return a.boundingBox.computeExpansionMargin(givenPoint) <= b.boundingBox.computeExpansionMargin(givenPoint);});
+					context->branches.sort([givenPoint](const Branch &a, const Branch &b){return a.boundingBox.computeExpansionMargin(givenPoint) <= b.boundingBox.computeExpansionMargin(givenPoint);});
 
 					// Look at the first entry's intersection margin with all the others
 					double deltaWithAll = 0.0;
-					for (Branch &branch : context->branches)
+					for (const Branch &branch : context->branches)
 					{
 						deltaWithAll += branch.boundingBox.marginDelta(givenPoint, context->branches[0].boundingBox);
 					}
@@ -389,7 +428,9 @@ namespace revisedrstartree
 				}
 
 				// Descend
-				context->branches[optimalBranchIndex].boundingBox.expand(givenPoint);
+				Rectangle expandedBoundingBox = context->branches[optimalBranchIndex].boundingBox;
+				expandedBoundingBox.expand(givenPoint);
+				context->branches.setBoundingBox(optimalBranchIndex, expandedBoundingBox);
 				context = context->branches[optimalBranchIndex].child;
 			}
 		}
@@ -423,14 +464,11 @@ namespace revisedrstartree
 			{
 				// FL1 [Search subtrees]
 				// Determine which branches we need to follow
-				for (Branch &branch : currentContext->branches)
+				currentContext->branches.forEachContaining(givenPoint, [&](size_t i)
 				{
-					if (branch.boundingBox.containsPoint(givenPoint))
-					{
-						// Add the child to the nodes we will consider
-						context.push(branch.child);
-					}
-				}
+					// Add the child to the nodes we will consider
+					context.push(currentContext->branches[i].child);
+				});
 			}
 		}
 
@@ -505,7 +543,7 @@ namespace revisedrstartree
 			{
 				// Sort twice for routing
 				// Lower left ordering
-				std::sort(branches.begin(), branches.end(), [d](Branch &a, Branch &b){return a.boundingBox.lowerLeft[d] < b.boundingBox.lowerLeft[d];});
+				branches.sort([d](const Branch &a, const Branch &b){return a.boundingBox.lowerLeft[d] < b.boundingBox.lowerLeft[d];});
 				for (unsigned i = treeRef.minBranchFactor; i < 1 + treeRef.maxBranchFactor - treeRef.minBranchFactor; ++i)
 				{
 					double evalMargin = evaluateSplit(i, [](Rectangle &a, Rectangle &b){return a.margin() + b.margin();});
@@ -518,7 +556,7 @@ namespace revisedrstartree
 				}
 
 				// Upper right ordering
-				std::sort(branches.begin(), branches.end(), [d](Branch &a, Branch &b){return a.boundingBox.upperRight[d] < b.boundingBox.upperRight[d];});
+				branches.sort([d](const Branch &a, const Branch &b){return a.boundingBox.upperRight[d] < b.boundingBox.upperRight[d];});
 				for (unsigned i = treeRef.minBranchFactor; i < 1 + treeRef.maxBranchFactor - treeRef.minBranchFactor; ++i)
 				{
 					double evalMargin = evaluateSplit(i, [](Rectangle &a, Rectangle &b){return a.margin() + b.margin();});
@@ -539,11 +577,11 @@ namespace revisedrstartree
 		}
 		else if (minSort)
 		{
-			std::sort(branches.begin(), branches.end(), [axis](Branch &a, Branch &b){return a.boundingBox.lowerLeft[axis] < b.boundingBox.lowerLeft[axis];});
+			branches.sort([axis](const Branch &a, const Branch &b){return a.boundingBox.lowerLeft[axis] < b.boundingBox.lowerLeft[axis];});
 		}
 		else
 		{
-			std::sort(branches.begin(), branches.end(), [axis](Branch &a, Branch &b){return a.boundingBox.upperRight[axis] < b.boundingBox.upperRight[axis];});
+			branches.sort([axis](const Branch &a, const Branch &b){return a.boundingBox.upperRight[axis] < b.boundingBox.upperRight[axis];});
 		}
 
 		return axis;
@@ -605,7 +643,7 @@ namespace revisedrstartree
 	// Splitting a node will remove it from its parent node and its memory will be freed
 	Node::SplitResult Node::splitNode()
 	{
-		SplitResult split = {{new Node(treeRef, parent), Rectangle::atOrigin}, {new Node(treeRef, parent), Rectangle::atOrigin}};
+		SplitResult split = {{treeRef.nodeArena.create(treeRef, parent), Rectangle::atOrigin}, {treeRef.nodeArena.create(treeRef, parent), Rectangle::atOrigin}};
 
 		unsigned splitIndex = chooseSplitIndex(chooseSplitAxis());
 
@@ -703,6 +741,45 @@ namespace revisedrstartree
 		return propagationSplit;
 	}
 
+	// Best-first k nearest neighbour search, closest first
+	std::vector<Point> Node::nearest(const Point &givenPoint, unsigned k) const
+	{
+		std::vector<Point> neighbours;
+		NearestQueue<const Node *> queue;
+		queue.pushNode(0.0, this);
+
+		// Points only come off the queue once nothing closer can still be found
+		for (;!queue.empty() && neighbours.size() < k;)
+		{
+			NearestQueue<const Node *>::Entry entry = queue.pop();
+
+			if (entry.isPoint)
+			{
+				neighbours.push_back(entry.point);
+				continue;
+			}
+
+			const Node *currentContext = entry.node;
+
+			if (currentContext->isLeaf())
+			{
+				for (const Point &dataPoint : currentContext->data)
+				{
+					queue.pushPoint(dataPoint.distance(givenPoint), dataPoint);
+				}
+			}
+			else
+			{
+				for (const Branch &branch : currentContext->branches)
+				{
+					queue.pushNode(branch.boundingBox.minDistance(givenPoint), branch.child);
+				}
+			}
+		}
+
+		return neighbours;
+	}
+
 	// Always called on root, this = root
 	Node *Node::insert(Point givenPoint)
 	{
@@ -721,14 +798,14 @@ namespace revisedrstartree
 		// Grow the tree taller if we need to
 		if (finalSplit.leftBranch.child != nullptr && finalSplit.rightBranch.child != nullptr)
 		{
-			Node *newRoot = new Node(treeRef);
+			Node *newRoot = treeRef.nodeArena.create(treeRef);
 
 			finalSplit.leftBranch.child->parent = newRoot;
 			newRoot->branches.push_back(finalSplit.leftBranch);
 			finalSplit.rightBranch.child->parent = newRoot;
 			newRoot->branches.push_back(finalSplit.rightBranch);
 
-			delete this;
+			treeRef.nodeArena.destroy(this);
 
 			return newRoot;
 		}
@@ -778,7 +855,7 @@ namespace revisedrstartree
 		if (branches.size() == 1)
 		{
 			Node *newRoot = branches[0].child;
-			delete this;
+			treeRef.nodeArena.destroy(this);
 			newRoot->parent = nullptr;
 			return newRoot;
 		}
@@ -786,6 +863,65 @@ namespace revisedrstartree
 		return this;
 	}
 
+	// A node is the centre it was split around and its branch count followed by the boxes of its branches and then each child in
+	// turn, or for a leaf a branch count of zero followed by its point count and points
+	void Node::save(snapshot::Writer &writer) const
+	{
+		writer.write(originalCentre);
+		writer.write((uint32_t) branches.size());
+		if (branches.empty())
+		{
+			writer.write((uint32_t) data.size());
+			writer.write(data.data(), data.size());
+			return;
+		}
+
+		for (const Branch &branch : branches)
+		{
+			writer.write(branch.boundingBox);
+		}
+		for (const Branch &branch : branches)
+		{
+			branch.child->save(writer);
+		}
+	}
+
+	// Always called on a fresh node
+	bool Node::load(snapshot::Reader &reader)
+	{
+		uint32_t branchCount;
+		if (!reader.read(originalCentre) || !reader.read(branchCount))
+		{
+			return false;
+		}
+
+		if (branchCount == 0)
+		{
+			uint32_t dataCount;
+			return reader.read(dataCount) && reader.read(data, dataCount);
+		}
+
+		std::vector<Rectangle> childBoxes;
+		if (!reader.read(childBoxes, branchCount))
+		{
+			return false;
+		}
+
+		std::vector<Branch> loadedBranches;
+		loadedBranches.reserve(branchCount);
+		for (const Rectangle &childBox : childBoxes)
+		{
+			loadedBranches.push_back({treeRef.nodeArena.create(treeRef, this), childBox});
+			if (!loadedBranches.back().child->load(reader))
+			{
+				return false;
+			}
+		}
+		branches.assign(loadedBranches);
+
+		return true;
+	}
+
 	unsigned Node::checksum()
 	{
 		unsigned sum = 0;
@@ -802,7 +938,7 @@ namespace revisedrstartree
 		}
 		else
 		{
-			for (Branch &branch : branches)
+			for (const Branch &branch : branches)
 			{
 				// Recurse
 				sum += branch.child->checksum();
@@ -839,7 +975,7 @@ namespace revisedrstartree
 		std::cout << indendtation << "Node " << (void *)this << std::endl;
 		std::cout << indendtation << "    Parent: " << (void *)parent << std::endl;
 		std::cout << indendtation << "    Branches: " << std::endl;
-		for (Branch &branch : branches)
+		for (const Branch &branch : branches)
 		{
 			std::cout << indendtation << "		" << (void *)branch.child << std::endl;
 			std::cout << indendtation << "		" << branch.boundingBox << std::endl;
@@ -861,7 +997,7 @@ namespace revisedrstartree
 		std::string indendtation(n * 4, ' ');
 		if (!isLeaf())
 		{
-			for (Branch &branch : branches)
+			for (const Branch &branch : branches)
 			{
 				// Recurse
 				branch.child->printTree(n + 1);
@@ -944,7 +1080,7 @@ namespace revisedrstartree
 			else
 			{
 				totalNodes += branchesSize;
-				memoryFootprint += sizeof(Node) + branchesSize * sizeof(Node::Branch);
+				memoryFootprint += sizeof(Node) + branchesSize * sizeof(Node::Branch) + currentContext->branches.packedBytes();
 				for (unsigned i = 0; i < branchesSize; ++i)
 				{
 					if (currentContext->branches[i].child->branches.size() == 1 || currentContext->branches[i].child->data.size() == 1)
@@ -960,6 +1096,7 @@ namespace revisedrstartree
 		// Print out what we have found
 		STATEXEC(std::cout << "### Statistics ###" << std::endl);
 		STATMEM(memoryFootprint);
+		STATARENA(treeRef.nodeArena.bytes(), treeRef.nodeArena.liveNodes());
 		STATHEIGHT(height());
 		STATSIZE(totalNodes);
 		STATSINGULAR(singularBranches);
@@ -4,13 +4,12 @@ namespace revisedrstartree
 {
 	RevisedRStarTree::RevisedRStarTree(unsigned minBranchFactor, unsigned maxBranchFactor) : minBranchFactor(minBranchFactor), maxBranchFactor(maxBranchFactor)
 	{
-		root = new Node(*this);
+		root = nodeArena.create(*this);
 	}
 
 	RevisedRStarTree::~RevisedRStarTree()
 	{
-		root->deleteSubtrees();
-		delete root;
+		// The node arena tears every node down in one sweep
 	}
 
 	std::vector<Point> RevisedRStarTree::exhaustiveSearch(Point requestedPoint)
@@ -21,26 +20,105 @@ namespace revisedrstartree
 		return v;
 	}
 
-	std::vector<Point> RevisedRStarTree::search(Point requestedPoint) CONST_IF_NOT_STAT
+	std::vector<Point> RevisedRStarTree::search(Point requestedPoint) const
 	{
+		ALLOCSCOPE(allocationProfile, Search);
 		return root->search(requestedPoint);
 	}
 
-	std::vector<Point> RevisedRStarTree::search(Rectangle requestedRectangle) CONST_IF_NOT_STAT
+	std::vector<Point> RevisedRStarTree::search(Rectangle requestedRectangle) const
 	{
+		ALLOCSCOPE(allocationProfile, RangeSearch);
 		return root->search(requestedRectangle);
 	}
 
+	void RevisedRStarTree::searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const
+	{
+		search(requestedRectangle, [visit, visitor](const Point &p) { visit(visitor, p); });
+	}
+
+	std::vector<Point> RevisedRStarTree::nearest(const Point &givenPoint, unsigned k) const
+	{
+		return root->nearest(givenPoint, k);
+	}
+
+	std::vector<std::vector<Point>> RevisedRStarTree::searchBatch(const std::vector<Rectangle> &requestedRectangles) const
+	{
+		std::vector<std::vector<Point>> accumulators(requestedRectangles.size());
+		root->searchBatch(requestedRectangles, accumulators);
+
+		return accumulators;
+	}
+
 	void RevisedRStarTree::insert(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Insert);
 		root = root->insert(givenPoint);
 	}
 
+	void RevisedRStarTree::insertBatch(const std::vector<Point> &points)
+	{
+		// IB1 [Order the batch along the Hilbert curve so consecutive points share leaves]
+		std::vector<Point> sortedPoints(points);
+		hilbert::sort(sortedPoints);
+
+		Node *leafHint = nullptr;
+		LeafHintPolicy policy;
+		Rectangle leafHintBox;
+
+		for (const Point &point : sortedPoints)
+		{
+			// IB2 [Reuse the last leaf if it covers the point and has room]
+			// No bounding box changes so there is nothing to propagate upward
+			if (leafHint != nullptr && leafHint->data.size() < maxBranchFactor && leafHintBox.containsPoint(point))
+			{
+				leafHint->data.push_back(point);
+				policy.hit();
+				continue;
+			}
+
+			// IB3 [Otherwise insert normally and refresh the hint unless hints keep going unused]
+			insert(point);
+			leafHint = nullptr;
+			if (policy.shouldRefresh())
+			{
+				leafHint = root->findLeaf(point);
+				leafHintBox = leafHint->boundingBox();
+			}
+		}
+	}
+
 	void RevisedRStarTree::remove(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Remove);
 		root = root->remove(givenPoint);
 	}
 
+	bool RevisedRStarTree::save(const std::string &path) const
+	{
+		snapshot::Writer writer(path);
+		snapshot::writeHeader(writer, snapshot::RevisedRStarTreeTag, minBranchFactor, maxBranchFactor);
+		root->save(writer);
+
+		return writer.close();
+	}
+
+	bool RevisedRStarTree::load(const std::string &path)
+	{
+		snapshot::Reader reader(path);
+		nodeArena.clear();
+		root = nodeArena.create(*this);
+
+		if (!snapshot::readHeader(reader, snapshot::RevisedRStarTreeTag, minBranchFactor, maxBranchFactor) || !root->load(reader) || !reader.atEnd())
+		{
+			nodeArena.clear();
+			root = nodeArena.create(*this);
+			return false;
+		}
+
+		return true;
+	}
+
 	unsigned RevisedRStarTree::checksum()
 	{
 		return root->checksum();
@@ -3,39 +3,12 @@
 
 namespace rplustree
 {
-	Node::Node(RPlusTree &treeRef) :
+	Node::Node(RPlusTree &treeRef, Node *p) :
 		treeRef(treeRef)
 	{
-		minBranchFactor = 0;
-		maxBranchFactor = 0;
-		parent = nullptr;
-	}
-
-	Node::Node(RPlusTree &treeRef, unsigned minBranch, unsigned maxBranch, Node *p) :
-		treeRef(treeRef)
-	{
-		minBranchFactor = minBranch;
-		maxBranchFactor = maxBranch;
 		parent = p;
 	}
 
-	void Node::deleteSubtrees()
-	{
-		if (branches.size() == 0)
-		{
-			return;
-		}
-		else
-		{
-			unsigned branchesSize = branches.size();
-			for (unsigned i = 0; i < branchesSize; ++i)
-			{
-				branches[i].child->deleteSubtrees();
-				delete branches[i].child;
-			}
-		}
-	}
-
 	Rectangle Node::boundingBox()
 	{
 		Rectangle bb = Rectangle();
@@ -67,7 +40,7 @@ namespace rplustree
 		for (childIndex = 0; branches[childIndex].child != child && childIndex < branches.size(); ++childIndex) {}
 
 		// Update the child
-		branches[childIndex] = {child, boundingBox};
+		branches.set(childIndex, {child, boundingBox});
 	}
 
 	void Node::removeBranch(Node *child)
@@ -77,9 +50,8 @@ namespace rplustree
 		for (childIndex = 0; branches[childIndex].child != child && childIndex < branches.size(); ++childIndex) {}
 
 		// Delete the child deleting it and overwriting its branch
-		delete child;
-		branches[childIndex] = branches.back();
-		branches.pop_back();
+		treeRef.nodeArena.destroy(child);
+		branches.removeAt(childIndex);
 	}
 
 	void Node::removeData(Point givenPoint)
@@ -118,14 +90,14 @@ namespace rplustree
 		}
 	}
 
-	std::vector<Point> Node::search(Point &requestedPoint)
+	std::vector<Point> Node::search(const Point &requestedPoint) const
 	{
 		std::vector<Point> matchingPoints;
 
 		// Initialize our context stack
-		std::stack<Node *> context;
+		std::stack<const Node *> context;
 		context.push(this);
-		Node *currentContext;
+		const Node *currentContext;
 
 		for (;!context.empty();)
 		{
@@ -150,14 +122,11 @@ namespace rplustree
 			else
 			{
 				// Determine which branches we need to follow
-				for (unsigned i = 0; i < currentContext->branches.size(); ++i)
+				currentContext->branches.forEachContaining(requestedPoint, [&](size_t i)
 				{
-					if (currentContext->branches[i].boundingBox.containsPoint(requestedPoint))
-					{
-						// Add to the nodes we will check
-						context.push(currentContext->branches[i].child);
-					}
-				}
+					// Add to the nodes we will check
+					context.push(currentContext->branches[i].child);
+				});
 
 #ifdef STAT
 				treeRef.stats.markNonLeafNodeSearched();
@@ -172,14 +141,14 @@ namespace rplustree
 		return matchingPoints;
 	}
 
-	std::vector<Point> Node::search(Rectangle &requestedRectangle)
+	std::vector<Point> Node::search(const Rectangle &requestedRectangle) const
 	{
 		std::vector<Point> matchingPoints;
 
 		// Initialize our context stack
-		std::stack<Node *> context;
+		std::stack<const Node *> context;
 		context.push(this);
-		Node *currentContext;
+		const Node *currentContext;
 
 		for (;!context.empty();)
 		{
@@ -204,14 +173,11 @@ namespace rplustree
 			else
 			{
 				// Determine which branches we need to follow
-				for (unsigned i = 0; i < currentContext->branches.size(); ++i)
+				currentContext->branches.forEachIntersecting(requestedRectangle, [&](size_t i)
 				{
-					if (currentContext->branches[i].boundingBox.intersectsRectangle(requestedRectangle))
-					{
-						// Add to the nodes we will check
-						context.push(currentContext->branches[i].child);
-					}
-				}
+					// Add to the nodes we will check
+					context.push(currentContext->branches[i].child);
+				});
 #ifdef STAT
 				treeRef.stats.markNonLeafNodeSearched();
 #endif
@@ -258,7 +224,9 @@ namespace rplustree
 
 				if (smallestExpansionArea != -1.0)
 				{
-					context->branches[smallestExpansionIndex].boundingBox.expand(givenPoint);
+					Rectangle expandedBoundingBox = context->branches[smallestExpansionIndex].boundingBox;
+					expandedBoundingBox.expand(givenPoint);
+					context->branches.setBoundingBox(smallestExpansionIndex, expandedBoundingBox);
 				}
 
 				// Descend
@@ -295,14 +263,11 @@ namespace rplustree
 			{
 				// FL1 [Search subtrees]
 				// Determine which branches we need to follow
-				for (unsigned i = 0; i < currentContext->branches.size(); ++i)
+				currentContext->branches.forEachContaining(givenPoint, [&](size_t i)
 				{
-					if (currentContext->branches[i].boundingBox.containsPoint(givenPoint))
-					{
-						// Add the child to the nodes we will consider
-						context.push(currentContext->branches[i].child);
-					}
-				}
+					// Add the child to the nodes we will consider
+					context.push(currentContext->branches[i].child);
+				});
 			}
 		}
 
@@ -391,8 +356,8 @@ namespace rplustree
 	// Splitting a node will remove it from its parent node and its memory will be freed
 	Node::SplitResult Node::splitNode(Partition p)
 	{
-		Node *left = new Node(treeRef, minBranchFactor, maxBranchFactor, parent);
-		Node *right = new Node(treeRef, minBranchFactor, maxBranchFactor, parent);
+		Node *left = treeRef.nodeArena.create(treeRef, parent);
+		Node *right = treeRef.nodeArena.create(treeRef, parent);
 		unsigned dataSize = data.size();
 		unsigned branchesSize = branches.size();
 
@@ -400,7 +365,7 @@ namespace rplustree
 		{
 			for (Point dataPoint : data)
 			{
-				if (dataPoint[p.dimension] <= p.location && left->data.size() < maxBranchFactor)
+				if (dataPoint[p.dimension] <= p.location && left->data.size() < treeRef.maxBranchFactor)
 				{
 					left->data.push_back(dataPoint);
 				}
@@ -429,7 +394,7 @@ namespace rplustree
 				{
 					Node::SplitResult downwardSplit = branches[i].child->splitNode(p);
 
-					delete branches[i].child;
+					treeRef.nodeArena.destroy(branches[i].child);
 
 					if (downwardSplit.leftBranch.boundingBox != Rectangle::atInfinity)
 					{
@@ -487,7 +452,7 @@ namespace rplustree
 			}
 
 			// Early exit if this node does not overflow
-			if (dataSize <= currentContext->maxBranchFactor && branchesSize <= currentContext->maxBranchFactor)
+			if (dataSize <= currentContext->treeRef.maxBranchFactor && branchesSize <= currentContext->treeRef.maxBranchFactor)
 			{
 				propagationSplit = {{nullptr, Rectangle()}, {nullptr, Rectangle()}};
 				break;
@@ -509,6 +474,45 @@ namespace rplustree
 		return propagationSplit;
 	}
 
+	// Best-first k nearest neighbour search, closest first
+	std::vector<Point> Node::nearest(const Point &givenPoint, unsigned k) const
+	{
+		std::vector<Point> neighbours;
+		NearestQueue<const Node *> queue;
+		queue.pushNode(0.0, this);
+
+		// Points only come off the queue once nothing closer can still be found
+		for (;!queue.empty() && neighbours.size() < k;)
+		{
+			NearestQueue<const Node *>::Entry entry = queue.pop();
+
+			if (entry.isPoint)
+			{
+				neighbours.push_back(entry.point);
+				continue;
+			}
+
+			const Node *currentContext = entry.node;
+
+			if (currentContext->branches.size() == 0)
+			{
+				for (const Point &dataPoint : currentContext->data)
+				{
+					queue.pushPoint(dataPoint.distance(givenPoint), dataPoint);
+				}
+			}
+			else
+			{
+				for (const Branch &branch : currentContext->branches)
+				{
+					queue.pushNode(branch.boundingBox.minDistance(givenPoint), branch.child);
+				}
+			}
+		}
+
+		return neighbours;
+	}
+
 	// Always called on root, this = root
 	Node *Node::insert(Point givenPoint)
 	{
@@ -519,22 +523,19 @@ namespace rplustree
 		// Add just the data
 		adjustContext->data.push_back(givenPoint);
 
-		// There is no guarantee that the root will still exist after adjustment so backup branch factors
-		unsigned backupMinBranchFactor = minBranchFactor;
-		unsigned backupMaxBranchFactor = maxBranchFactor;
 		Node::SplitResult finalSplit = adjustContext->adjustTree();
 
 		// Grow the tree taller if we need to
 		if (finalSplit.leftBranch.child != nullptr && finalSplit.rightBranch.child != nullptr)
 		{
-			Node *newRoot = new Node(treeRef, backupMinBranchFactor, backupMaxBranchFactor, nullptr);
+			Node *newRoot = treeRef.nodeArena.create(treeRef);
 
 			finalSplit.leftBranch.child->parent = newRoot;
 			newRoot->branches.push_back(finalSplit.leftBranch);
 			finalSplit.rightBranch.child->parent = newRoot;
 			newRoot->branches.push_back(finalSplit.rightBranch);
 
-			delete this;
+			treeRef.nodeArena.destroy(this);
 
 			return newRoot;
 		}
@@ -542,6 +543,52 @@ namespace rplustree
 		return this;
 	}
 
+	// Always called on root, this = root
+	Node *Node::insertBatch(const std::vector<Point> &points)
+	{
+		// IB1 [Order the batch along the Hilbert curve so consecutive points share leaves]
+		std::vector<Point> sortedPoints(points);
+		hilbert::sort(sortedPoints);
+
+		Node *root = this;
+		Node *leafHint = nullptr;
+		LeafHintPolicy policy;
+		Rectangle leafHintBox;
+
+		for (const Point &point : sortedPoints)
+		{
+			// IB2 [Reuse the last leaf if its region covers the point and it has room]
+			// A covered point never grows a region so there is nothing to propagate upward
+			if (leafHint != nullptr && leafHint->data.size() < leafHint->treeRef.maxBranchFactor && (leafHint->parent == nullptr || leafHintBox.containsPoint(point)))
+			{
+				leafHint->data.push_back(point);
+				policy.hit();
+				continue;
+			}
+
+			// IB3 [Otherwise insert normally and refresh the hint unless hints keep going unused]
+			root = root->insert(point);
+			leafHint = nullptr;
+			if (policy.shouldRefresh())
+			{
+				leafHint = root->findLeaf(point);
+				if (leafHint->parent != nullptr)
+				{
+					for (const Branch &branch : leafHint->parent->branches)
+					{
+						if (branch.child == leafHint)
+						{
+							leafHintBox = branch.boundingBox;
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		return root;
+	}
+
 	// To be called on a leaf
 	void Node::condenseTree()
 	{
@@ -589,7 +636,7 @@ namespace rplustree
 		if (branches.size() == 1)
 		{
 			Node *newRoot = branches[0].child;
-			delete this;
+			treeRef.nodeArena.destroy(this);
 			newRoot->parent = nullptr;
 			return newRoot;
 		}
@@ -597,6 +644,64 @@ namespace rplustree
 		return this;
 	}
 
+	// A node is its branch count followed by the boxes of its branches and then each child in
+	// turn, or for a leaf a branch count of zero followed by its point count and points
+	void Node::save(snapshot::Writer &writer) const
+	{
+		writer.write((uint32_t) branches.size());
+		if (branches.empty())
+		{
+			writer.write((uint32_t) data.size());
+			writer.write(data.data(), data.size());
+			return;
+		}
+
+		for (const Branch &branch : branches)
+		{
+			writer.write(branch.boundingBox);
+		}
+		for (const Branch &branch : branches)
+		{
+			branch.child->save(writer);
+		}
+	}
+
+	// Always called on a fresh node
+	bool Node::load(snapshot::Reader &reader)
+	{
+		uint32_t branchCount;
+		if (!reader.read(branchCount))
+		{
+			return false;
+		}
+
+		if (branchCount == 0)
+		{
+			uint32_t dataCount;
+			return reader.read(dataCount) && reader.read(data, dataCount);
+		}
+
+		std::vector<Rectangle> childBoxes;
+		if (!reader.read(childBoxes, branchCount))
+		{
+			return false;
+		}
+
+		std::vector<Branch> loadedBranches;
+		loadedBranches.reserve(branchCount);
+		for (const Rectangle &childBox : childBoxes)
+		{
+			loadedBranches.push_back({treeRef.nodeArena.create(treeRef, this), childBox});
+			if (!loadedBranches.back().child->load(reader))
+			{
+				return false;
+			}
+		}
+		branches.assign(loadedBranches);
+
+		return true;
+	}
+
 	unsigned Node::checksum()
 	{
 		unsigned sum = 0;
@@ -625,13 +730,13 @@ namespace rplustree
 
 	bool Node::validate(Node *expectedParent, unsigned index)
 	{
-		if (parent != expectedParent || branches.size() > maxBranchFactor)
+		if (parent != expectedParent || branches.size() > treeRef.maxBranchFactor)
 		{
 			std::cout << "parent = " << (void *)parent << " expectedParent = " << (void *)expectedParent << std::endl;
-			std::cout << "maxBranchFactor = " << maxBranchFactor << std::endl;
+			std::cout << "maxBranchFactor = " << treeRef.maxBranchFactor << std::endl;
 			std::cout << "branches.size() = " << branches.size() << std::endl;
 			assert(parent == expectedParent);
-			assert(branches.size() <= maxBranchFactor);
+			assert(branches.size() <= treeRef.maxBranchFactor);
 		}
 
 		if (expectedParent != nullptr)
@@ -728,7 +833,7 @@ namespace rplustree
 		unsigned long totalLeaves = 0;
 
 		std::vector<unsigned long> histogramFanout;
-		histogramFanout.resize(maxBranchFactor, 0);
+		histogramFanout.resize(treeRef.maxBranchFactor, 0);
 
 		double coverage = 0.0;
 		double overlap = 0.0;
@@ -769,7 +874,7 @@ namespace rplustree
 			else
 			{
 				totalNodes += branchesSize;
-				memoryFootprint += sizeof(Node) + currentContext->branches.size() * sizeof(Node::Branch);
+				memoryFootprint += sizeof(Node) + currentContext->branches.size() * sizeof(Node::Branch) + currentContext->branches.packedBytes();
 				for (unsigned i = 0; i < currentContext->branches.size(); ++i)
 				{
 					if (currentContext->branches[i].child->branches.size() == 1 || currentContext->branches[i].child->data.size() == 1)
@@ -784,6 +889,7 @@ namespace rplustree
 
 		// Print out what we have found
 		STATMEM(memoryFootprint);
+		STATARENA(treeRef.nodeArena.bytes(), treeRef.nodeArena.liveNodes());
 		STATHEIGHT(height());
 		STATSIZE(totalNodes);
 		STATSINGULAR(singularBranches);
@@ -2,20 +2,14 @@
 
 namespace rplustree
 {
-	RPlusTree::RPlusTree(unsigned minBranchFactor, unsigned maxBranchFactor)
+	RPlusTree::RPlusTree(unsigned minBranchFactor, unsigned maxBranchFactor) : minBranchFactor(minBranchFactor), maxBranchFactor(maxBranchFactor)
 	{
-		root = new Node(*this,minBranchFactor, maxBranchFactor);
-	}
-
-	RPlusTree::RPlusTree(Node *root)
-	{
-		this->root = root;
+		root = nodeArena.create(*this);
 	}
 
 	RPlusTree::~RPlusTree()
 	{
-		root->deleteSubtrees();
-		delete root;
+		// The node arena tears every node down in one sweep
 	}
 
 	std::vector<Point> RPlusTree::exhaustiveSearch(Point requestedPoint)
@@ -26,26 +20,70 @@ namespace rplustree
 		return v;
 	}
 
-	std::vector<Point> RPlusTree::search(Point requestedPoint) CONST_IF_NOT_STAT
+	std::vector<Point> RPlusTree::search(Point requestedPoint) const
 	{
+		ALLOCSCOPE(allocationProfile, Search);
 		return root->search(requestedPoint);
 	}
 
-	std::vector<Point> RPlusTree::search(Rectangle requestedRectangle) CONST_IF_NOT_STAT
+	std::vector<Point> RPlusTree::search(Rectangle requestedRectangle) const
 	{
+		ALLOCSCOPE(allocationProfile, RangeSearch);
 		return root->search(requestedRectangle);
 	}
 
+	void RPlusTree::searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const
+	{
+		search(requestedRectangle, [visit, visitor](const Point &p) { visit(visitor, p); });
+	}
+
+	std::vector<Point> RPlusTree::nearest(const Point &givenPoint, unsigned k) const
+	{
+		return root->nearest(givenPoint, k);
+	}
+
 	void RPlusTree::insert(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Insert);
 		root = root->insert(givenPoint);
 	}
 
+	void RPlusTree::insertBatch(const std::vector<Point> &points)
+	{
+		root = root->insertBatch(points);
+	}
+
 	void RPlusTree::remove(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Remove);
 		root = root->remove(givenPoint);
 	}
 
+	bool RPlusTree::save(const std::string &path) const
+	{
+		snapshot::Writer writer(path);
+		snapshot::writeHeader(writer, snapshot::RPlusTreeTag, minBranchFactor, maxBranchFactor);
+		root->save(writer);
+
+		return writer.close();
+	}
+
+	bool RPlusTree::load(const std::string &path)
+	{
+		snapshot::Reader reader(path);
+		nodeArena.clear();
+		root = nodeArena.create(*this);
+
+		if (!snapshot::readHeader(reader, snapshot::RPlusTreeTag, minBranchFactor, maxBranchFactor) || !root->load(reader) || !reader.atEnd())
+		{
+			nodeArena.clear();
+			root = nodeArena.create(*this);
+			return false;
+		}
+
+		return true;
+	}
+
 	unsigned RPlusTree::checksum()
 	{
 		return root->checksum();
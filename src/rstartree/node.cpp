@@ -24,9 +24,9 @@ namespace rstartree
 			bool isLeaf = currentContext->isLeafNode();
 			if (!isLeaf)
 			{
-				for (const auto &entry : currentContext->entries)
+				for (const auto &branch : currentContext->branches)
 				{
-					context.push(std::get<Node::Branch>(entry).child);
+					context.push(currentContext->childOf(branch));
 				}
 			}
 		}
@@ -51,6 +51,13 @@ namespace rstartree
 		treeWalker(root, b);
 	}
 
+	Node::Branch::Branch(Rectangle boundingBox, Node *child) :
+		boundingBox(boundingBox),
+		child(child->treeRef.nodeArena.handle(child)),
+		count(child->subtreeCount())
+	{
+	}
+
 	bool Node::Branch::operator==(const Branch &o) const
 	{
 		return child == o.child && boundingBox == o.boundingBox;
@@ -61,48 +68,72 @@ namespace rstartree
 		parent(parent),
 		level(level)
 	{
-		entries.reserve(treeRef.maxBranchFactor);
+		// Room for the extra entry held while overflowing so a node never grows past its size
+		if (isLeafNode())
+		{
+			data.reserve(treeRef.maxBranchFactor + 1);
+		}
+		else
+		{
+			branches.reserve(treeRef.maxBranchFactor + 1);
+		}
 	}
 
-	void Node::deleteSubtrees()
+	Rectangle Node::boundingBox() const
 	{
-		if (entries.empty() || !std::holds_alternative<Branch>(entries[0]))
+		if (branches.empty())
 		{
-			return;
+			assert(!data.empty());
+			Rectangle boundingBox(data[0], data[0]);
+
+			for (auto iter = data.begin() + 1; iter != data.end(); iter++)
+			{
+				boundingBox.expand(*iter);
+			}
+
+			return boundingBox;
 		}
 
-		for (const auto &entry : entries)
-		{
-			const Branch &b = std::get<Branch>(entry);
-			b.child->deleteSubtrees();
+		assert(!branches.empty());
+		Rectangle boundingBox(branches[0].boundingBox);
 
-			delete b.child;
+		for (auto iter = branches.begin() + 1; iter != branches.end(); iter++)
+		{
+			boundingBox.expand(iter->boundingBox);
 		}
+
+		return boundingBox;
 	}
 
-	Rectangle Node::boundingBox() const
+	// The boxes of our entries in order, points becoming degenerate boxes
+	std::vector<Rectangle> Node::entryBoxes() const
 	{
-		assert(!entries.empty());
-		Rectangle boundingBox(boxFromNodeEntry(entries[0]));
+		std::vector<Rectangle> boxes;
+		boxes.reserve(entryCount());
 
-		for (auto iter = entries.begin() + 1; iter != entries.end(); iter++)
+		for (const Point &dataPoint : data)
 		{
-			boundingBox.expand(boxFromNodeEntry(*iter));
+			boxes.emplace_back(dataPoint, dataPoint);
 		}
 
-		return boundingBox;
+		for (const Branch &branch : branches)
+		{
+			boxes.push_back(branch.boundingBox);
+		}
+
+		return boxes;
 	}
 
 	bool Node::updateBoundingBox(Node *child, Rectangle updatedBoundingBox)
 	{
-		for (auto &entry : entries)
+		NodeHandle childHandle = treeRef.nodeArena.handle(child);
+		for (unsigned i = 0; i < branches.size(); ++i)
 		{
-			Branch &b = std::get<Branch>(entry);
-			if (b.child == child)
+			if (branches[i].child == childHandle)
 			{
-				if (b.boundingBox != updatedBoundingBox)
+				if (branches[i].boundingBox != updatedBoundingBox)
 				{
-					b.boundingBox = updatedBoundingBox;
+					branches.setBoundingBox(i, updatedBoundingBox);
 					return true;
 				}
 				return false;
@@ -118,11 +149,14 @@ namespace rstartree
 
 	void Node::removeChild(Node *child)
 	{
-		for (auto iter = entries.begin(); iter != entries.end(); iter++)
+		NodeHandle childHandle = treeRef.nodeArena.handle(child);
+		for (unsigned i = 0; i < branches.size(); ++i)
 		{
-			if (std::get<Branch>(*iter).child == child)
-			{ 
-				entries.erase(iter);
+			if (branches[i].child == childHandle)
+			{
+				unsigned childCount = branches[i].count;
+				branches.erase(i);
+				propagateCount(-(int) childCount);
 				return;
 			}
 		}
@@ -130,26 +164,62 @@ namespace rstartree
 
 	void Node::removeData(const Point &givenPoint)
 	{
-		for (auto iter = entries.begin(); iter != entries.end(); iter++)
+		for (auto iter = data.begin(); iter != data.end(); iter++)
 		{
-			if (std::get<Point>(*iter) == givenPoint)
+			if (*iter == givenPoint)
 			{
-				entries.erase(iter);
+				data.erase(iter);
+				propagateCount(-1);
 				return;
 			}
 		}
 	}
 
+	unsigned Node::subtreeCount() const
+	{
+		if (isLeafNode())
+		{
+			return data.size();
+		}
+
+		unsigned sum = 0;
+		for (const Branch &b : branches)
+		{
+			sum += b.count;
+		}
+
+		return sum;
+	}
+
+	// Every change to the points below a node has to reach the counts of all its ancestors'
+	// branches. Entries that only move between siblings cancel out above their common parent.
+	void Node::propagateCount(int delta)
+	{
+		for (Node *node = this; node->parent != nullptr; node = node->parent)
+		{
+			PackedBoxes<Branch> &parentBranches = node->parent->branches;
+			NodeHandle nodeHandle = node->treeRef.nodeArena.handle(node);
+			for (unsigned i = 0; i < parentBranches.size(); ++i)
+			{
+				if (parentBranches[i].child == nodeHandle)
+				{
+					Branch b = parentBranches[i];
+					b.count += delta;
+					parentBranches.set(i, b);
+					break;
+				}
+			}
+		}
+	}
+
 	void Node::exhaustiveSearch(const Point &requestedPoint, std::vector<Point> &accumulator) const
 	{
 		// Am I a leaf?
 		bool isLeaf = isLeafNode();
 		if (isLeaf)
 		{
-			for (const auto &entry : entries)
+			for (const Point &p : data)
 			{
-				const Point &p = std::get<Point>(entry);
-
 				if (p == requestedPoint)
 				{
 					accumulator.push_back(p);
@@ -158,14 +228,14 @@ namespace rstartree
 		}
 		else
 		{
-			for (const auto &entry : entries)
+			for (const Branch &b : branches)
 			{
-				std::get<Branch>(entry).child->exhaustiveSearch(requestedPoint, accumulator);
+				childOf(b)->exhaustiveSearch(requestedPoint, accumulator);
 			}
 		}
 	}
 
-	void Node::searchSub(const Point &requestedPoint, std::vector<Point> &accumulator) CONST_IF_NOT_STAT
+	void Node::searchSub(const Point &requestedPoint, std::vector<Point> &accumulator) const
 	{
 
 		std::stack<const Node *> context;
@@ -181,10 +251,8 @@ namespace rstartree
 #ifdef STAT
 				treeRef.stats.markLeafSearched();
 #endif
-				for (const auto &entry : curNode->entries)
+				for (const Point &p : curNode->data)
 				{
-					const Point &p = std::get<Point>(entry);
-
 					if (p == requestedPoint)
 					{
 						accumulator.push_back(p);
@@ -196,21 +264,15 @@ namespace rstartree
 #ifdef STAT
 				treeRef.stats.markNonLeafNodeSearched();
 #endif
-				for (const auto &entry : curNode->entries)
+				curNode->branches.forEachContaining(requestedPoint, [&](size_t i)
 				{
-
-					const Branch &b = std::get<Branch>(entry);
-
-					if (b.boundingBox.containsPoint(requestedPoint))
-					{
-						context.push(b.child);
-					}
-				}
+					context.push(curNode->childOf(curNode->branches[i]));
+				});
 			}
 		}
 	}
 
-	void Node::searchSub(const Rectangle &rectangle, std::vector<Point> &accumulator) CONST_IF_NOT_STAT
+	void Node::searchSub(const Rectangle &rectangle, std::vector<Point> &accumulator) const
 	{
 		std::stack<const Node *> context;
 		context.push(this);
@@ -225,10 +287,8 @@ namespace rstartree
 #ifdef STAT
 				treeRef.stats.markLeafSearched();
 #endif
-				for (const auto &entry : curNode->entries)
+				for (const Point &p : curNode->data)
 				{
-					const Point &p = std::get<Point>(entry);
-
 					if (rectangle.containsPoint(p))
 					{
 						accumulator.push_back(p);
@@ -240,21 +300,16 @@ namespace rstartree
 #ifdef STAT
 				treeRef.stats.markNonLeafNodeSearched();
 #endif
-				for (const auto &entry : curNode->entries)
+				curNode->branches.forEachIntersecting(rectangle, [&](size_t i)
 				{
-					const Branch &b = std::get<Branch>(entry);
-
-					if (b.boundingBox.intersectsRectangle(rectangle))
-					{
-						context.push(b.child);
-					}
-				}
+					context.push(curNode->childOf(curNode->branches[i]));
+				});
 			}
 		}
 	}
 
 
-	std::vector<Point> Node::search(const Point &requestedPoint) CONST_IF_NOT_STAT
+	std::vector<Point> Node::search(const Point &requestedPoint) const
 	{
 		std::vector<Point> accumulator;
 
@@ -266,7 +321,7 @@ namespace rstartree
 		return accumulator;
 	}
 
-	std::vector<Point> Node::search(const Rectangle &requestedRectangle) CONST_IF_NOT_STAT
+	std::vector<Point> Node::search(const Rectangle &requestedRectangle) const
 	{
 		std::vector<Point> matchingPoints;
 
@@ -278,38 +333,184 @@ namespace rstartree
 		return matchingPoints;
 	}
 
-	double computeOverlapGrowth(unsigned index, const std::vector<Node::NodeEntry> &entries, const Rectangle &givenBox)
+	// Best-first k nearest neighbour search, closest first
+	std::vector<Point> Node::nearest(const Point &givenPoint, unsigned k) const
+	{
+		std::vector<Point> neighbours;
+		NearestQueue<const Node *> queue;
+		queue.pushNode(0.0, this);
+
+		// Points only come off the queue once nothing closer can still be found
+		for (;!queue.empty() && neighbours.size() < k;)
+		{
+			NearestQueue<const Node *>::Entry entry = queue.pop();
+
+			if (entry.isPoint)
+			{
+				neighbours.push_back(entry.point);
+				continue;
+			}
+
+			const Node *currentContext = entry.node;
+
+			if (currentContext->isLeafNode())
+			{
+				for (const Point &dataPoint : currentContext->data)
+				{
+					queue.pushPoint(dataPoint.distance(givenPoint), dataPoint);
+				}
+			}
+			else
+			{
+				for (const Branch &branch : currentContext->branches)
+				{
+					queue.pushNode(branch.boundingBox.minDistance(givenPoint), currentContext->childOf(branch));
+				}
+			}
+		}
+
+		return neighbours;
+	}
+
+	// Counts the points inside the rectangle. Branches wholly inside it contribute their
+	// subtree count without being descended.
+	unsigned Node::count(const Rectangle &requestedRectangle) const
+	{
+		unsigned matchingPoints = 0;
+
+		std::vector<const Node *> &context = QueryContext<const Node>::local().stack;
+		size_t base = context.size();
+		context.push_back(this);
+
+		for (;context.size() > base;)
+		{
+			const Node *currentContext = context.back();
+			context.pop_back();
+
+			if (currentContext->isLeafNode())
+			{
+				for (const Point &dataPoint : currentContext->data)
+				{
+					if (requestedRectangle.containsPoint(dataPoint))
+					{
+						++matchingPoints;
+					}
+				}
+			}
+			else
+			{
+				for (const Branch &branch : currentContext->branches)
+				{
+					if (requestedRectangle.containsRectangle(branch.boundingBox))
+					{
+						matchingPoints += branch.count;
+					}
+					else if (branch.boundingBox.intersectsRectangle(requestedRectangle))
+					{
+						context.push_back(currentContext->childOf(branch));
+					}
+				}
+			}
+		}
+
+		return matchingPoints;
+	}
+
+	// Answers many range queries in one traversal. Queries are taken 64 at a time and every node
+	// on the stack carries a mask of the queries still intersecting it, so upper levels are visited
+	// once per chunk instead of once per query.
+	void Node::searchBatch(const std::vector<Rectangle> &requestedRectangles, std::vector<std::vector<Point>> &accumulators) const
+	{
+		// Initialize our context stack
+		std::stack<std::pair<const Node *, uint64_t>> context;
+
+		for (unsigned chunkBegin = 0; chunkBegin < requestedRectangles.size(); chunkBegin += 64)
+		{
+			const Rectangle *chunk = requestedRectangles.data() + chunkBegin;
+			std::vector<Point> *chunkAccumulators = accumulators.data() + chunkBegin;
+			unsigned chunkSize = std::min(64u, (unsigned) (requestedRectangles.size() - chunkBegin));
+			uint64_t allQueries = chunkSize == 64 ? ~uint64_t(0) : (uint64_t(1) << chunkSize) - 1;
+
+			context.push({this, allQueries});
+			for (;!context.empty();)
+			{
+				const Node * currentContext = context.top().first;
+				uint64_t activeQueries = context.top().second;
+				context.pop();
+
+				if (currentContext->isLeafNode())
+				{
+					// Hand each data point to every active query containing it
+					for (const Point &dataPoint : currentContext->data)
+					{
+						for (uint64_t queries = activeQueries; queries != 0; queries &= queries - 1)
+						{
+							unsigned q = __builtin_ctzll(queries);
+							if (chunk[q].containsPoint(dataPoint))
+							{
+								chunkAccumulators[q].push_back(dataPoint);
+							}
+						}
+					}
+				}
+				else
+				{
+					// Follow each branch with only the queries that still intersect it
+					for (const Branch &branch : currentContext->branches)
+					{
+						uint64_t branchQueries = 0;
+						for (uint64_t queries = activeQueries; queries != 0; queries &= queries - 1)
+						{
+							unsigned q = __builtin_ctzll(queries);
+							if (branch.boundingBox.intersectsRectangle(chunk[q]))
+							{
+								branchQueries |= uint64_t(1) << q;
+							}
+						}
+
+						if (branchQueries != 0)
+						{
+							context.push({currentContext->childOf(branch), branchQueries});
+						}
+					}
+				}
+			}
+		}
+	}
+
+	double computeOverlapGrowth(unsigned index, const std::vector<Node::Branch> &branches, const Rectangle &givenBox)
 	{
 		// We cannot be a leaf
-		assert(!entries.empty());
-		assert(std::holds_alternative<Node::Branch>(entries[0]));
+		assert(!branches.empty());
 		
 		// 1. Make a test rectangle we will use to not modify the original
-		const Rectangle &origRectangle = std::get<Node::Branch>(entries[index]).boundingBox;
-		Rectangle newRectangle = std::get<Node::Branch>(entries[index]).boundingBox;
+		const Rectangle &origRectangle = branches[index].boundingBox;
+		Rectangle newRectangle = branches[index].boundingBox;
 		
 		// 2. Add the point to the copied Rectangle
 		newRectangle.expand(givenBox);
 
 		// 3. Compute the overlap expansion area 
 		double overlapDiff = 0;
-		for (unsigned i = 0; i < entries.size(); ++i)
+		for (unsigned i = 0; i < branches.size(); ++i)
 		{
-			const auto &entry = entries[i];
+			const Node::Branch &branch = branches[i];
 
 			if (i == index)
 			{
 				continue;
 			}
 
-			overlapDiff += (newRectangle.computeIntersectionArea(std::get<Node::Branch>(entry).boundingBox)
-				- origRectangle.computeIntersectionArea(std::get<Node::Branch>(entry).boundingBox));
+			overlapDiff += (newRectangle.computeIntersectionArea(branch.boundingBox)
+				- origRectangle.computeIntersectionArea(branch.boundingBox));
 		}
 
 		return overlapDiff;
 	}
 
-	Node *Node::chooseSubtree(const NodeEntry &givenNodeEntry)
+	// Descends to the node at stoppingLevel best suited to take an entry with the given box,
+	// points going to leaves and branches to one level above their child
+	Node *Node::chooseSubtree(const Rectangle &givenEntryBoundingBox, unsigned stoppingLevel)
 	{
 		// CS1: This is CAlled on the root! Just like above
 		// CS2: If N is a leaf return N (same)
@@ -327,15 +528,6 @@ namespace rstartree
 		// Always called on root, this = root
 		assert(parent == nullptr);
 
-		unsigned stoppingLevel = 0;
-		bool entryIsBranch = std::holds_alternative<Branch>(givenNodeEntry);
-		if (entryIsBranch)
-		{
-			const Branch &b = std::get<Branch>(givenNodeEntry);
-			stoppingLevel = b.child->level + 1;
-		}
-		Rectangle givenEntryBoundingBox = boxFromNodeEntry(givenNodeEntry);
-
 		for (;;)
 		{
 
@@ -347,14 +539,12 @@ namespace rstartree
 			assert(!node->isLeafNode());
 
 			// Our children point to leaves
-#ifndef NDEBUG
-			const Branch &firstBranch = std::get<Branch>(node->entries[0]);
-#endif
-			assert(!firstBranch.child->entries.empty());
+			assert(!node->branches.empty());
+			assert(node->childOf(node->branches[0])->entryCount() > 0);
 
 			unsigned descentIndex = 0;
 			
-			bool childrenAreLeaves = !std::holds_alternative<Branch>(std::get<Branch>(node->entries[0]).child->entries[0]);
+			bool childrenAreLeaves = node->childOf(node->branches[0])->isLeafNode();
 			if (childrenAreLeaves)
 			{
 				double smallestOverlapExpansion = std::numeric_limits<double>::infinity();
@@ -362,13 +552,12 @@ namespace rstartree
 				double smallestArea = std::numeric_limits<double>::infinity();
 
 				// Choose the entry in N whose rectangle needs least overlap enlargement
-				for (unsigned i = 0; i < node->entries.size(); ++i)
+				for (unsigned i = 0; i < node->branches.size(); ++i)
 				{
-					const NodeEntry &entry = node->entries[i];
-					const Branch &b = std::get<Branch>(entry);
+					const Branch &b = node->branches[i];
 
 					// Compute overlap
-					double testOverlapExpansionArea = computeOverlapGrowth(i, node->entries, givenEntryBoundingBox);
+					double testOverlapExpansionArea = computeOverlapGrowth(i, node->branches, givenEntryBoundingBox);
 
 					// Take largest overlap
 					if (smallestOverlapExpansion > testOverlapExpansionArea)
@@ -411,10 +600,9 @@ namespace rstartree
 
 				// CL2 [Choose subtree]
 				// Find the bounding box with least required expansion/overlap
-				for (unsigned i = 0; i < node->entries.size(); ++i)
+				for (unsigned i = 0; i < node->branches.size(); ++i)
 				{
-					const NodeEntry &entry = node->entries[i];
-					const Branch &b = std::get<Branch>(entry);
+					const Branch &b = node->branches[i];
 
 					double testExpansionArea = b.boundingBox.computeExpansionArea(givenEntryBoundingBox);
 					if (smallestExpansionArea > testExpansionArea)
@@ -438,21 +626,21 @@ namespace rstartree
 			}
 
 			// Descend
-			node = std::get<Branch>(node->entries[descentIndex]).child;
+			node = node->childOf(node->branches[descentIndex]);
 		}
 	}
 
 	Node *Node::findLeaf(const Point &givenPoint)
 	{
-		assert(!entries.empty());
+		assert(entryCount() > 0);
 
 		// Am I a leaf?
 		bool isLeaf = isLeafNode();
 		if (isLeaf)
 		{
-			for (const auto &entry : entries)
+			for (const Point &dataPoint : data)
 			{
-				if (std::get<Point>(entry) == givenPoint)
+				if (dataPoint == givenPoint)
 				{
 					return this;
 				}
@@ -461,13 +649,11 @@ namespace rstartree
 			return nullptr;
 		}
 
-		for (const auto &entry : entries)
+		for (const Branch &b : branches)
 		{
-			const Branch &b = std::get<Branch>(entry);
-
 			if (b.boundingBox.containsPoint(givenPoint))
 			{
-				Node *ptr = b.child->findLeaf(givenPoint);
+				Node *ptr = childOf(b)->findLeaf(givenPoint);
 				if (ptr != nullptr)
 				{
 					return ptr;
@@ -479,32 +665,32 @@ namespace rstartree
 		return nullptr;
 	}
 
-	double Node::computeTotalMarginSum(std::vector<NodeEntry *> ptrs)
+	double Node::computeTotalMarginSum(const std::vector<Rectangle> &boundingBoxes)
 	{
-		std::vector<NodeEntry *> groupA(ptrs.begin(), ptrs.begin() + treeRef.minBranchFactor);
-		std::vector<NodeEntry *> groupB(ptrs.begin()+treeRef.minBranchFactor, ptrs.end());
+		std::vector<Rectangle> groupA(boundingBoxes.begin(), boundingBoxes.begin() + treeRef.minBranchFactor);
+		std::vector<Rectangle> groupB(boundingBoxes.begin() + treeRef.minBranchFactor, boundingBoxes.end());
 
 		double sumOfAllMarginValues = 0;
 
 		while (groupA.size() <= treeRef.maxBranchFactor && groupB.size() >= treeRef.minBranchFactor)
 		{
-			Rectangle boundingBoxA = boxFromNodeEntry(*groupA[0]);
+			Rectangle boundingBoxA = groupA[0];
 			for (unsigned i = 1; i < groupA.size(); ++i)
 			{
-				boundingBoxA.expand(boxFromNodeEntry(*groupA[i]));
+				boundingBoxA.expand(groupA[i]);
 			}
 
-			Rectangle boundingBoxB = boxFromNodeEntry(*groupB[0]);
+			Rectangle boundingBoxB = groupB[0];
 			for (unsigned i = 1; i < groupB.size(); ++i)
 			{
-				boundingBoxB.expand(boxFromNodeEntry(*groupB[i]));
+				boundingBoxB.expand(groupB[i]);
 			}
 
 			// Calculate new margin sum
 			sumOfAllMarginValues += boundingBoxA.margin() + boundingBoxB.margin();
 			
 			// Add one new value to groupA and remove one from groupB. Repeat.
-			NodeEntry *transfer = groupB.front();
+			Rectangle transfer = groupB.front();
 			groupB.erase(groupB.begin());
 			groupA.push_back(transfer);
 		}
@@ -518,48 +704,48 @@ namespace rstartree
 		double optimalMargin = std::numeric_limits<double>::infinity();
 
 		// Make the entries easier to work with
-		std::vector<NodeEntry *> entriesCopy;
-		entriesCopy.reserve(entries.size());
-		for (NodeEntry &entry : entries)
+		std::vector<Point *> dataCopy;
+		dataCopy.reserve(data.size());
+		for (Point &dataPoint : data)
 		{
-			entriesCopy.push_back(&entry);
+			dataCopy.push_back(&dataPoint);
 		}
 
 		// Consider all M-2m+2 distributions in each dimension
 		for (unsigned d = 0; d < dimensions; d++)
 		{
 			// First sort in the current dimension
-			std::sort(entriesCopy.begin(), entriesCopy.end(), [d](NodeEntry *a, NodeEntry *b)
+			std::sort(dataCopy.begin(), dataCopy.end(), [d](Point *a, Point *b)
 			{
-				return std::get<Point>(*a)[d] < std::get<Point>(*b)[d];
+				return (*a)[d] < (*b)[d];
 			});
 
 			// Setup groups
-			std::vector<NodeEntry *> groupA(entriesCopy.begin(), entriesCopy.begin() + treeRef.minBranchFactor);
-			std::vector<NodeEntry *> groupB(entriesCopy.begin() + treeRef.minBranchFactor, entriesCopy.end());
+			std::vector<Point *> groupA(dataCopy.begin(), dataCopy.begin() + treeRef.minBranchFactor);
+			std::vector<Point *> groupB(dataCopy.begin() + treeRef.minBranchFactor, dataCopy.end());
 
 			// Cycle through all M-2m+2 distributions
 			double totalMargin = 0.0;
 			for (;groupA.size() <= treeRef.maxBranchFactor && groupB.size() >= treeRef.minBranchFactor;)
 			{
 				// Compute the margin of groupA and groupB
-				Rectangle boundingBoxA = boxFromNodeEntry(*groupA[0]);
+				Rectangle boundingBoxA(*groupA[0], *groupA[0]);
 				for (unsigned i = 1; i < groupA.size(); ++i)
 				{
-					boundingBoxA.expand(std::get<Point>(*groupA[i]));
+					boundingBoxA.expand(*groupA[i]);
 				}
 
-				Rectangle boundingBoxB = boxFromNodeEntry(*groupB[0]);
+				Rectangle boundingBoxB(*groupB[0], *groupB[0]);
 				for (unsigned i = 1; i < groupB.size(); ++i)
 				{
-					boundingBoxB.expand(std::get<Point>(*groupB[i]));
+					boundingBoxB.expand(*groupB[i]);
 				}
 
 				// Add to the total margin sum
 				totalMargin += boundingBoxA.margin() + boundingBoxB.margin();
 
 				// Add one new value to groupA and remove one from groupB to obtain next distribution
-				NodeEntry *transferPoint = groupB.front();
+				Point *transferPoint = groupB.front();
 				groupB.erase(groupB.begin());
 				groupA.push_back(transferPoint);
 			}
@@ -572,9 +758,9 @@ namespace rstartree
 		}
 
 		// Sort along our best axis
-		std::sort(entries.begin(), entries.end(), [optimalAxis](NodeEntry &a, NodeEntry &b)
+		std::sort(data.begin(), data.end(), [optimalAxis](const Point &a, const Point &b)
 		{
-			return std::get<Point>(a)[optimalAxis] < std::get<Point>(b)[optimalAxis];
+			return a[optimalAxis] < b[optimalAxis];
 		});
 
 		return optimalAxis;
@@ -582,11 +768,7 @@ namespace rstartree
 
 	double Node::computeTotalMarginSum()
 	{
-		std::vector<NodeEntry *> ptrs;
-		ptrs.reserve(entries.size());
-		std::transform(entries.begin(), entries.end(), std::back_inserter(ptrs),
-			[](NodeEntry &e) -> NodeEntry * { return &e; });
-		return computeTotalMarginSum(ptrs);
+		return computeTotalMarginSum(entryBoxes());
 	}
 
 	unsigned Node::chooseSplitNonLeafAxis()
@@ -597,35 +779,35 @@ namespace rstartree
 		double optimalMarginUpper = std::numeric_limits<double>::infinity();
 
 		// Make entries easier to work with
-		std::vector<NodeEntry *> lowerEntries;
-		lowerEntries.reserve(entries.size());
-		std::vector<NodeEntry *> upperEntries;
-		upperEntries.reserve(entries.size());
-		for (NodeEntry &entry : entries)
-		{
-			lowerEntries.push_back(&entry);
-			upperEntries.push_back(&entry);
+		std::vector<const Branch *> lowerEntries;
+		lowerEntries.reserve(branches.size());
+		std::vector<const Branch *> upperEntries;
+		upperEntries.reserve(branches.size());
+		for (const Branch &branch : branches)
+		{
+			lowerEntries.push_back(&branch);
+			upperEntries.push_back(&branch);
 		}
 
 		// Consider all M-2m+2 distributions in each dimension
 		for (unsigned d = 0; d < dimensions; d++)
 		{
 			// First sort in the current dimension sorting both the lower and upper arrays
-			std::sort(lowerEntries.begin(), lowerEntries.end(), [d](NodeEntry *a, NodeEntry *b)
+			std::sort(lowerEntries.begin(), lowerEntries.end(), [d](const Branch *a, const Branch *b)
 			{
-				return std::get<Branch>(*a).boundingBox.lowerLeft[d] < std::get<Branch>(*b).boundingBox.lowerLeft[d];
+				return a->boundingBox.lowerLeft[d] < b->boundingBox.lowerLeft[d];
 			});
-			std::sort(upperEntries.begin(), upperEntries.end(), [d](NodeEntry *a, NodeEntry *b)
+			std::sort(upperEntries.begin(), upperEntries.end(), [d](const Branch *a, const Branch *b)
 			{
-				return std::get<Branch>(*a).boundingBox.upperRight[d] < std::get<Branch>(*b).boundingBox.upperRight[d];
+				return a->boundingBox.upperRight[d] < b->boundingBox.upperRight[d];
 			});
 
 			// Setup groups
-			std::vector<NodeEntry *> groupALower(lowerEntries.begin(), lowerEntries.begin() + treeRef.minBranchFactor);
-			std::vector<NodeEntry *> groupAUpper(upperEntries.begin(), upperEntries.begin() + treeRef.minBranchFactor);
+			std::vector<const Branch *> groupALower(lowerEntries.begin(), lowerEntries.begin() + treeRef.minBranchFactor);
+			std::vector<const Branch *> groupAUpper(upperEntries.begin(), upperEntries.begin() + treeRef.minBranchFactor);
 
-			std::vector<NodeEntry *> groupBLower(lowerEntries.begin() + treeRef.minBranchFactor, lowerEntries.end());
-			std::vector<NodeEntry *> groupBUpper(upperEntries.begin() + treeRef.minBranchFactor, upperEntries.end());
+			std::vector<const Branch *> groupBLower(lowerEntries.begin() + treeRef.minBranchFactor, lowerEntries.end());
+			std::vector<const Branch *> groupBUpper(upperEntries.begin() + treeRef.minBranchFactor, upperEntries.end());
 
 			// Cycle through all M-2m+2 distributions
 			double totalMarginLower = 0.0;
@@ -633,20 +815,20 @@ namespace rstartree
 			for (;groupALower.size() <= treeRef.maxBranchFactor && groupBLower.size() >= treeRef.minBranchFactor;)
 			{
 				// Compute the margin of groupA and groupB
-				Rectangle boundingBoxALower = boxFromNodeEntry(*groupALower[0]);
-				Rectangle boundingBoxAUpper = boxFromNodeEntry(*groupAUpper[0]);
+				Rectangle boundingBoxALower = groupALower[0]->boundingBox;
+				Rectangle boundingBoxAUpper = groupAUpper[0]->boundingBox;
 				for (unsigned i = 1; i < groupALower.size(); ++i)
 				{
-					boundingBoxALower.expand(boxFromNodeEntry(*groupALower[i]));
-					boundingBoxAUpper.expand(boxFromNodeEntry(*groupAUpper[i]));
+					boundingBoxALower.expand(groupALower[i]->boundingBox);
+					boundingBoxAUpper.expand(groupAUpper[i]->boundingBox);
 				}
 
-				Rectangle boundingBoxBLower = boxFromNodeEntry(*groupBLower[0]);
-				Rectangle boundingBoxBUpper = boxFromNodeEntry(*groupBUpper[0]);
+				Rectangle boundingBoxBLower = groupBLower[0]->boundingBox;
+				Rectangle boundingBoxBUpper = groupBUpper[0]->boundingBox;
 				for (unsigned i = 1; i < groupBLower.size(); ++i)
 				{
-					boundingBoxBLower.expand(boxFromNodeEntry(*groupBLower[i]));
-					boundingBoxBUpper.expand(boxFromNodeEntry(*groupBUpper[i]));
+					boundingBoxBLower.expand(groupBLower[i]->boundingBox);
+					boundingBoxBUpper.expand(groupBUpper[i]->boundingBox);
 				}
 
 				// Add to the total margin sum
@@ -654,8 +836,8 @@ namespace rstartree
 				totalMarginUpper += boundingBoxAUpper.margin() + boundingBoxBUpper.margin();
 
 				// Add one new value to groupA and remove one from groupB to obtain next distribution
-				NodeEntry *transferPointLower = groupBLower.front();
-				NodeEntry *transferPointUpper = groupBUpper.front();
+				const Branch *transferPointLower = groupBLower.front();
+				const Branch *transferPointUpper = groupBUpper.front();
 				groupBLower.erase(groupBLower.begin());
 				groupBUpper.erase(groupBUpper.begin());
 				groupALower.push_back(transferPointLower);
@@ -681,18 +863,18 @@ namespace rstartree
 		// Sort to match the optimal axis
 		if (sortLower)
 		{
-			std::sort(entries.begin(), entries.end(), [optimalAxis](NodeEntry &a, NodeEntry &b)
+			branches.sort([optimalAxis](const Branch &a, const Branch &b)
 			{
-				return std::get<Branch>(a).boundingBox.lowerLeft[optimalAxis] < 
-						std::get<Branch>(b).boundingBox.lowerLeft[optimalAxis];
+				return a.boundingBox.lowerLeft[optimalAxis] < 
+						b.boundingBox.lowerLeft[optimalAxis];
 			});
 		}
 		else
 		{
-			std::sort(entries.begin(), entries.end(), [optimalAxis](NodeEntry &a, NodeEntry &b)
+			branches.sort([optimalAxis](const Branch &a, const Branch &b)
 			{
-				return std::get<Branch>(a).boundingBox.upperRight[optimalAxis] <
-						std::get<Branch>(b).boundingBox.upperRight[optimalAxis];
+				return a.boundingBox.upperRight[optimalAxis] <
+						b.boundingBox.upperRight[optimalAxis];
 			});
 		}
 
@@ -718,14 +900,15 @@ namespace rstartree
 	{
 		// We assume this is called after we have sorted this->data according to axis.
 
-		const auto groupABegin = entries.begin();
-		const auto groupAEnd = entries.begin() + treeRef.minBranchFactor;
-		const auto groupBBegin = entries.begin() + treeRef.minBranchFactor;
-		const auto groupBEnd = entries.end();
+		std::vector<Rectangle> boxes = entryBoxes();
+		const auto groupABegin = boxes.begin();
+		const auto groupAEnd = boxes.begin() + treeRef.minBranchFactor;
+		const auto groupBBegin = boxes.begin() + treeRef.minBranchFactor;
+		const auto groupBEnd = boxes.end();
 
-		std::vector<NodeEntry> groupA(groupABegin, groupAEnd);
-		std::vector<NodeEntry> groupB(groupBBegin, groupBEnd);
-		unsigned splitIndex = entries.size() / 2;
+		std::vector<Rectangle> groupA(groupABegin, groupAEnd);
+		std::vector<Rectangle> groupB(groupBBegin, groupBEnd);
+		unsigned splitIndex = boxes.size() / 2;
 
 		// Find the best size out of all the distributions
 		double minOverlap = std::numeric_limits<double>::infinity();
@@ -738,16 +921,16 @@ namespace rstartree
 		while (groupA.size() <= treeRef.maxBranchFactor && groupB.size() >= treeRef.minBranchFactor)
 		{
 			// Compute the margin of groupA and groupB
-			Rectangle boundingBoxA = boxFromNodeEntry(groupA[0]);
+			Rectangle boundingBoxA = groupA[0];
 			for (unsigned i = 1; i < groupA.size(); ++i)
 			{
-				boundingBoxA.expand(boxFromNodeEntry(groupA[i]));
+				boundingBoxA.expand(groupA[i]);
 			}
 
-			Rectangle boundingBoxB = boxFromNodeEntry(groupB[0]);
+			Rectangle boundingBoxB = groupB[0];
 			for (unsigned i = 1; i < groupB.size(); ++i)
 			{
-				boundingBoxB.expand(boxFromNodeEntry(groupB[i]));
+				boundingBoxB.expand(groupB[i]);
 			}
 
 			// Compute intersection area to determine best grouping of data points
@@ -779,7 +962,7 @@ namespace rstartree
 			}
 			
 			// Add one new value to groupA and remove one from groupB to obtain next distribution
-			NodeEntry transferPoint = groupB.front();
+			Rectangle transferPoint = groupB.front();
 			groupB.erase(groupB.begin());
 			groupA.push_back(transferPoint);
 
@@ -802,31 +985,36 @@ namespace rstartree
 		// Call ChooseSplitIndex to create optimal splitting of data array
 		unsigned splitIndex = chooseSplitIndex(chooseSplitAxis());
 
-		Node *newSibling = new Node(treeRef, parent, level);
+		Node *newSibling = treeRef.nodeArena.create(treeRef, parent, level);
 
 		assert((parent == nullptr) || (level + 1 == parent->level));
 
 		// Copy everything to the right of the splitPoint (inclusive) to the new sibling
-		std::copy(entries.begin() + splitIndex, entries.end(), std::back_inserter(newSibling->entries));
-
-		if (std::holds_alternative<Branch>(newSibling->entries[0]))
+		if (isLeafNode())
+		{
+			std::copy(data.begin() + splitIndex, data.end(), std::back_inserter(newSibling->data));
+			data.erase(data.begin() + splitIndex, data.end());
+		}
+		else
 		{
-			for (auto &entry : newSibling->entries)
+			newSibling->branches.assign(branches.begin() + splitIndex, branches.end());
+			branches.erase(splitIndex, branches.size());
+
+			for (const Branch &b : newSibling->branches)
 			{
 				// Update parents
-				Branch &b = std::get<Branch>(entry);
-				b.child->parent = newSibling;
+				childOf(b)->parent = newSibling;
 
-				assert(level == b.child->level + 1);
-				assert(newSibling->level == b.child->level + 1);
+				assert(level == childOf(b)->level + 1);
+				assert(newSibling->level == childOf(b)->level + 1);
 			}
 		}
 
-		// Chop our node's data down
-		entries.erase(entries.begin() + splitIndex, entries.end());
+		// Our node's data is chopped down, the sibling's points come back when it joins our parent
+		propagateCount(-(int) newSibling->subtreeCount());
 
-		assert(!entries.empty());
-		assert(!newSibling->entries.empty());
+		assert(entryCount() > 0);
+		assert(newSibling->entryCount() > 0);
 
 		// Return our newly minted sibling
 		return newSibling;
@@ -860,15 +1048,15 @@ namespace rstartree
 
 					// AT4 [Propogate the node split upwards]
 					Branch b(siblingNode->boundingBox(), siblingNode);
-					node->parent->entries.emplace_back(std::move(b));
+					node->parent->branches.push_back(b);
+					node->parent->propagateCount(siblingNode->subtreeCount());
 #ifndef NDEBUG
-					for (const auto &entry : node->parent->entries)
+					for (const Branch &branch : node->parent->branches)
 					{
-						assert(std::holds_alternative<Branch>(entry));
-						assert(std::get<Branch>(entry).child->level + 1 == node->parent->level);
+						assert(node->childOf(branch)->level + 1 == node->parent->level);
 					}
 #endif
-					if (node->parent->entries.size() > node->parent->treeRef.maxBranchFactor)
+					if (node->parent->branches.size() > node->parent->treeRef.maxBranchFactor)
 					{
 						Node *parentBefore = node->parent;
 						Node *siblingParent = node->parent->overflowTreatment(hasReinsertedOnLevel);
@@ -920,17 +1108,8 @@ namespace rstartree
 
 		assert(hasReinsertedOnLevel.at(level));
 
-		std::sort(entries.begin(), entries.end(),
-			[&globalCenterPoint](NodeEntry &a, NodeEntry &b)
-			{
-				Rectangle rectA = boxFromNodeEntry(a);
-				Rectangle rectB = boxFromNodeEntry(b);
-				return rectA.centrePoint().distance(globalCenterPoint) > rectB.centrePoint().distance(globalCenterPoint);
-			});
-
 		// 3. RI3 Remove the first p entries from N and adjust the bounding box -> OK so we need to adjust the data model
 		//		to include a specified "p" value -> this should be unique to the node -> so it's a node variable
-		unsigned numNodesToReinsert = treeRef.p * entries.size();
 
 		// 4. Insert the removed entries -> OK we can also specify a flag that is
 		//		if you want to reinsert starting with largest values (i.e. start at index 0) or closest values (Start at index p)
@@ -945,23 +1124,57 @@ namespace rstartree
 		// We need to reinsert these entries
 		// We pop them all off before hand so that any reorganization of the tree during this recursive
 		// insert does not affect which entries get popped off
-		std::vector<NodeEntry> entriesToReinsert;
-		entriesToReinsert.reserve(numNodesToReinsert);
-
-		std::copy(entries.begin(), entries.begin() + numNodesToReinsert, std::back_inserter(entriesToReinsert));
-		entries.erase(entries.begin(), entries.begin() + numNodesToReinsert);
 
 		// During this recursive insert (we are already in an insert, since we are reInserting), we
 		// may end up here again. If we do, we should still be using the same hasReinsertedOnLevel
 		// vector because it corresponds to the activities we have performed during a single
 		// point/rectangle insertion (the top level one)
 
-		for (const NodeEntry entry : entriesToReinsert)
+		if (isLeafNode())
+		{
+			std::sort(data.begin(), data.end(),
+				[&globalCenterPoint](const Point &a, const Point &b)
+				{
+					return a.distance(globalCenterPoint) > b.distance(globalCenterPoint);
+				});
+
+			unsigned numNodesToReinsert = treeRef.p * data.size();
+			std::vector<Point> pointsToReinsert(data.begin(), data.begin() + numNodesToReinsert);
+			data.erase(data.begin(), data.begin() + numNodesToReinsert);
+			propagateCount(-(int) numNodesToReinsert);
+
+			for (const Point &point : pointsToReinsert)
+			{
+				assert(root->parent == nullptr);
+				root = root->insert(point, hasReinsertedOnLevel);
+			}
+		}
+		else
 		{
-			assert(root->parent == nullptr);
-			// TODO: Will this actually do a copy or assume we know what we are doing?
-			root = root->insert(entry, hasReinsertedOnLevel);
+			branches.sort(
+				[&globalCenterPoint](const Branch &a, const Branch &b)
+				{
+					return a.boundingBox.centrePoint().distance(globalCenterPoint) > b.boundingBox.centrePoint().distance(globalCenterPoint);
+				});
+
+			unsigned numNodesToReinsert = treeRef.p * branches.size();
+			std::vector<Branch> branchesToReinsert(branches.begin(), branches.begin() + numNodesToReinsert);
+			branches.erase(0, numNodesToReinsert);
+
+			int reinsertedCount = 0;
+			for (const Branch &branch : branchesToReinsert)
+			{
+				reinsertedCount += branch.count;
+			}
+			propagateCount(-reinsertedCount);
+
+			for (const Branch &branch : branchesToReinsert)
+			{
+				assert(root->parent == nullptr);
+				root = root->insert(branch, hasReinsertedOnLevel);
+			}
 		}
+
 		return nullptr;
 	}
 
@@ -981,31 +1194,47 @@ namespace rstartree
 		}
 	}
 
-	Node *Node::insert(NodeEntry nodeEntry, std::vector<bool> &hasReinsertedOnLevel)
+	Node *Node::insert(const Point &givenPoint, std::vector<bool> &hasReinsertedOnLevel)
 	{
 		// Always called on root, this = root
 		assert(parent == nullptr);
 
 		// I1 [Find position for new record]
-		Node *insertionPoint = chooseSubtree(nodeEntry);
-		Node *sibling = nullptr;
+		Node *insertionPoint = chooseSubtree(givenPoint);
 
 		// I2 [Add record to leaf node]
-		bool givenIsLeaf = std::holds_alternative<Point>(nodeEntry);
-#ifndef NDEBUG
-		bool firstIsPoint = entries.empty() || std::holds_alternative<Point>(insertionPoint->entries[0]);
-		assert((givenIsLeaf && firstIsPoint) || (!givenIsLeaf && !firstIsPoint));
-#endif
-		insertionPoint->entries.push_back(nodeEntry);
-		if (!givenIsLeaf)
-		{
-			const Branch &b = std::get<Branch>(nodeEntry);
-			assert(insertionPoint->level == b.child->level + 1);
-			b.child->parent = insertionPoint;
-		}
+		assert(insertionPoint->branches.empty());
+		insertionPoint->data.push_back(givenPoint);
+		insertionPoint->propagateCount(1);
+
+		return completeInsertion(insertionPoint, hasReinsertedOnLevel);
+	}
+
+	Node *Node::insert(const Branch &givenBranch, std::vector<bool> &hasReinsertedOnLevel)
+	{
+		// Always called on root, this = root
+		assert(parent == nullptr);
+
+		// I1 [Find position for new record]
+		Node *insertionPoint = chooseSubtree(givenBranch.boundingBox, childOf(givenBranch)->level + 1);
+
+		// I2 [Add record to the node one level above its child]
+		assert(insertionPoint->data.empty());
+		assert(insertionPoint->level == childOf(givenBranch)->level + 1);
+		insertionPoint->branches.push_back(givenBranch);
+		childOf(givenBranch)->parent = insertionPoint;
+		insertionPoint->propagateCount(givenBranch.count);
+
+		return completeInsertion(insertionPoint, hasReinsertedOnLevel);
+	}
+
+	// Called on the root once a new entry sits in insertionPoint, returns the root afterwards
+	Node *Node::completeInsertion(Node *insertionPoint, std::vector<bool> &hasReinsertedOnLevel)
+	{
+		Node *sibling = nullptr;
 
 		// If we exceed treeRef.maxBranchFactor we need to do something about it
-		if (insertionPoint->entries.size() > treeRef.maxBranchFactor) 
+		if (insertionPoint->entryCount() > treeRef.maxBranchFactor) 
 		{
 			// We call overflow treatment to determine how our sibling node is treated if we do a
 			// reInsert, sibling is nullptr. This is properly dealt with in adjustTree
@@ -1020,20 +1249,20 @@ namespace rstartree
 		{
 			assert(this->parent == nullptr);
 
-			Node *newRoot = new Node(treeRef, nullptr, this->level+1);
+			Node *newRoot = treeRef.nodeArena.create(treeRef, nullptr, this->level+1);
 			this->parent = newRoot;
 
 			// Make the existing root a child of newRoot
 			Branch b1(boundingBox(), this);
-			newRoot->entries.emplace_back(std::move(b1));
+			newRoot->branches.push_back(b1);
 
 			// Make the new sibling node a child of newRoot
 			siblingNode->parent = newRoot;
 			Branch b2(siblingNode->boundingBox(), siblingNode);
-			newRoot->entries.emplace_back(std::move(b2));
+			newRoot->branches.push_back(b2);
 
 			// Ensure newRoot has both children
-			assert(newRoot->entries.size() == 2);
+			assert(newRoot->branches.size() == 2);
 			assert(siblingNode->level+1 == newRoot->level);
 
 			// Fix the reinserted length
@@ -1070,15 +1299,16 @@ namespace rstartree
 		Node *node = this;
 
 		// Is Leaf
-		assert(entries.empty() || std::holds_alternative<Point>(entries[0]));
+		assert(branches.empty());
 
-		std::vector<NodeEntry> Q;
+		std::vector<Point> orphanedPoints;
+		std::vector<Branch> orphanedBranches;
 
 		// CT2 [Find parent entry]
 		unsigned entriesSize;
 		while (node->parent != nullptr)
 		{
-			entriesSize = node->entries.size();
+			entriesSize = node->entryCount();
 
 			// CT3 & CT4 [Eliminate under-full node. & Adjust covering rectangle.]
 			if (entriesSize >= node->treeRef.minBranchFactor)
@@ -1093,10 +1323,11 @@ namespace rstartree
 			{
 				// Remove ourselves from our parent
 				node->parent->removeChild(node);
-				assert(!node->entries.empty());
+				assert(node->entryCount() > 0);
 
-				// Push these entries into Q
-				std::copy(node->entries.begin(), node->entries.end(), std::back_inserter(Q));
+				// Push these entries into Q, leaves come first and so their points go in first
+				std::copy(node->data.begin(), node->data.end(), std::back_inserter(orphanedPoints));
+				std::copy(node->branches.begin(), node->branches.end(), std::back_inserter(orphanedBranches));
 
 				// Prepare for garbage collection
 				Node *garbage = node;
@@ -1106,15 +1337,22 @@ namespace rstartree
 				node = node->parent;
 
 				// Cleanup ourselves without deleting children b/c they will be reinserted
-				delete garbage;
+				// Reach the arena through the parent as the garbage may be this very node
+				node->treeRef.nodeArena.destroy(garbage);
 			}
 		}
 
 		// CT6 [Re-insert oprhaned entries]
-		for (const auto &entry : Q)
+		for (const Point &point : orphanedPoints)
+		{
+			assert(node->parent == nullptr);
+			node = node->insert(point, hasReinsertedOnLevel);
+		}
+
+		for (const Branch &branch : orphanedBranches)
 		{
 			assert(node->parent == nullptr);
-			node = node->insert(entry, hasReinsertedOnLevel);
+			node = node->insert(branch, hasReinsertedOnLevel);
 		}
 
 		return node;
@@ -1140,17 +1378,17 @@ namespace rstartree
 		Node *root = leaf->condenseTree(hasReinsertedOnLevel);
 
 		// D4 [Shorten tree]
-		if (root->entries.size() == 1 and !root->isLeafNode())
+		if (root->branches.size() == 1 and !root->isLeafNode())
 		{
 			// Slice the hasReinsertedOnLevel
 			hasReinsertedOnLevel.pop_back();
 
 			// We are removing the root to shorten the tree so we then decide to remove the root
-			Branch &b = std::get<Branch>(root->entries[0]);
+			const Branch &b = root->branches[0];
 
 			// Get rid of the old root
-			Node *child = b.child;
-			delete root;
+			Node *child = childOf(b);
+			treeRef.nodeArena.destroy(root);
 
 			// I'm the root now!
 			child->parent = nullptr;
@@ -1162,6 +1400,67 @@ namespace rstartree
 		}
 	}
 
+	// A node is its level and entry count followed by its points if it is a leaf, or else by the
+	// boxes of its branches and then each child in turn. Branch counts are recomputed.
+	void Node::save(snapshot::Writer &writer) const
+	{
+		writer.write((uint32_t) level);
+		writer.write((uint32_t) entryCount());
+		if (isLeafNode())
+		{
+			writer.write(data.data(), data.size());
+			return;
+		}
+
+		for (const Branch &branch : branches)
+		{
+			writer.write(branch.boundingBox);
+		}
+		for (const Branch &branch : branches)
+		{
+			childOf(branch)->save(writer);
+		}
+	}
+
+	// Always called on a fresh node created at the level its parent expects
+	bool Node::load(snapshot::Reader &reader)
+	{
+		uint32_t loadedLevel;
+		uint32_t loadedEntryCount;
+		if (!reader.read(loadedLevel) || !reader.read(loadedEntryCount) || (parent != nullptr && loadedLevel != level))
+		{
+			return false;
+		}
+		level = loadedLevel;
+
+		if (isLeafNode())
+		{
+			return reader.read(data, loadedEntryCount);
+		}
+
+		std::vector<Rectangle> childBoxes;
+		if (!reader.read(childBoxes, loadedEntryCount))
+		{
+			return false;
+		}
+
+		std::vector<Branch> loadedBranches;
+		loadedBranches.reserve(loadedEntryCount);
+		branches.reserve(treeRef.maxBranchFactor + 1);
+		for (const Rectangle &childBox : childBoxes)
+		{
+			Node *child = treeRef.nodeArena.create(treeRef, this, level - 1);
+			if (!child->load(reader))
+			{
+				return false;
+			}
+			loadedBranches.emplace_back(childBox, child);
+		}
+		branches.assign(loadedBranches);
+
+		return true;
+	}
+
 	void Node::print() const
 	{
 		unsigned max_level = treeRef.root->level;
@@ -1176,17 +1475,16 @@ namespace rstartree
 		bool isLeaf = isLeafNode();
 		if (isLeaf)
 		{
-			for (const auto &entry : entries)
+			for (const Point &dataPoint : data)
 			{
-				std::cout << indentation << "		" << std::get<Point>(entry) << std::endl;
+				std::cout << indentation << "		" << dataPoint << std::endl;
 			}
 		}
 		else
 		{
-			for (const auto &entry : entries)
+			for (const Branch &b : branches)
 			{
-				const Branch &b = std::get<Branch>(entry);
-				std::cout << indentation << "		" << b.boundingBox << ", ptr: " << b.child << std::endl;
+				std::cout << indentation << "		" << b.boundingBox << ", ptr: " << (void *)childOf(b) << std::endl;
 			}
 		}
 		std::cout << std::endl << indentation << "}" << std::endl;
@@ -1220,18 +1518,13 @@ namespace rstartree
 
 			void operator()(Node * const node)
 			{
-				bool isLeaf = node->entries.empty() || std::holds_alternative<Point>(node->entries[0]);
-				if (isLeaf)
+				for (const Point &p : node->data)
 				{
-					for (const auto &entry : node->entries)
+					for (unsigned d = 0; d < dimensions; ++d)
 					{
-						const Point &p = std::get<Point>(entry);
-						for (unsigned d = 0; d < dimensions; ++d)
-						{
-							checksum += (unsigned)p[d];
-						}
+						checksum += (unsigned)p[d];
 					}
-				} 
+				}
 			}
 		};
 
@@ -1274,7 +1567,7 @@ namespace rstartree
 
 			void operator()(Node * const node)
 			{
-				unsigned entriesSize = node->entries.size();
+				unsigned entriesSize = node->entryCount();
 
 				if (entriesSize == 1)
 				{
@@ -1299,20 +1592,20 @@ namespace rstartree
 				else
 				{
 					// Compute the overlap and coverage of our children
-					for (unsigned i = 0; i < node->entries.size(); ++i)
+					for (unsigned i = 0; i < node->branches.size(); ++i)
 					{
-						coverage += boxFromNodeEntry(node->entries[i]).area();
+						coverage += node->branches[i].boundingBox.area();
 
-						for (unsigned j = 0; j < node->entries.size(); ++j)
+						for (unsigned j = 0; j < node->branches.size(); ++j)
 						{
 							if (i != j)
 							{
-								overlap += boxFromNodeEntry(node->entries[i]).computeIntersectionArea(boxFromNodeEntry(node->entries[j]));
+								overlap += node->branches[i].boundingBox.computeIntersectionArea(node->branches[j].boundingBox);
 							}
 						}
 					}
 
-					memoryFootprint += sizeof(Node) + entriesSize * sizeof(Node *) + entriesSize * sizeof(Rectangle);
+					memoryFootprint += sizeof(Node) + entriesSize * sizeof(Branch) + node->branches.packedBytes();
 				}
 			}
 		};
@@ -1322,6 +1615,7 @@ namespace rstartree
 
 		// Print out what we have found
 		STATMEM(sw.memoryFootprint);
+		STATARENA(treeRef.nodeArena.bytes(), treeRef.nodeArena.liveNodes());
 		STATHEIGHT(height());
 		STATSIZE(sw.totalNodes);
 		STATSINGULAR(sw.singularBranches);
@@ -1346,15 +1640,4 @@ namespace rstartree
 		(void) 0;
 #endif
 	}
-
-	Rectangle boxFromNodeEntry(const Node::NodeEntry &entry)
-	{
-		if (std::holds_alternative<Node::Branch>(entry))
-		{
-			return std::get<Node::Branch>(entry).boundingBox;
-		}
-
-		const Point &p = std::get<Point>(entry);
-		return Rectangle(p, p);
-	}
 }
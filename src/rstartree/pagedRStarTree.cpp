@@ -0,0 +1,274 @@
+#include <rstartree/pagedRStarTree.h>
+#include <util/snapshot.h>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace rstartree
+{
+	struct PagedRStarTree::Header
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t dimensions;
+		uint64_t pageBytes;
+		uint64_t pageCount;
+		uint64_t pointCount;
+		uint32_t rootPage;
+		uint32_t height;
+	};
+
+	static constexpr char pagedMagic[8] = {'N', 'I', 'R', 'P', 'A', 'G', 'E', 'D'};
+	static constexpr uint32_t pagedVersion = 1;
+
+	bool PagedRStarTree::build(const RStarTree &tree, const std::string &path, size_t pageBytes)
+	{
+		assert(pageBytes % nodesizing::pageBytes == 0);
+		const size_t leafCount = leafSlots(pageBytes);
+		const size_t branchCount = branchSlots(pageBytes);
+
+		// PB1 [Number the nodes breadth first]
+		// The root is page 1 and the upper levels come first so they share the first few pages,
+		// the children of each node also end up on consecutive pages
+		std::vector<const Node *> nodes = {tree.root};
+		for (size_t i = 0; i < nodes.size(); ++i)
+		{
+			const Node *node = nodes[i];
+			if (node->entryCount() > (node->isLeafNode() ? leafCount : branchCount))
+			{
+				return false;
+			}
+
+			for (const Node::Branch &branch : node->branches)
+			{
+				nodes.push_back(node->childOf(branch));
+			}
+		}
+
+		snapshot::Writer writer(path);
+		std::vector<char> buffer(pageBytes);
+
+		// PB2 [Write the header page]
+		Header header;
+		std::memcpy(header.magic, pagedMagic, sizeof(pagedMagic));
+		header.version = pagedVersion;
+		header.dimensions = dimensions;
+		header.pageBytes = pageBytes;
+		header.pageCount = nodes.size() + 1;
+		header.pointCount = tree.root->subtreeCount();
+		header.rootPage = 1;
+		header.height = tree.root->level + 1;
+		std::memcpy(buffer.data(), &header, sizeof(header));
+		writer.write(buffer.data(), pageBytes);
+
+		// PB3 [Write every node as a page in the same order]
+		// Children were numbered as they were queued so the next unnamed page is the first child
+		uint32_t nextChildPage = 2;
+		for (const Node *node : nodes)
+		{
+			std::fill(buffer.begin(), buffer.end(), 0);
+			Page *nodePage = reinterpret_cast<Page *>(buffer.data());
+			double *column = reinterpret_cast<double *>(nodePage + 1);
+			nodePage->level = node->level;
+			nodePage->count = node->entryCount();
+
+			if (node->isLeafNode())
+			{
+				for (size_t i = 0; i < node->data.size(); ++i)
+				{
+					for (unsigned d = 0; d < dimensions; ++d)
+					{
+						column[d * leafCount + i] = node->data[i][d];
+					}
+				}
+			}
+			else
+			{
+				uint32_t *children = reinterpret_cast<uint32_t *>(column + 2 * dimensions * branchCount);
+				uint32_t *counts = children + branchCount;
+				for (size_t i = 0; i < node->branches.size(); ++i)
+				{
+					const Node::Branch &branch = node->branches[i];
+					for (unsigned d = 0; d < dimensions; ++d)
+					{
+						column[2 * d * branchCount + i] = branch.boundingBox.lowerLeft[d];
+						column[(2 * d + 1) * branchCount + i] = branch.boundingBox.upperRight[d];
+					}
+					children[i] = nextChildPage++;
+					counts[i] = branch.count;
+				}
+			}
+
+			writer.write(buffer.data(), pageBytes);
+		}
+		assert(nextChildPage == nodes.size() + 1);
+
+		return writer.close();
+	}
+
+	PagedRStarTree::PagedRStarTree(const std::string &path) :
+		mapping(nullptr), mappedBytes(0), pageBytes(0), leafCount(0), branchCount(0), rootPage(0)
+	{
+		int file = ::open(path.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return;
+		}
+
+		struct stat fileStatus;
+		if (fstat(file, &fileStatus) == 0 && (size_t) fileStatus.st_size >= sizeof(Header))
+		{
+			void *memory = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_SHARED, file, 0);
+			if (memory != MAP_FAILED)
+			{
+				mapping = static_cast<const char *>(memory);
+				mappedBytes = fileStatus.st_size;
+			}
+		}
+		::close(file);
+
+		if (mapping == nullptr)
+		{
+			return;
+		}
+
+		// Refuse files of another kind, dimension or size rather than search off the mapping
+		const Header &fileHeader = header();
+		if (std::memcmp(fileHeader.magic, pagedMagic, sizeof(pagedMagic)) != 0 || fileHeader.version != pagedVersion || fileHeader.dimensions != dimensions || fileHeader.pageBytes < sizeof(Header) || fileHeader.pageBytes % nodesizing::pageBytes != 0 || fileHeader.pageBytes * fileHeader.pageCount != mappedBytes || fileHeader.rootPage == 0 || fileHeader.rootPage >= fileHeader.pageCount)
+		{
+			munmap(const_cast<char *>(mapping), mappedBytes);
+			mapping = nullptr;
+			mappedBytes = 0;
+			return;
+		}
+
+		pageBytes = fileHeader.pageBytes;
+		leafCount = leafSlots(pageBytes);
+		branchCount = branchSlots(pageBytes);
+		rootPage = fileHeader.rootPage;
+	}
+
+	PagedRStarTree::~PagedRStarTree()
+	{
+		if (mapping != nullptr)
+		{
+			munmap(const_cast<char *>(mapping), mappedBytes);
+		}
+	}
+
+	const PagedRStarTree::Header &PagedRStarTree::header() const
+	{
+		return *reinterpret_cast<const Header *>(mapping);
+	}
+
+	size_t PagedRStarTree::size() const
+	{
+		assert(good());
+
+		return header().pointCount;
+	}
+
+	std::vector<Point> PagedRStarTree::search(const Point &requestedPoint) const
+	{
+		return search(Rectangle(requestedPoint, requestedPoint));
+	}
+
+	std::vector<Point> PagedRStarTree::search(const Rectangle &requestedRectangle) const
+	{
+		std::vector<Point> matchingPoints;
+		search(requestedRectangle, [&matchingPoints](const Point &dataPoint) { matchingPoints.push_back(dataPoint); });
+
+		return matchingPoints;
+	}
+
+	// Stops at children wholly inside the rectangle and adds their counts instead
+	unsigned PagedRStarTree::count(const Rectangle &requestedRectangle) const
+	{
+		assert(good());
+
+		unsigned matchingPoints = 0;
+
+		std::vector<const Page *> &context = QueryContext<const Page>::local().stack;
+		size_t base = context.size();
+		context.push_back(page(rootPage));
+
+		for (;context.size() > base;)
+		{
+			const Page *currentPage = context.back();
+			context.pop_back();
+			const double *column = columns(currentPage);
+
+			if (currentPage->level == 0)
+			{
+				for (size_t i = 0; i < currentPage->count; ++i)
+				{
+					bool inside = true;
+					for (unsigned d = 0; d < dimensions; ++d)
+					{
+						double coordinate = column[d * leafCount + i];
+						inside &= requestedRectangle.lowerLeft[d] <= coordinate && coordinate <= requestedRectangle.upperRight[d];
+					}
+					matchingPoints += inside;
+				}
+			}
+			else
+			{
+				const uint32_t *children = childPages(currentPage);
+				const uint32_t *counts = childCounts(currentPage);
+				for (size_t i = 0; i < currentPage->count; ++i)
+				{
+					bool intersects = true;
+					bool contained = true;
+					for (unsigned d = 0; d < dimensions; ++d)
+					{
+						double lower = column[2 * d * branchCount + i];
+						double upper = column[(2 * d + 1) * branchCount + i];
+						intersects &= lower <= requestedRectangle.upperRight[d] && requestedRectangle.lowerLeft[d] <= upper;
+						contained &= requestedRectangle.lowerLeft[d] <= lower && upper <= requestedRectangle.upperRight[d];
+					}
+
+					if (contained)
+					{
+						matchingPoints += counts[i];
+					}
+					else if (intersects)
+					{
+						context.push_back(page(children[i]));
+					}
+				}
+			}
+		}
+
+		return matchingPoints;
+	}
+
+	// Leaves are found by sweeping the pages in file order rather than by walking the tree
+	unsigned PagedRStarTree::checksum() const
+	{
+		assert(good());
+
+		unsigned sum = 0;
+		for (uint32_t number = 1; number < header().pageCount; ++number)
+		{
+			const Page *nodePage = page(number);
+			if (nodePage->level != 0)
+			{
+				continue;
+			}
+
+			const double *column = columns(nodePage);
+			for (size_t i = 0; i < nodePage->count; ++i)
+			{
+				for (unsigned d = 0; d < dimensions; ++d)
+				{
+					sum += (unsigned) column[d * leafCount + i];
+				}
+			}
+		}
+
+		return sum;
+	}
+}
@@ -2,17 +2,102 @@
 
 namespace rstartree
 {
+	static double entryCentre(const Point &point, unsigned axis)
+	{
+		return point[axis];
+	}
+
+	static double entryCentre(const Node::Branch &branch, unsigned axis)
+	{
+		return (branch.boundingBox.lowerLeft[axis] + branch.boundingBox.upperRight[axis]) / 2.0;
+	}
+
+	// Sort-Tile-Recursive partitioning of entries [begin, end) into nodeCount groups. Each axis
+	// cuts the entries into slabs of whole nodes and the remaining axes tile within each slab.
+	// Group sizes never differ by more than one so that every node ends up at least half full.
+	template <typename Entry>
+	static void strTile(std::vector<Entry> &entries, unsigned begin, unsigned end, unsigned nodeCount, unsigned axis, std::vector<unsigned> &groupEnds)
+	{
+		if (nodeCount == 1)
+		{
+			groupEnds.push_back(end);
+			return;
+		}
+
+		std::sort(entries.begin() + begin, entries.begin() + end,
+			[axis](const Entry &a, const Entry &b)
+			{
+				return entryCentre(a, axis) < entryCentre(b, axis);
+			});
+
+		// The last axis cuts straight into nodes, earlier ones into slabs of nodes
+		unsigned slabCount = nodeCount;
+		if (axis + 1 < dimensions)
+		{
+			slabCount = (unsigned) std::ceil(std::pow((double) nodeCount, 1.0 / (double) (dimensions - axis)));
+			slabCount = std::min(slabCount, nodeCount);
+		}
+
+		unsigned long length = end - begin;
+		unsigned nodesBefore = 0;
+		for (unsigned slab = 0; slab < slabCount; ++slab)
+		{
+			unsigned nodesAfter = (unsigned) (((unsigned long) nodeCount * (slab + 1)) / slabCount);
+			unsigned slabBegin = begin + (unsigned) (length * nodesBefore / nodeCount);
+			unsigned slabEnd = begin + (unsigned) (length * nodesAfter / nodeCount);
+
+			strTile(entries, slabBegin, slabEnd, nodesAfter - nodesBefore, axis + 1, groupEnds);
+
+			nodesBefore = nodesAfter;
+		}
+	}
+
+	// STR3 [Pack each tile into a node of the given level] Returns the branch up to each new node
+	template <typename Entry>
+	static std::vector<Node::Branch> strPack(RStarTree &tree, std::vector<Entry> &entries, unsigned level)
+	{
+		// STR2 [Tile the current level into as few nodes as will hold it]
+		unsigned nodeCount = (entries.size() + tree.maxBranchFactor - 1) / tree.maxBranchFactor;
+		std::vector<unsigned> groupEnds;
+		strTile(entries, 0, entries.size(), nodeCount, 0, groupEnds);
+
+		std::vector<Node::Branch> parentEntries;
+		parentEntries.reserve(nodeCount);
+		unsigned groupBegin = 0;
+		for (unsigned groupEnd : groupEnds)
+		{
+			Node *node = tree.nodeArena.create(tree, nullptr, level);
+
+			if constexpr (std::is_same<Entry, Point>::value)
+			{
+				node->data.assign(entries.begin() + groupBegin, entries.begin() + groupEnd);
+			}
+			else
+			{
+				node->branches.assign(entries.begin() + groupBegin, entries.begin() + groupEnd);
+				for (const Node::Branch &branch : node->branches)
+				{
+					node->childOf(branch)->parent = node;
+				}
+			}
+
+			parentEntries.emplace_back(node->boundingBox(), node);
+			groupBegin = groupEnd;
+		}
+
+		return parentEntries;
+	}
+
 	RStarTree::RStarTree(unsigned minBranchFactor, unsigned maxBranchFactor) : minBranchFactor(minBranchFactor), maxBranchFactor(maxBranchFactor)
 	{
 		hasReinsertedOnLevel = {false};
-		root = new Node(*this);
+		root = nodeArena.create(*this);
 		root->level = 0;
 	}
 
 	RStarTree::~RStarTree()
 	{
-		root->deleteSubtrees();
-		delete root;
+		// The node arena tears every node down in one sweep
 	}
 
 	std::vector<Point> RStarTree::exhaustiveSearch(Point requestedPoint)
@@ -23,33 +108,147 @@ namespace rstartree
 		return v;
 	}
 
-	std::vector<Point> RStarTree::search(Point requestedPoint) CONST_IF_NOT_STAT
+	std::vector<Point> RStarTree::search(Point requestedPoint) const
 	{
+		ALLOCSCOPE(allocationProfile, Search);
 		assert(root->parent == nullptr);
 
 		return root->search(requestedPoint);
 	}
 
-	std::vector<Point> RStarTree::search(Rectangle requestedRectangle) CONST_IF_NOT_STAT
+	std::vector<Point> RStarTree::search(Rectangle requestedRectangle) const
 	{
+		ALLOCSCOPE(allocationProfile, RangeSearch);
 		return root->search(requestedRectangle);
 	}
 
+	void RStarTree::searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const
+	{
+		search(requestedRectangle, [visit, visitor](const Point &p) { visit(visitor, p); });
+	}
+
+	std::vector<Point> RStarTree::nearest(const Point &givenPoint, unsigned k) const
+	{
+		return root->nearest(givenPoint, k);
+	}
+
+	std::vector<std::vector<Point>> RStarTree::searchBatch(const std::vector<Rectangle> &requestedRectangles) const
+	{
+		std::vector<std::vector<Point>> accumulators(requestedRectangles.size());
+		root->searchBatch(requestedRectangles, accumulators);
+
+		return accumulators;
+	}
+
+	unsigned RStarTree::count(const Rectangle &requestedRectangle) const
+	{
+		return root->count(requestedRectangle);
+	}
+
 	void RStarTree::insert(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Insert);
 		assert(root->parent == nullptr);
 
 		std::fill(hasReinsertedOnLevel.begin(), hasReinsertedOnLevel.end(), false);
 		root = root->insert(givenPoint, hasReinsertedOnLevel);
 	}
 
+	void RStarTree::bulkLoad(std::vector<Point> &points)
+	{
+		// Packing only makes sense from scratch
+		assert(root->parent == nullptr && root->isLeafNode() && root->entryCount() == 0);
+
+		if (points.empty())
+		{
+			return;
+		}
+
+		nodeArena.destroy(root);
+
+		// STR1 [Initialize] Every point becomes a leaf level entry
+		std::vector<Point> leafEntries(points.begin(), points.end());
+		std::vector<Node::Branch> entries = strPack(*this, leafEntries, 0);
+
+		// STR4 [Stop once a single node covers everything]
+		for (unsigned level = 1; entries.size() > 1; ++level)
+		{
+			entries = strPack(*this, entries, level);
+		}
+
+		root = nodeArena[entries[0].child];
+		hasReinsertedOnLevel.assign(root->level + 1, false);
+	}
+
+	void RStarTree::insertBatch(const std::vector<Point> &points)
+	{
+		// IB1 [Order the batch along the Hilbert curve so consecutive points share leaves]
+		std::vector<Point> sortedPoints(points);
+		hilbert::sort(sortedPoints);
+
+		Node *leafHint = nullptr;
+		LeafHintPolicy policy;
+		Rectangle leafHintBox;
+
+		for (const Point &point : sortedPoints)
+		{
+			// IB2 [Reuse the last leaf if it covers the point and has room]
+			// No bounding box changes so there is nothing to propagate upward
+			if (leafHint != nullptr && leafHint->data.size() < maxBranchFactor && leafHintBox.containsPoint(point))
+			{
+				leafHint->data.push_back(point);
+				leafHint->propagateCount(1);
+				policy.hit();
+				continue;
+			}
+
+			// IB3 [Otherwise insert normally and refresh the hint unless hints keep going unused]
+			insert(point);
+			leafHint = nullptr;
+			if (policy.shouldRefresh())
+			{
+				leafHint = root->findLeaf(point);
+				leafHintBox = leafHint->boundingBox();
+			}
+		}
+	}
+
 	void RStarTree::remove(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Remove);
 		std::fill(hasReinsertedOnLevel.begin(), hasReinsertedOnLevel.end(), false);
 		root = root->remove(givenPoint, hasReinsertedOnLevel);
         assert(root->parent == nullptr);
 	}
 
+	bool RStarTree::save(const std::string &path) const
+	{
+		snapshot::Writer writer(path);
+		snapshot::writeHeader(writer, snapshot::RStarTreeTag, minBranchFactor, maxBranchFactor);
+		root->save(writer);
+
+		return writer.close();
+	}
+
+	bool RStarTree::load(const std::string &path)
+	{
+		snapshot::Reader reader(path);
+		nodeArena.clear();
+		root = nodeArena.create(*this);
+
+		if (!snapshot::readHeader(reader, snapshot::RStarTreeTag, minBranchFactor, maxBranchFactor) || !root->load(reader) || !reader.atEnd())
+		{
+			nodeArena.clear();
+			root = nodeArena.create(*this);
+			hasReinsertedOnLevel = {false};
+			return false;
+		}
+
+		hasReinsertedOnLevel.assign(root->level + 1, false);
+
+		return true;
+	}
+
 	unsigned RStarTree::checksum()
 	{
 		return root->checksum();
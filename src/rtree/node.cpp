@@ -3,44 +3,15 @@
 
 namespace rtree
 {
-	Node::Node(RTree &treeRef) :
+	Node::Node(RTree &treeRef, Node *p) :
 		treeRef(treeRef)
 	{
-		minBranchFactor = 3;
-		maxBranchFactor = 5;
-		parent = nullptr;
-		boundingBoxes.resize(0);
-		children.resize(0);
-		data.resize(0);
-	}
-
-	Node::Node(RTree &treeRef, unsigned minBranchFactor, unsigned maxBranchFactor, Node *p) :
-		treeRef(treeRef)
-	{
-		this->minBranchFactor = minBranchFactor;
-		this->maxBranchFactor = maxBranchFactor;
 		this->parent = p;
-		boundingBoxes.resize(0);
+		boundingBoxes.clear();
 		children.resize(0);
 		data.resize(0);
 	}
 
-	void Node::deleteSubtrees()
-	{
-		if (children.size() == 0)
-		{
-			return;
-		}
-		else
-		{
-			for (unsigned i = 0; i < children.size(); ++i)
-			{
-				children[i]->deleteSubtrees();
-				delete children[i];
-			}
-		}
-	}
-
 	Rectangle Node::boundingBox()
 	{
 		Rectangle boundingBox;
@@ -72,7 +43,7 @@ namespace rtree
 		{
 			if (children[i] == child)
 			{
-				boundingBoxes[i] = updatedBoundingBox;
+				boundingBoxes.set(i, updatedBoundingBox);
 				break;
 			}
 		}
@@ -85,7 +56,7 @@ namespace rtree
 		{
 			if (children[i] == child)
 			{
-				boundingBoxes.erase(boundingBoxes.begin() + i);
+				boundingBoxes.erase(i);
 				children.erase(children.begin() + i);
 				break;
 			}
@@ -131,14 +102,14 @@ namespace rtree
 		}
 	}
 
-	std::vector<Point> Node::search(Point &requestedPoint)
+	std::vector<Point> Node::search(const Point &requestedPoint) const
 	{
 		std::vector<Point> matchingPoints;
 
 		// Initialize our context stack
-		std::stack<Node *> context;
+		std::stack<const Node *> context;
 		context.push(this);
-		Node *currentContext;
+		const Node *currentContext;
 
 		for (;!context.empty();)
 		{
@@ -162,14 +133,11 @@ namespace rtree
 			else
 			{
 				// Determine which branches we need to follow
-				for (unsigned i = 0; i < currentContext->boundingBoxes.size(); ++i)
+				currentContext->boundingBoxes.forEachContaining(requestedPoint, [&](size_t i)
 				{
-					if (currentContext->boundingBoxes[i].containsPoint(requestedPoint))
-					{
-						// Add to the nodes we will check
-						context.push(currentContext->children[i]);
-					}
-				}
+					// Add to the nodes we will check
+					context.push(currentContext->children[i]);
+				});
 #ifdef STAT
 				treeRef.stats.markNonLeafNodeSearched();
 #endif
@@ -183,14 +151,14 @@ namespace rtree
 		return matchingPoints;
 	}
 
-	std::vector<Point> Node::search(Rectangle &requestedRectangle)
+	std::vector<Point> Node::search(const Rectangle &requestedRectangle) const
 	{
 		std::vector<Point> matchingPoints;
 
 		// Initialize our context stack
-		std::stack<Node *> context;
+		std::stack<const Node *> context;
 		context.push(this);
-		Node *currentContext;
+		const Node *currentContext;
 
 		for (;!context.empty();)
 		{
@@ -214,14 +182,11 @@ namespace rtree
 			else
 			{
 				// Determine which branches we need to follow
-				for (unsigned i = 0; i < currentContext->boundingBoxes.size(); ++i)
+				currentContext->boundingBoxes.forEachIntersecting(requestedRectangle, [&](size_t i)
 				{
-					if (currentContext->boundingBoxes[i].intersectsRectangle(requestedRectangle))
-					{
-						// Add to the nodes we will check
-						context.push(currentContext->children[i]);
-					}
-				}
+					// Add to the nodes we will check
+					context.push(currentContext->children[i]);
+				});
 #ifdef STAT
 				treeRef.stats.markNonLeafNodeSearched();
 #endif
@@ -341,14 +306,11 @@ namespace rtree
 			{
 				// FL1 [Search subtrees]
 				// Determine which branches we need to follow
-				for (unsigned i = 0; i < currentContext->boundingBoxes.size(); ++i)
+				currentContext->boundingBoxes.forEachContaining(givenPoint, [&](size_t i)
 				{
-					if (currentContext->boundingBoxes[i].containsPoint(givenPoint))
-					{
-						// Add the child to the nodes we will consider
-						context.push(currentContext->children[i]);
-					}
-				}
+					// Add the child to the nodes we will consider
+					context.push(currentContext->children[i]);
+				});
 			}
 		}
 
@@ -366,8 +328,7 @@ namespace rtree
 	{
 		toRectangles.push_back(boundingBoxes[fromIndex]);
 		toChildren.push_back(children[fromIndex]);
-		boundingBoxes[fromIndex] = boundingBoxes.back();
-		boundingBoxes.pop_back();
+		boundingBoxes.removeAt(fromIndex);
 		children[fromIndex] = children.back();
 		children.pop_back();
 	}
@@ -429,23 +390,23 @@ namespace rtree
 		groupBChildren.push_back(children[seedB]);
 		if (seedA > seedB)
 		{
-			boundingBoxes.erase(boundingBoxes.begin() + seedA);
+			boundingBoxes.erase(seedA);
 			children.erase(children.begin() + seedA);
-			boundingBoxes.erase(boundingBoxes.begin() + seedB);
+			boundingBoxes.erase(seedB);
 			children.erase(children.begin() + seedB);
 		}
 		else
 		{
-			boundingBoxes.erase(boundingBoxes.begin() + seedB);
+			boundingBoxes.erase(seedB);
 			children.erase(children.begin() + seedB);
-			boundingBoxes.erase(boundingBoxes.begin() + seedA);
+			boundingBoxes.erase(seedA);
 			children.erase(children.begin() + seedA);
 		}
 
 		// Go through the remaining entries and add them to groupA or groupB
 		double groupAAffinity, groupBAffinity;
 		// QS2 [Check if done]
-		for (;!boundingBoxes.empty() && (groupABoundingBoxes.size() + boundingBoxes.size() > minBranchFactor) && (groupBBoundingBoxes.size() + boundingBoxes.size() > minBranchFactor);)
+		for (;!boundingBoxes.empty() && (groupABoundingBoxes.size() + boundingBoxes.size() > treeRef.minBranchFactor) && (groupBBoundingBoxes.size() + boundingBoxes.size() > treeRef.minBranchFactor);)
 		{
 			// PN1 [Determine the cost of putting each entry in each group]
 			unsigned groupAIndex = 0;
@@ -503,27 +464,27 @@ namespace rtree
 
 		// If we stopped because half the entries were assigned then great put the others in the
 		// opposite group
-		if (groupABoundingBoxes.size() + boundingBoxes.size() == minBranchFactor)
+		if (groupABoundingBoxes.size() + boundingBoxes.size() == treeRef.minBranchFactor)
 		{
 			groupABoundingBoxes.insert(groupABoundingBoxes.end(), boundingBoxes.begin(), boundingBoxes.end());
 			groupAChildren.insert(groupAChildren.end(), children.begin(), children.end());
 		}
-		else if (groupBBoundingBoxes.size() + boundingBoxes.size() == minBranchFactor)
+		else if (groupBBoundingBoxes.size() + boundingBoxes.size() == treeRef.minBranchFactor)
 		{
 			groupBBoundingBoxes.insert(groupBBoundingBoxes.end(), boundingBoxes.begin(), boundingBoxes.end());
 			groupBChildren.insert(groupBChildren.end(), children.begin(), children.end());
 		}
 		else
 		{
-			// We really shouldn't be here so panic!
-			assert(false);
+			// Otherwise every entry already found a group of its own
+			assert(boundingBoxes.empty());
 		}
 
 		// Create the new node and fill it
-		Node *newSibling = new Node(treeRef, minBranchFactor, maxBranchFactor, parent);
+		Node *newSibling = treeRef.nodeArena.create(treeRef, parent);
 
 		// Fill us with groupA and the new node with groupB
-		boundingBoxes = std::move(groupABoundingBoxes);
+		boundingBoxes.assign(groupABoundingBoxes);
 		children = std::move(groupAChildren);
 #ifndef NDEBUG
 		for (Node *child : children)
@@ -532,7 +493,7 @@ namespace rtree
 		}
 #endif
 
-		newSibling->boundingBoxes = std::move(groupBBoundingBoxes);
+		newSibling->boundingBoxes.assign(groupBBoundingBoxes);
 		newSibling->children = std::move(groupBChildren);
 		for (Node *child : newSibling->children)
 		{
@@ -607,7 +568,7 @@ namespace rtree
 		// Go through the remaining entries and add them to groupA or groupB
 		double groupAAffinity, groupBAffinity;
 		// QS2 [Check if done]
-		for (;!data.empty() && (groupAData.size() + data.size() > minBranchFactor) && (groupBData.size() + data.size() > minBranchFactor);)
+		for (;!data.empty() && (groupAData.size() + data.size() > treeRef.minBranchFactor) && (groupBData.size() + data.size() > treeRef.minBranchFactor);)
 		{
 			// PN1 [Determine the cost of putting each entry in each group]
 			unsigned groupAIndex = 0;
@@ -665,22 +626,22 @@ namespace rtree
 
 		// If we stopped because half the entries were assigned then great put the others in the
 		// opposite group
-		if (groupAData.size() + data.size() == minBranchFactor)
+		if (groupAData.size() + data.size() == treeRef.minBranchFactor)
 		{
 			groupAData.insert(groupAData.end(), data.begin(), data.end());
 		}
-		else if (groupBData.size() + data.size() == minBranchFactor)
+		else if (groupBData.size() + data.size() == treeRef.minBranchFactor)
 		{
 			groupBData.insert(groupBData.end(), data.begin(), data.end());
 		}
 		else
 		{
-			// We really shouldn't be here so panic!
-			assert(false);
+			// Otherwise every entry already found a group of its own
+			assert(data.empty());
 		}
 
 		// Create the new node and fill it
-		Node *newSibling = new Node(treeRef, minBranchFactor, maxBranchFactor, parent);
+		Node *newSibling = treeRef.nodeArena.create(treeRef, parent);
 
 		// Fill us with groupA and the new node with groupB
 		data = std::move(groupAData);
@@ -712,7 +673,7 @@ namespace rtree
 				if (siblingNode != nullptr)
 				{
 					// AT4 [Propagate the node split upwards]
-					if (node->parent->children.size() < node->parent->maxBranchFactor)
+					if (node->parent->children.size() < treeRef.maxBranchFactor)
 					{
 						node->parent->boundingBoxes.push_back(siblingNode->boundingBox());
 						node->parent->children.push_back(siblingNode);
@@ -723,9 +684,11 @@ namespace rtree
 					}
 					else
 					{
-						Node *siblingParent = node->parent->splitNode(siblingNode);
+						// The split may move node under the new sibling so remember which parent split
+						Node *splitParent = node->parent;
+						Node *siblingParent = splitParent->splitNode(siblingNode);
 
-						node = node->parent;
+						node = splitParent;
 						siblingNode = siblingParent;
 					}
 				}
@@ -740,6 +703,45 @@ namespace rtree
 		return siblingNode;
 	}
 
+	// Best-first k nearest neighbour search, closest first
+	std::vector<Point> Node::nearest(const Point &givenPoint, unsigned k) const
+	{
+		std::vector<Point> neighbours;
+		NearestQueue<const Node *> queue;
+		queue.pushNode(0.0, this);
+
+		// Points only come off the queue once nothing closer can still be found
+		for (;!queue.empty() && neighbours.size() < k;)
+		{
+			NearestQueue<const Node *>::Entry entry = queue.pop();
+
+			if (entry.isPoint)
+			{
+				neighbours.push_back(entry.point);
+				continue;
+			}
+
+			const Node *currentContext = entry.node;
+
+			if (currentContext->children.size() == 0)
+			{
+				for (const Point &dataPoint : currentContext->data)
+				{
+					queue.pushPoint(dataPoint.distance(givenPoint), dataPoint);
+				}
+			}
+			else
+			{
+				for (unsigned i = 0; i < currentContext->boundingBoxes.size(); ++i)
+				{
+					queue.pushNode(currentContext->boundingBoxes[i].minDistance(givenPoint), currentContext->children[i]);
+				}
+			}
+		}
+
+		return neighbours;
+	}
+
 	// Always called on root, this = root
 	Node *Node::insert(Point givenPoint)
 	{
@@ -748,7 +750,7 @@ namespace rtree
 		Node *siblingLeaf = nullptr;
 
 		// I2 [Add record to leaf node]
-		if (leaf->data.size() < leaf->maxBranchFactor)
+		if (leaf->data.size() < treeRef.maxBranchFactor)
 		{
 			leaf->data.push_back(givenPoint);
 		}
@@ -763,7 +765,7 @@ namespace rtree
 		// I4 [Grow tree taller]
 		if (siblingNode != nullptr)
 		{
-			Node *newRoot = new Node(treeRef, minBranchFactor, maxBranchFactor);
+			Node *newRoot = treeRef.nodeArena.create(treeRef);
 
 			this->parent = newRoot;
 			newRoot->boundingBoxes.push_back(this->boundingBox());
@@ -795,7 +797,7 @@ namespace rtree
 		Node *siblingNode = nullptr;
 
 		// I2 [Add record to node]
-		if (node->children.size() < node->maxBranchFactor)
+		if (node->children.size() < treeRef.maxBranchFactor)
 		{
 			e.child->parent = node;
 			node->boundingBoxes.push_back(e.boundingBox);
@@ -812,7 +814,7 @@ namespace rtree
 		// I4 [Grow tree taller]
 		if (siblingNode != nullptr)
 		{
-			Node *newRoot = new Node(treeRef, minBranchFactor, maxBranchFactor);
+			Node *newRoot = treeRef.nodeArena.create(treeRef);
 
 			this->parent = newRoot;
 			newRoot->boundingBoxes.push_back(this->boundingBox());
@@ -846,7 +848,7 @@ namespace rtree
 			nodeBoundingBoxesSize = node->boundingBoxes.size();
 			nodeDataSize = node->data.size();
 			// CT3 & CT4 [Eliminate under-full node. & Adjust covering rectangle.]
-			if (nodeBoundingBoxesSize >= node->minBranchFactor || nodeDataSize >= node->minBranchFactor)
+			if (nodeBoundingBoxesSize >= node->treeRef.minBranchFactor || nodeDataSize >= node->treeRef.minBranchFactor)
 			{
 				node->parent->updateBoundingBox(node, node->boundingBox());
 
@@ -887,7 +889,8 @@ namespace rtree
 				level++;
 
 				// Cleanup ourselves without deleting children b/c they will be reinserted
-				delete garbage;
+				// Reach the arena through the parent as the garbage may be this very node
+				node->treeRef.nodeArena.destroy(garbage);
 			}
 		}
 
@@ -900,6 +903,95 @@ namespace rtree
 		return node;
 	}
 
+	// Always called on an empty root, this = root
+	Node *Node::bulkLoad(std::vector<Point> &points)
+	{
+		assert(parent == nullptr && children.empty() && data.empty());
+
+		if (points.empty())
+		{
+			return this;
+		}
+
+		// HP1 [Order the points along the Hilbert curve]
+		hilbert::sort(points);
+
+		// HP2 [Pack runs of points into leaves]
+		// Runs are spread evenly over as few nodes as will hold them so that no node falls under
+		// the minimum fill
+		unsigned nodeCount = (points.size() + treeRef.maxBranchFactor - 1) / treeRef.maxBranchFactor;
+		std::vector<Node *> level;
+		level.reserve(nodeCount);
+		for (unsigned i = 0; i < nodeCount; ++i)
+		{
+			Node *leaf = treeRef.nodeArena.create(treeRef);
+			leaf->data.assign(points.begin() + ((unsigned long) points.size() * i) / nodeCount, points.begin() + ((unsigned long) points.size() * (i + 1)) / nodeCount);
+			level.push_back(leaf);
+		}
+
+		// HP3 [Pack runs of nodes into parents until a single root remains]
+		// Children stay in Hilbert order so consecutive runs remain spatially close
+		while (level.size() > 1)
+		{
+			nodeCount = (level.size() + treeRef.maxBranchFactor - 1) / treeRef.maxBranchFactor;
+			std::vector<Node *> parents;
+			parents.reserve(nodeCount);
+			for (unsigned i = 0; i < nodeCount; ++i)
+			{
+				Node *node = treeRef.nodeArena.create(treeRef);
+				unsigned childrenEnd = ((unsigned long) level.size() * (i + 1)) / nodeCount;
+				for (unsigned j = ((unsigned long) level.size() * i) / nodeCount; j < childrenEnd; ++j)
+				{
+					level[j]->parent = node;
+					node->boundingBoxes.push_back(level[j]->boundingBox());
+					node->children.push_back(level[j]);
+				}
+				parents.push_back(node);
+			}
+			level.swap(parents);
+		}
+
+		treeRef.nodeArena.destroy(this);
+
+		return level[0];
+	}
+
+	// Always called on root, this = root
+	Node *Node::insertBatch(const std::vector<Point> &points)
+	{
+		// IB1 [Order the batch along the Hilbert curve so consecutive points share leaves]
+		std::vector<Point> sortedPoints(points);
+		hilbert::sort(sortedPoints);
+
+		Node *root = this;
+		Node *leafHint = nullptr;
+		LeafHintPolicy policy;
+		Rectangle leafHintBox;
+
+		for (const Point &point : sortedPoints)
+		{
+			// IB2 [Reuse the last leaf if it covers the point and has room]
+			// No bounding box changes so there is nothing to propagate upward
+			if (leafHint != nullptr && leafHint->data.size() < leafHint->treeRef.maxBranchFactor && leafHintBox.containsPoint(point))
+			{
+				leafHint->data.push_back(point);
+				policy.hit();
+				continue;
+			}
+
+			// IB3 [Otherwise insert normally and refresh the hint unless hints keep going unused]
+			root = root->insert(point);
+			leafHint = nullptr;
+			if (policy.shouldRefresh())
+			{
+				leafHint = root->findLeaf(point);
+				leafHintBox = leafHint->boundingBox();
+			}
+		}
+
+		return root;
+	}
+
 	// Always called on root, this = root
 	Node *Node::remove(Point givenPoint)
 	{
@@ -929,13 +1021,68 @@ namespace rtree
 		}
 	}
 
+	// A node is its child count followed by the boxes of its children and then each child in
+	// turn, or for a leaf a child count of zero followed by its point count and points
+	void Node::save(snapshot::Writer &writer) const
+	{
+		writer.write((uint32_t) children.size());
+		if (children.empty())
+		{
+			writer.write((uint32_t) data.size());
+			writer.write(data.data(), data.size());
+			return;
+		}
+
+		const std::vector<Rectangle> &childBoxes = boundingBoxes;
+		writer.write(childBoxes.data(), childBoxes.size());
+		for (const Node *child : children)
+		{
+			child->save(writer);
+		}
+	}
+
+	// Always called on a fresh node
+	bool Node::load(snapshot::Reader &reader)
+	{
+		uint32_t childCount;
+		if (!reader.read(childCount))
+		{
+			return false;
+		}
+
+		if (childCount == 0)
+		{
+			uint32_t dataCount;
+			return reader.read(dataCount) && reader.read(data, dataCount);
+		}
+
+		std::vector<Rectangle> childBoxes;
+		if (!reader.read(childBoxes, childCount))
+		{
+			return false;
+		}
+		boundingBoxes.assign(childBoxes);
+
+		children.reserve(childCount);
+		for (uint32_t i = 0; i < childCount; ++i)
+		{
+			children.push_back(treeRef.nodeArena.create(treeRef, this));
+			if (!children.back()->load(reader))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	bool Node::validate(Node *expectedParent, unsigned index)
 	{
-		if (parent != expectedParent || boundingBoxes.size() > maxBranchFactor || data.size() > maxBranchFactor || boundingBoxes.size() != children.size())
+		if (parent != expectedParent || boundingBoxes.size() > treeRef.maxBranchFactor || data.size() > treeRef.maxBranchFactor || boundingBoxes.size() != children.size())
 		{
 			std::cout << "node = " << (void *)this << std::endl;
 			std::cout << "parent = " << (void *)parent << " expectedParent = " << (void *)expectedParent << std::endl;
-			std::cout << "maxBranchFactor = " << maxBranchFactor << std::endl;
+			std::cout << "maxBranchFactor = " << treeRef.maxBranchFactor << std::endl;
 			std::cout << "boundingBoxes.size() = " << boundingBoxes.size() << std::endl;
 			std::cout << "children.size() = " << children.size() << std::endl;
 			std::cout << "data.size() = " << data.size() << std::endl;
@@ -1058,9 +1205,10 @@ namespace rtree
 		unsigned long totalNodes = 1;
 		unsigned long singularBranches = 0;
 		unsigned long totalLeaves = 0;
+		unsigned long totalEntries = 0;
 
 		std::vector<unsigned long> histogramFanout;
-		histogramFanout.resize(maxBranchFactor + 10, 0);
+		histogramFanout.resize(treeRef.maxBranchFactor + 10, 0);
 
 		double coverage = 0.0;
 		double overlap = 0.0;
@@ -1078,6 +1226,7 @@ namespace rtree
 			childrenSize = currentContext->children.size();
 			dataSize = currentContext->data.size();
 			unsigned fanout = childrenSize == 0 ? dataSize : childrenSize;
+			totalEntries += fanout;
 			if (unlikely(fanout >= histogramFanout.size()))
 			{
 				histogramFanout.resize(2*fanout,0);
@@ -1106,7 +1255,7 @@ namespace rtree
 			else
 			{
 				totalNodes += childrenSize;
-				memoryFootprint += sizeof(Node) + childrenSize * sizeof(Node *) + currentContext->boundingBoxes.size() * sizeof(Rectangle);
+				memoryFootprint += sizeof(Node) + childrenSize * sizeof(Node *) + currentContext->boundingBoxes.size() * sizeof(Rectangle) + currentContext->boundingBoxes.packedBytes();
 				// Determine which branches we need to follow
 				for (unsigned i = 0; i < currentContext->boundingBoxes.size(); ++i)
 				{
@@ -1122,6 +1271,7 @@ namespace rtree
 
 		// Print out statistics
 		STATMEM(memoryFootprint);
+		STATARENA(treeRef.nodeArena.bytes(), treeRef.nodeArena.liveNodes());
 		STATHEIGHT(height());
 		STATSIZE(totalNodes);
 		STATSINGULAR(singularBranches);
@@ -1131,6 +1281,8 @@ namespace rtree
 		STATOVERLAP(overlap);
 		STATAVGCOVER(coverage / totalNodes);
 		STATAVGOVERLAP(overlap /totalNodes);
+		STATBUILDTIME(treeRef.buildTime);
+		STATUTILIZATION((double) totalEntries / (double) (totalNodes * treeRef.maxBranchFactor));
 		STATFANHIST();
 		for (unsigned i = 0; i < histogramFanout.size(); ++i)
 		{
@@ -2,20 +2,14 @@
 
 namespace rtree
 {
-	RTree::RTree(unsigned minBranchFactor, unsigned maxBranchFactor)
+	RTree::RTree(unsigned minBranchFactor, unsigned maxBranchFactor) : minBranchFactor(minBranchFactor), maxBranchFactor(maxBranchFactor)
 	{
-		root = new Node(*this, minBranchFactor, maxBranchFactor);
-	}
-
-	RTree::RTree(Node *root)
-	{
-		this->root = root;
+		root = nodeArena.create(*this);
 	}
 
 	RTree::~RTree()
 	{
-		root->deleteSubtrees();
-		delete root;
+		// The node arena tears every node down in one sweep
 	}
 
 	std::vector<Point> RTree::exhaustiveSearch(Point requestedPoint)
@@ -26,26 +20,93 @@ namespace rtree
 		return v;
 	}
 
-	std::vector<Point> RTree::search(Point requestedPoint) CONST_IF_NOT_STAT
+	std::vector<Point> RTree::search(Point requestedPoint) const
 	{
+		ALLOCSCOPE(allocationProfile, Search);
 		return root->search(requestedPoint);
 	}
 
-	std::vector<Point> RTree::search(Rectangle requestedRectangle) CONST_IF_NOT_STAT
+	std::vector<Point> RTree::search(Rectangle requestedRectangle) const
 	{
+		ALLOCSCOPE(allocationProfile, RangeSearch);
 		return root->search(requestedRectangle);
 	}
 
+	void RTree::searchVisit(const Rectangle &requestedRectangle, PointVisitor visit, void *visitor) const
+	{
+		search(requestedRectangle, [visit, visitor](const Point &p) { visit(visitor, p); });
+	}
+
+	std::vector<Point> RTree::nearest(const Point &givenPoint, unsigned k) const
+	{
+		return root->nearest(givenPoint, k);
+	}
+
 	void RTree::insert(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Insert);
+#ifdef STAT
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+#endif
 		root = root->insert(givenPoint);
+#ifdef STAT
+		buildTime += std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - begin).count();
+#endif
+	}
+
+	void RTree::bulkLoad(std::vector<Point> &points)
+	{
+#ifdef STAT
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+#endif
+		root = root->bulkLoad(points);
+#ifdef STAT
+		buildTime += std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - begin).count();
+#endif
+	}
+
+	void RTree::insertBatch(const std::vector<Point> &points)
+	{
+#ifdef STAT
+		std::chrono::high_resolution_clock::time_point begin = std::chrono::high_resolution_clock::now();
+#endif
+		root = root->insertBatch(points);
+#ifdef STAT
+		buildTime += std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::high_resolution_clock::now() - begin).count();
+#endif
 	}
 
 	void RTree::remove(Point givenPoint)
 	{
+		ALLOCSCOPE(allocationProfile, Remove);
 		root = root->remove(givenPoint);
 	}
 
+	bool RTree::save(const std::string &path) const
+	{
+		snapshot::Writer writer(path);
+		snapshot::writeHeader(writer, snapshot::RTreeTag, minBranchFactor, maxBranchFactor);
+		root->save(writer);
+
+		return writer.close();
+	}
+
+	bool RTree::load(const std::string &path)
+	{
+		snapshot::Reader reader(path);
+		nodeArena.clear();
+		root = nodeArena.create(*this);
+
+		if (!snapshot::readHeader(reader, snapshot::RTreeTag, minBranchFactor, maxBranchFactor) || !root->load(reader) || !reader.atEnd())
+		{
+			nodeArena.clear();
+			root = nodeArena.create(*this);
+			return false;
+		}
+
+		return true;
+	}
+
 	unsigned RTree::checksum()
 	{
 		return root->checksum();
@@ -21,8 +21,8 @@ TEST_CASE("BMPPrinter: testPrintTree")
 {
     nirtree::NIRTree tree(25,50);
 	nirtree::Node *root = tree.root;
-	nirtree::Node *branchA = new nirtree::Node(tree, 25, 50, root);
-	nirtree::Node *branchB = new nirtree::Node(tree, 25, 50, root);
+	nirtree::Node *branchA = tree.nodeArena.create(tree, root);
+	nirtree::Node *branchB = tree.nodeArena.create(tree, root);
 
 	root->branches.push_back({branchA, IsotheticPolygon(Rectangle(0.1, 0.1, 0.4, 0.4))});
 	root->branches.push_back({branchB, IsotheticPolygon(Rectangle(0.5, 0.5, 0.6, 0.6))});
@@ -1,5 +1,8 @@
 #include <catch2/catch.hpp>
+#include <random>
 #include <util/geometry.h>
+#include <util/leafPoints.h>
+#include <util/packedBoxes.h>
 
 TEST_CASE("Geometry: testPointEquality")
 {
@@ -800,6 +803,17 @@ TEST_CASE("Geometry: testRectangleStrictPointContainment")
 	REQUIRE(!r1.strictContainsPoint(p1));
 }
 
+TEST_CASE("Geometry: testRectangleMinDistance")
+{
+	Rectangle r(0.0, 0.0, 4.0, 2.0);
+
+	REQUIRE(r.minDistance(Point(1.0, 1.0)) == 0.0);
+	REQUIRE(r.minDistance(Point(4.0, 0.0)) == 0.0);
+	REQUIRE(r.minDistance(Point(6.0, 1.0)) == 2.0);
+	REQUIRE(r.minDistance(Point(1.0, -3.0)) == 3.0);
+	REQUIRE(r.minDistance(Point(7.0, 6.0)) == 5.0);
+}
+
 TEST_CASE("Geometry: testRectangleRectangleContainment")
 {
 	// Test set one, general case
@@ -1065,6 +1079,18 @@ TEST_CASE("Geometry: testPolygonContainsPoint")
 	REQUIRE(ip1.containsPoint(p5));
 }
 
+TEST_CASE("Geometry: testPolygonMinDistance")
+{
+	// L-shaped polygon whose bounding box contains the point
+	IsotheticPolygon polygon(Rectangle(0.0, 0.0, 1.0, 4.0));
+	polygon.basicRectangles.push_back(Rectangle(0.0, 0.0, 4.0, 1.0));
+	polygon.boundingBox = Rectangle(0.0, 0.0, 4.0, 4.0);
+
+	REQUIRE(polygon.minDistance(Point(0.5, 3.0)) == 0.0);
+	REQUIRE(polygon.minDistance(Point(3.0, 4.0)) == 2.0);
+	REQUIRE(polygon.minDistance(Point(4.0, 4.0)) == 3.0);
+}
+
 TEST_CASE("Geometry: testPolygonDisjoint")
 {
 	Rectangle r1(0.0, 1.0, 1.0, 5.0);
@@ -1640,3 +1666,199 @@ TEST_CASE("Geometry: testPolygonRefine")
 	REQUIRE(p1.basicRectangles.size() == 1);
 	REQUIRE(p1.basicRectangles[0] == Rectangle(0.0, 0.0, 6.0, 4.0));
 }
+
+TEST_CASE("Geometry: testLeafPointsContained")
+{
+	// Enough points to cover whole SIMD blocks, a ragged tail and a second 64 point block
+	LeafPoints points;
+	std::vector<Point> expected;
+	Rectangle r(2.0, 3.0, 7.5, 9.0);
+	for (unsigned i = 0; i < 103; ++i)
+	{
+		Point p((i * 7 % 11) * 1.0, (i * 5 % 13) * 1.0);
+		points.push_back(p);
+		if (r.containsPoint(p))
+		{
+			expected.push_back(p);
+		}
+	}
+
+	// Removal keeps every column in step with the points
+	points.removeAt(4);
+	points.removeAt(70);
+	std::vector<Point> remaining(points.begin(), points.end());
+	expected.clear();
+	for (Point &p : remaining)
+	{
+		if (r.containsPoint(p))
+		{
+			expected.push_back(p);
+		}
+	}
+
+	std::vector<Point> v;
+	points.forEachContained(r, [&v](const Point &p) { v.push_back(p); });
+	REQUIRE(v.size() == expected.size());
+	REQUIRE(std::is_permutation(v.begin(), v.end(), expected.begin()));
+
+	// Boundaries are inclusive exactly as in Rectangle::containsPoint
+	LeafPoints corners;
+	corners.push_back(r.lowerLeft);
+	corners.push_back(r.upperRight);
+	corners.push_back(Point(7.5000001, 9.0));
+	unsigned matches = 0;
+	corners.forEachContained(r, [&matches](const Point &) { ++matches; });
+	REQUIRE(matches == 2);
+}
+
+TEST_CASE("Geometry: testPackedBoxesIntersecting")
+{
+	// Enough boxes to cover whole SIMD blocks, a ragged tail and a second 64 box block
+	PackedBoxes<Rectangle> boxes;
+	Rectangle r(2.0, 3.0, 7.5, 9.0);
+	for (unsigned i = 0; i < 91; ++i)
+	{
+		double x = (i * 7 % 11) * 1.0;
+		double y = (i * 5 % 13) * 1.0;
+		boxes.push_back(Rectangle(x, y, x + (i % 3) * 0.5, y + (i % 4) * 0.5));
+	}
+
+	// Every kind of change keeps the packed corners in step with the boxes
+	boxes.removeAt(3);
+	boxes.erase(65);
+	boxes.set(10, Rectangle(7.5, 9.0, 8.0, 10.0));
+	boxes.setBoundingBox(11, Rectangle(-1.0, -1.0, 1.9, 2.9));
+	boxes.sort([](const Rectangle &a, const Rectangle &b) { return a.lowerLeft[1] < b.lowerLeft[1]; });
+
+	std::vector<size_t> expected;
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		if (boxes[i].intersectsRectangle(r))
+		{
+			expected.push_back(i);
+		}
+	}
+
+	std::vector<size_t> v;
+	boxes.forEachIntersecting(r, [&v](size_t i) { v.push_back(i); });
+	REQUIRE(std::includes(v.begin(), v.end(), expected.begin(), expected.end()));
+#ifndef QUANTIZEDBOXES
+	REQUIRE(v == expected);
+#endif
+
+	// Point queries match Rectangle::containsPoint including the boundary
+	Point p(7.5, 9.0);
+	expected.clear();
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		if (boxes[i].containsPoint(p))
+		{
+			expected.push_back(i);
+		}
+	}
+	REQUIRE(!expected.empty());
+
+	v.clear();
+	boxes.forEachContaining(p, [&v](size_t i) { v.push_back(i); });
+	REQUIRE(std::includes(v.begin(), v.end(), expected.begin(), expected.end()));
+#ifndef QUANTIZEDBOXES
+	REQUIRE(v == expected);
+#endif
+}
+
+TEST_CASE("Geometry: testPolygonInlineRectangles")
+{
+	// Polygons keep their first rectangles inline and spill to the heap once they grow
+	IsotheticPolygon p1(Rectangle(0.0, 0.0, 1.0, 1.0));
+	REQUIRE(!p1.basicRectangles.spilled());
+	REQUIRE(p1.basicRectangles.heapBytes() == 0);
+	for (unsigned i = 1; i < 4; ++i)
+	{
+		p1.basicRectangles.push_back(Rectangle(i * 1.0, 0.0, i + 1.0, 1.0));
+	}
+
+	IsotheticPolygon p2(p1);
+	p1.basicRectangles.push_back(p1.basicRectangles[0]);
+	p1.basicRectangles.back() = Rectangle(4.0, 0.0, 5.0, 1.0);
+	REQUIRE(p1.basicRectangles.spilled());
+	REQUIRE(p1.basicRectangles.size() == 5);
+	REQUIRE(p1.area() == 5.0);
+
+	// Copies and swaps keep both polygons whole whichever storage they use
+	IsotheticPolygon p3(p1);
+	REQUIRE(p3 == p1);
+	REQUIRE(p2.basicRectangles.size() == 4);
+	p2.basicRectangles.swap(p3.basicRectangles);
+	REQUIRE(p2.basicRectangles.size() == 5);
+	REQUIRE(p3.basicRectangles.size() == 4);
+	REQUIRE(p2.area() == 5.0);
+	REQUIRE(p3.area() == 4.0);
+
+	// Dropping back below the inline size keeps the rectangles that remain
+	p2.remove(4);
+	p2.remove(0);
+	REQUIRE(p2.basicRectangles.size() == 3);
+	REQUIRE(p2.area() == 3.0);
+	p2.basicRectangles.clear();
+	REQUIRE(p2.basicRectangles.empty());
+}
+
+TEST_CASE("Geometry: testPackedBoxesNeverMiss")
+{
+	// Far from the origin, degenerate and hairline boxes are the hardest to round safely
+	std::mt19937 generator(3);
+	std::uniform_real_distribution<double> position(1e6, 1e6 + 100.0);
+	std::uniform_real_distribution<double> width(0.0, 5.0);
+	PackedBoxes<Rectangle> boxes;
+	for (unsigned i = 0; i < 150; ++i)
+	{
+		double x = position(generator);
+		double y = position(generator);
+		double w = i % 5 == 0 ? 0.0 : width(generator) * (i % 7 == 0 ? 1e-9 : 1.0);
+		boxes.push_back(Rectangle(x, y, x + w, y + w));
+	}
+
+	// Growing past the old frame and shrinking again keeps every box reachable
+	boxes.push_back(Rectangle(1e6 - 50.0, 1e6 - 50.0, 1e6 - 49.0, 1e6 - 49.0));
+	boxes.removeAt(17);
+	boxes.erase(0, 3);
+
+	// Queries whose edges sit exactly on box corners as well as random ones
+	std::vector<Rectangle> queries;
+	for (unsigned i = 0; i < boxes.size(); i += 3)
+	{
+		queries.push_back(Rectangle(boxes[i].upperRight, boxes[i].upperRight + Point(1.0)));
+		queries.push_back(Rectangle(boxes[i].lowerLeft - Point(1.0), boxes[i].lowerLeft));
+	}
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		Point corner(position(generator), position(generator));
+		queries.push_back(Rectangle(corner, corner + Point(width(generator))));
+	}
+
+	for (const Rectangle &query : queries)
+	{
+		std::vector<size_t> expected;
+		for (size_t i = 0; i < boxes.size(); ++i)
+		{
+			if (boxes[i].intersectsRectangle(query))
+			{
+				expected.push_back(i);
+			}
+		}
+
+		std::vector<size_t> v;
+		boxes.forEachIntersecting(query, [&v](size_t i) { v.push_back(i); });
+		REQUIRE(std::includes(v.begin(), v.end(), expected.begin(), expected.end()));
+#ifndef QUANTIZEDBOXES
+		REQUIRE(v == expected);
+#endif
+	}
+
+	for (size_t i = 0; i < boxes.size(); ++i)
+	{
+		bool found = false;
+		boxes.forEachContaining(boxes[i].upperRight, [&found, i](size_t j) { found = found || i == j; });
+		REQUIRE(found);
+	}
+}
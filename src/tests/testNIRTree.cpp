@@ -38,3 +38,272 @@ TEST_CASE("NIRTree: testPrefixConsistency")
 	tree.insert(Point(-12.0, -3.4));
 	REQUIRE(Point(-12.0, -3.4) == tree.search(Point(-12.0, -3.4)).front());
 }
+
+TEST_CASE("NIRTree: testBulkLoad")
+{
+	nirtree::NIRTree tree(3, 7);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 40; ++i)
+	{
+		for (unsigned j = 0; j < 25; ++j)
+		{
+			points.push_back(Point(i * 1.0 + j * 0.01, j * 2.0));
+		}
+	}
+	tree.bulkLoad(points);
+
+	// Packed polygons are single rectangles and siblings are disjoint
+	REQUIRE(tree.validate());
+	std::stack<nirtree::Node *> context;
+	context.push(tree.root);
+	while (!context.empty())
+	{
+		nirtree::Node *node = context.top();
+		context.pop();
+
+		for (nirtree::Node::Branch &b : node->branches)
+		{
+			REQUIRE(b.boundingPoly.basicRectangles.size() == 1);
+			context.push(b.child);
+		}
+	}
+
+	// Every point can be found and range searches match a scan
+	for (Point &p : points)
+	{
+		std::vector<Point> v = tree.search(p);
+		REQUIRE(v.size() == 1);
+		REQUIRE(v[0] == p);
+	}
+	Rectangle query(10.0, 10.0, 19.0, 19.0);
+	unsigned expected = std::count_if(points.begin(), points.end(), [&query](const Point &p) { return query.containsPoint(p); });
+	REQUIRE(tree.search(query).size() == expected);
+
+	// The packed tree keeps working dynamically
+	tree.insert(Point(100.0, 100.0));
+	REQUIRE(tree.search(Point(100.0, 100.0)).size() == 1);
+	REQUIRE(tree.validate());
+	for (Point &p : points)
+	{
+		tree.remove(p);
+	}
+	REQUIRE(tree.search(Point(0.0, 0.0)).empty());
+	REQUIRE(tree.search(Point(100.0, 100.0)).size() == 1);
+}
+
+TEST_CASE("NIRTree: testInsertBatch")
+{
+	nirtree::NIRTree tree(3, 7);
+
+	// Two batches so the second lands in an already populated tree
+	std::vector<Point> firstBatch;
+	std::vector<Point> secondBatch;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		Point p((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001);
+		if (i % 2 == 0)
+		{
+			firstBatch.push_back(p);
+		}
+		else
+		{
+			secondBatch.push_back(p);
+		}
+	}
+	tree.insertBatch(firstBatch);
+	tree.insertBatch(secondBatch);
+	REQUIRE(tree.validate());
+
+	for (Point &p : firstBatch)
+	{
+		std::vector<Point> v = tree.search(p);
+		REQUIRE(v.size() == 1);
+		REQUIRE(v[0] == p);
+	}
+	for (Point &p : secondBatch)
+	{
+		std::vector<Point> v = tree.search(p);
+		REQUIRE(v.size() == 1);
+		REQUIRE(v[0] == p);
+	}
+}
+
+TEST_CASE("NIRTree: testSearchBatch")
+{
+	nirtree::NIRTree tree(3, 7);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	tree.bulkLoad(points);
+
+	// More than one chunk of queries, some of them empty
+	std::vector<Rectangle> rectangles;
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		double x = (i * 13 % 110) * 1.0;
+		double y = (i * 29 % 105) * 1.0;
+		rectangles.push_back(Rectangle(x, y, x + (i % 7) * 3.0, y + (i % 5) * 4.0));
+	}
+
+	std::vector<std::vector<Point>> vs = tree.searchBatch(rectangles);
+	REQUIRE(vs.size() == rectangles.size());
+	for (unsigned i = 0; i < rectangles.size(); ++i)
+	{
+		std::vector<Point> v = tree.search(rectangles[i]);
+		REQUIRE(vs[i].size() == v.size());
+		REQUIRE(std::is_permutation(vs[i].begin(), vs[i].end(), v.begin()));
+	}
+}
+
+TEST_CASE("NIRTree: testSearchVisitor")
+{
+	nirtree::NIRTree tree(3, 7);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	tree.bulkLoad(points);
+
+	Rectangle searchRectangle(20.0, 10.0, 60.0, 45.0);
+	std::vector<Point> v = tree.search(searchRectangle);
+	REQUIRE(v.size() > 0);
+
+	// Directly through the tree
+	std::vector<Point> visited;
+	tree.search(searchRectangle, [&visited](const Point &p) { visited.push_back(p); });
+	REQUIRE(visited.size() == v.size());
+	REQUIRE(std::is_permutation(visited.begin(), visited.end(), v.begin()));
+
+	// Through the index interface, with a visitor that starts a search of its own
+	Index &index = tree;
+	unsigned visitedCount = 0;
+	unsigned nestedCount = 0;
+	index.search(searchRectangle, [&](const Point &p)
+	{
+		++visitedCount;
+		tree.search(Rectangle(p, p), [&nestedCount](const Point &) { ++nestedCount; });
+	});
+	REQUIRE(visitedCount == v.size());
+	REQUIRE(nestedCount == v.size());
+}
+
+TEST_CASE("NIRTree: testNearest")
+{
+	nirtree::NIRTree tree(3, 7);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0 + i * 0.0001, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	tree.bulkLoad(points);
+
+	// Compare against brute force distances from a few query points inside and outside the data
+	std::vector<Point> queries = {Point(50.0, 50.0), points[17], Point(-20.0, 130.0)};
+	for (Point &query : queries)
+	{
+		std::vector<double> expected;
+		for (Point &p : points)
+		{
+			expected.push_back(p.distance(query));
+		}
+		std::sort(expected.begin(), expected.end());
+
+		std::vector<Point> v = tree.nearest(query, 10);
+		REQUIRE(v.size() == 10);
+		for (unsigned i = 0; i < v.size(); ++i)
+		{
+			REQUIRE(v[i].distance(query) == expected[i]);
+		}
+	}
+
+	// Asking for more points than the tree holds returns all of them
+	REQUIRE(tree.nearest(Point(0.0, 0.0), 1000).size() == points.size());
+}
+
+TEST_CASE("NIRTree: testCount")
+{
+	nirtree::NIRTree tree(3, 7);
+
+	// Mix single inserts, a batch and removals so every count update path is exercised
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 900; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		tree.insert(points[i]);
+	}
+	tree.insertBatch(std::vector<Point>(points.begin() + 600, points.end()));
+	for (unsigned i = 0; i < 900; i += 3)
+	{
+		tree.remove(points[i]);
+	}
+
+	REQUIRE(tree.count(Rectangle(-1.0, -1.0, 200.0, 200.0)) == 600);
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		double x = (i * 13 % 110) * 1.0;
+		double y = (i * 29 % 105) * 1.0;
+		Rectangle r(x, y, x + (i % 7) * 9.0, y + (i % 5) * 12.0);
+		REQUIRE(tree.count(r) == tree.search(r).size());
+	}
+}
+
+TEST_CASE("NIRTree: testSnapshot")
+{
+	nirtree::NIRTree tree(3, 7);
+
+	// Inserts and removals leave polygons of more than one rectangle behind
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 900; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	for (Point &p : points)
+	{
+		tree.insert(p);
+	}
+	for (unsigned i = 0; i < 900; i += 3)
+	{
+		tree.remove(points[i]);
+	}
+
+	const std::string path = "testNIRTreeSnapshot.bin";
+	REQUIRE(tree.save(path));
+
+	nirtree::NIRTree loaded(3, 7);
+	REQUIRE(loaded.load(path));
+	REQUIRE(loaded.validate());
+	REQUIRE(loaded.checksum() == tree.checksum());
+	REQUIRE(loaded.count(Rectangle(-1.0, -1.0, 200.0, 200.0)) == 600);
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		double x = (i * 13 % 110) * 1.0;
+		double y = (i * 29 % 105) * 1.0;
+		Rectangle r(x, y, x + (i % 7) * 9.0, y + (i % 5) * 12.0);
+		REQUIRE(loaded.search(r).size() == tree.search(r).size());
+	}
+
+	// The loaded tree keeps working as a tree
+	loaded.insert(points[0]);
+	loaded.remove(points[1]);
+	REQUIRE(loaded.validate());
+	REQUIRE(loaded.count(Rectangle(-1.0, -1.0, 200.0, 200.0)) == 600);
+
+	// A snapshot taken with other branch factors is refused and leaves the tree empty
+	nirtree::NIRTree other(2, 5);
+	other.insert(Point(1.0, 1.0));
+	REQUIRE(!other.load(path));
+	REQUIRE(other.checksum() == 0);
+
+	std::remove(path.c_str());
+	REQUIRE(!loaded.load(path));
+}
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+#include <util/pointFile.h>
+#include <util/textPoints.h>
+#include <cstdio>
+
+TEST_CASE("PointFile: testRoundTrip")
+{
+	const std::string path = "testPointFile.bin";
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 100000; ++i)
+	{
+		points.push_back(Point(i * 0.5 - 7.25, (i * 53 % 97) * -1.0e-3));
+	}
+
+	pointfile::Writer writer(path, 2);
+	for (Point &p : points)
+	{
+		writer.write(p.values);
+	}
+	REQUIRE(writer.close());
+	REQUIRE(writer.size() == points.size());
+
+	{
+		pointfile::Reader reader;
+		REQUIRE(reader.open(path));
+		REQUIRE(reader.size() == points.size());
+		REQUIRE(reader.dimensions() == 2);
+		unsigned matching = 0;
+		for (unsigned i = 0; i < points.size(); ++i)
+		{
+			matching += reader.point(i) == points[i];
+		}
+		REQUIRE(matching == points.size());
+	}
+
+	// Files cut short of the points their header promises are refused
+	REQUIRE(truncate(path.c_str(), pointfile::headerBytes + 16 * (points.size() - 1)) == 0);
+	pointfile::Reader truncatedReader;
+	REQUIRE(!truncatedReader.open(path));
+
+	std::remove(path.c_str());
+	pointfile::Reader missingReader;
+	REQUIRE(!missingReader.open(path));
+}
+
+TEST_CASE("PointFile: testParseText")
+{
+	const std::string path = "testPointFile.txt";
+
+	// Mixed whitespace and more lines than threads so points straddle the chunks
+	std::vector<Point> points;
+	std::FILE *text = std::fopen(path.c_str(), "w");
+	REQUIRE(text != nullptr);
+	for (unsigned i = 0; i < 100000; ++i)
+	{
+		points.push_back(Point(i * 0.1 - 7.25, (i * 53 % 97) * -1.0e-3));
+		std::fprintf(text, i % 3 == 0 ? "%.17g\t%.17g\r\n" : "  %.17g %.17g\n", points[i][0], points[i][1]);
+	}
+	std::fclose(text);
+
+	std::vector<Point> parsed(points.size());
+	REQUIRE(textpoints::read(path, 2, parsed.size(), parsed.data()));
+	unsigned matching = 0;
+	for (unsigned i = 0; i < points.size(); ++i)
+	{
+		matching += parsed[i] == points[i];
+	}
+	REQUIRE(matching == points.size());
+
+	// Fewer numbers than asked for or something that is not a number are refused
+	std::vector<Point> tooMany(points.size() + 1);
+	REQUIRE(!textpoints::read(path, 2, tooMany.size(), tooMany.data()));
+
+	text = std::fopen(path.c_str(), "a");
+	REQUIRE(text != nullptr);
+	std::fprintf(text, "1.5 x2.5\n");
+	std::fclose(text);
+	REQUIRE(!textpoints::read(path, 2, tooMany.size(), tooMany.data()));
+
+	std::remove(path.c_str());
+	REQUIRE(!textpoints::read(path, 2, parsed.size(), parsed.data()));
+}
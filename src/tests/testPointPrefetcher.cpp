@@ -0,0 +1,43 @@
+#include <catch2/catch.hpp>
+#include <util/pointPrefetcher.h>
+
+TEST_CASE("PointPrefetcher: testReadAhead")
+{
+	// Each reader counts from the start on its own
+	const size_t total = 100003;
+	auto fill = [total, produced = (size_t) 0](Point *chunk, size_t capacity) mutable
+	{
+		size_t count = 0;
+		for (; count < capacity && produced < total; ++count, ++produced)
+		{
+			chunk[count] = Point(produced, -1.0 * produced);
+		}
+		return count;
+	};
+
+	PointPrefetcher prefetcher;
+	prefetcher.start(7, 3, fill);
+
+	// Every point comes out once and in order however the chunks fall
+	Point p;
+	size_t inOrder = 0;
+	size_t taken = 0;
+	for (; prefetcher.next(p); ++taken)
+	{
+		inOrder += p == Point(taken, -1.0 * taken);
+	}
+	REQUIRE(taken == total);
+	REQUIRE(inOrder == total);
+	REQUIRE(!prefetcher.next(p));
+
+	// Restarting part way through begins again from the first chunk
+	prefetcher.start(1000, 2, fill);
+	for (taken = 0; taken < 2500 && prefetcher.next(p); ++taken) {}
+	prefetcher.start(1000, 1, fill);
+	REQUIRE(prefetcher.next(p));
+	REQUIRE(p == Point(0.0, 0.0));
+
+	// Stopping while the reader waits for a buffer to come back does not hang
+	prefetcher.stop();
+	REQUIRE(!prefetcher.next(p));
+}
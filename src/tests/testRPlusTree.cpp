@@ -39,9 +39,9 @@ TEST_CASE("R+Tree: testPartition2")
 {
 	rplustree::RPlusTree tree(2, 3);
 
-	tree.root->branches.push_back({new rplustree::Node(tree, 2, 3, tree.root), Rectangle(0.0, 0.0, 2.0, 8.0)});
-	tree.root->branches.push_back({new rplustree::Node(tree, 2, 3, tree.root), Rectangle(3.0, 0.0, 5.0, 4.0)});
-	tree.root->branches.push_back({new rplustree::Node(tree, 2, 3, tree.root), Rectangle(6.0, 0.0, 8.0, 2.0)});
+	tree.root->branches.push_back({tree.nodeArena.create(tree, tree.root), Rectangle(0.0, 0.0, 2.0, 8.0)});
+	tree.root->branches.push_back({tree.nodeArena.create(tree, tree.root), Rectangle(3.0, 0.0, 5.0, 4.0)});
+	tree.root->branches.push_back({tree.nodeArena.create(tree, tree.root), Rectangle(6.0, 0.0, 8.0, 2.0)});
 
 	// Partition
 	auto part = tree.root->partitionNode();
@@ -54,12 +54,12 @@ TEST_CASE("R+Tree: testPartition2")
 TEST_CASE("R+Tree: testSplitNode")
 {
 	rplustree::RPlusTree tree(2, 3);
-	auto *root = new rplustree::Node(tree, 2, 3, nullptr);
+	auto *root = tree.nodeArena.create(tree, nullptr);
 
-	auto *n0 = new rplustree::Node(tree, 2, 3, root);
-	auto *n1 = new rplustree::Node(tree, 2, 3, root);
-	auto *n2 = new rplustree::Node(tree, 2, 3, root);
-	auto *n3 = new rplustree::Node(tree, 2, 3, root);
+	auto *n0 = tree.nodeArena.create(tree, root);
+	auto *n1 = tree.nodeArena.create(tree, root);
+	auto *n2 = tree.nodeArena.create(tree, root);
+	auto *n3 = tree.nodeArena.create(tree, root);
 	n3->data.push_back(Point(5.0, 4.0));
 	n3->data.push_back(Point(9.0, 12.0));
 
@@ -105,17 +105,17 @@ TEST_CASE("R+Tree: testInsert")
 {
 	rplustree::RPlusTree tree(2, 3);
 
-	auto *cluster1 = new rplustree::Node(tree, 2, 3, tree.root);
+	auto *cluster1 = tree.nodeArena.create(tree, tree.root);
 	cluster1->data.emplace_back(0.0, 0.0);
 	cluster1->data.emplace_back(4.0, 4.0);
 	tree.root->branches.push_back({cluster1, cluster1->boundingBox()});
 
-	auto *cluster2 = new rplustree::Node(tree, 2, 3, tree.root);
+	auto *cluster2 = tree.nodeArena.create(tree, tree.root);
 	cluster2->data.emplace_back(5.0, 0.0);
 	cluster2->data.emplace_back(9.0, 4.0);
 	tree.root->branches.push_back({cluster2, cluster2->boundingBox()});
 
-	auto *cluster3 = new rplustree::Node(tree, 2, 3, tree.root);
+	auto *cluster3 = tree.nodeArena.create(tree, tree.root);
 	cluster3->data.emplace_back(0.0, 5.0);
 	cluster3->data.emplace_back(4.0, 9.0);
 	cluster3->data.emplace_back(9.0, 9.0);
@@ -140,15 +140,15 @@ TEST_CASE("R+Tree: testSimpleRemove")
 {
 	rplustree::RPlusTree tree(2, 3);
 
-	auto *cluster1a = new rplustree::Node(tree, 2, 3, tree.root);
+	auto *cluster1a = tree.nodeArena.create(tree, tree.root);
 	cluster1a->data.emplace_back(0.0, 0.0);
 	cluster1a->data.emplace_back(4.0, 4.0);
 
-	auto *cluster1b = new rplustree::Node(tree, 2, 3, tree.root);
+	auto *cluster1b = tree.nodeArena.create(tree, tree.root);
 	cluster1b->data.emplace_back(0.0, 5.0);
 	cluster1b->data.emplace_back(4.0, 9.0);
 
-	auto *cluster1c = new rplustree::Node(tree, 2, 3, tree.root);
+	auto *cluster1c = tree.nodeArena.create(tree, tree.root);
 	cluster1c->data.emplace_back(5.0, 0.0);
 	cluster1c->data.emplace_back(7.0, 9.0);
 
@@ -167,8 +167,8 @@ TEST_CASE("R+Tree: testChooseNode")
 	Point p = Point(165.0, 181.0);
 	rplustree::RPlusTree tree(2, 3);
 
-	auto *child1 = new rplustree::Node(tree, 2, 3, tree.root);
-	auto *child2 = new rplustree::Node(tree, 2, 3, tree.root);
+	auto *child1 = tree.nodeArena.create(tree, tree.root);
+	auto *child2 = tree.nodeArena.create(tree, tree.root);
 
 	tree.root->branches.push_back({child1, Rectangle(123.0, 151.0, 146.0, 186.0)});
 	tree.root->branches.push_back({child2, Rectangle(150.0, 183.0, 152.0, 309.0)});
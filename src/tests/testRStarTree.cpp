@@ -1,17 +1,18 @@
 #include <catch2/catch.hpp>
 #include <rstartree/rstartree.h>
+#include <rstartree/pagedRStarTree.h>
 #include <util/geometry.h>
 #include <iostream>
+#include <fstream>
 
-static rstartree::Node::NodeEntry createBranchEntry(const Rectangle &boundingBox, rstartree::Node *child)
+static rstartree::Node::Branch createBranchEntry(const Rectangle &boundingBox, rstartree::Node *child)
 {
-	rstartree::Node::Branch b(boundingBox, child);
-	return b;
+	return rstartree::Node::Branch(boundingBox, child);
 }
 
 static rstartree::Node *createFullLeafNode(rstartree::RStarTree &treeRef, Point p=Point::atOrigin)
 {
-	rstartree::Node *node = new rstartree::Node(treeRef);
+	rstartree::Node *node = treeRef.nodeArena.create(treeRef);
 	std::vector<bool> reInsertedAtLevel = {false};
 
 	for (unsigned i = 0; i < treeRef.maxBranchFactor; ++i)
@@ -29,24 +30,24 @@ TEST_CASE("R*Tree: testBoundingBox")
 	rstartree::RStarTree tree(3, 5);
 	rstartree::Node *testNode = tree.root;
 
-	rstartree::Node *child0 = new rstartree::Node(tree);
-	testNode->entries.push_back(createBranchEntry( Rectangle(8.0, 1.0, 12.0, 5.0), child0));
-	rstartree::Node *child1 = new rstartree::Node(tree);
-	testNode->entries.push_back(createBranchEntry( Rectangle(12.0, -4.0, 16.0, -2.0), child1));
-	rstartree::Node *child2 = new rstartree::Node(tree);
-	testNode->entries.push_back(createBranchEntry( Rectangle(8.0, -6.0, 10.0, -4.0), child2));
+	rstartree::Node *child0 = tree.nodeArena.create(tree);
+	testNode->branches.push_back(createBranchEntry( Rectangle(8.0, 1.0, 12.0, 5.0), child0));
+	rstartree::Node *child1 = tree.nodeArena.create(tree);
+	testNode->branches.push_back(createBranchEntry( Rectangle(12.0, -4.0, 16.0, -2.0), child1));
+	rstartree::Node *child2 = tree.nodeArena.create(tree);
+	testNode->branches.push_back(createBranchEntry( Rectangle(8.0, -6.0, 10.0, -4.0), child2));
 
 	REQUIRE(testNode->boundingBox() == Rectangle(8.0, -6.0, 16.0, 5.0));
 
 	// Test set two
 	rstartree::RStarTree tree2(3, 5);
 	rstartree::Node *testNode2 = tree2.root;
-	child0 = new rstartree::Node(tree);
-	testNode2->entries.push_back(createBranchEntry(Rectangle(8.0, 12.0, 10.0, 14.0), child0));
-	child1 = new rstartree::Node(tree);
-	testNode2->entries.push_back(createBranchEntry(Rectangle(10.0, 12.0, 12.0, 14.0), child1));
-	child2 = new rstartree::Node(tree);
-	testNode2->entries.push_back(createBranchEntry(Rectangle(12.0, 12.0, 14.0, 14.0), child2));
+	child0 = tree.nodeArena.create(tree);
+	testNode2->branches.push_back(createBranchEntry(Rectangle(8.0, 12.0, 10.0, 14.0), child0));
+	child1 = tree.nodeArena.create(tree);
+	testNode2->branches.push_back(createBranchEntry(Rectangle(10.0, 12.0, 12.0, 14.0), child1));
+	child2 = tree.nodeArena.create(tree);
+	testNode2->branches.push_back(createBranchEntry(Rectangle(12.0, 12.0, 14.0, 14.0), child2));
 
 	REQUIRE(testNode2->boundingBox() == Rectangle(8.0, 12.0, 14.0, 14.0));
 }
@@ -57,29 +58,29 @@ TEST_CASE("R*Tree: testUpdateBoundingBox")
 	rstartree::Node *parentNode = tree.root;
 	parentNode->level = 1;
 
-	rstartree::Node *child0 = new rstartree::Node(tree);
+	rstartree::Node *child0 = tree.nodeArena.create(tree);
 	child0->parent = parentNode;
 	child0->level = 0;
-	parentNode->entries.push_back(createBranchEntry(Rectangle(8.0, -6.0, 10.0, -4.0), child0));
+	parentNode->branches.push_back(createBranchEntry(Rectangle(8.0, -6.0, 10.0, -4.0), child0));
 
-	rstartree::Node *child1 = new rstartree::Node(tree);
+	rstartree::Node *child1 = tree.nodeArena.create(tree);
 	child1->level = 0;
 	child1->parent = parentNode;
-	parentNode->entries.push_back(createBranchEntry(Rectangle(12.0, -4.0, 16.0, -2.0), child1));
+	parentNode->branches.push_back(createBranchEntry(Rectangle(12.0, -4.0, 16.0, -2.0), child1));
 
-	rstartree::Node *child2 = new rstartree::Node(tree);
+	rstartree::Node *child2 = tree.nodeArena.create(tree);
 	child2->level = 0;
 	child2->parent = parentNode;
-	parentNode->entries.push_back(createBranchEntry(Rectangle(10.0, 12.0, 12.0, 14.0), child2));
+	parentNode->branches.push_back(createBranchEntry(Rectangle(10.0, 12.0, 12.0, 14.0), child2));
 
-	rstartree::Node *child3 = new rstartree::Node(tree);
+	rstartree::Node *child3 = tree.nodeArena.create(tree);
 	child3->level = 0;
 	child3->parent = parentNode;
-	parentNode->entries.push_back(createBranchEntry(Rectangle(12.0, 12.0, 14.0, 14.0), child3));
+	parentNode->branches.push_back(createBranchEntry(Rectangle(12.0, 12.0, 14.0, 14.0), child3));
 
 	// Test the bounding box update
 	parentNode->updateBoundingBox(child3, Rectangle(3.0, 3.0, 5.0, 5.0));
-	const rstartree::Node::Branch &b = std::get<rstartree::Node::Branch>(parentNode->entries[3]);
+	const rstartree::Node::Branch &b = parentNode->branches[3];
 	REQUIRE(b.boundingBox == Rectangle(3.0, 3.0, 5.0, 5.0));
     REQUIRE(parentNode->level == 1);
     REQUIRE(child0->level == 0);
@@ -95,31 +96,31 @@ TEST_CASE("R*Tree: testRemoveChild")
 	rstartree::Node *parentNode = tree.root;
 	parentNode->level = 1;
 
-	rstartree::Node *child0 = new rstartree::Node(tree);
+	rstartree::Node *child0 = tree.nodeArena.create(tree);
 	child0->level = 0;
 	child0->parent = parentNode;
-	parentNode->entries.push_back(createBranchEntry(Rectangle(8.0, -6.0, 10.0, -4.0), child0));
+	parentNode->branches.push_back(createBranchEntry(Rectangle(8.0, -6.0, 10.0, -4.0), child0));
 
-	rstartree::Node *child1 = new rstartree::Node(tree);
+	rstartree::Node *child1 = tree.nodeArena.create(tree);
 	child1->level = 0;
 	child1->parent = parentNode;
-	parentNode->entries.push_back(createBranchEntry(Rectangle(12.0, -4.0, 16.0, -2.0), child1));
+	parentNode->branches.push_back(createBranchEntry(Rectangle(12.0, -4.0, 16.0, -2.0), child1));
 
-	rstartree::Node *child2 = new rstartree::Node(tree);
+	rstartree::Node *child2 = tree.nodeArena.create(tree);
 	child2->level = 0;
 	child2->parent = parentNode;
-	parentNode->entries.push_back(createBranchEntry(Rectangle(10.0, 12.0, 12.0, 14.0), child2));
+	parentNode->branches.push_back(createBranchEntry(Rectangle(10.0, 12.0, 12.0, 14.0), child2));
 
-	rstartree::Node *child3 = new rstartree::Node(tree);
+	rstartree::Node *child3 = tree.nodeArena.create(tree);
 	child3->level = 0;
 	child3->parent = parentNode;
-	parentNode->entries.push_back(createBranchEntry(Rectangle(12.0, 12.0, 14.0, 14.0), child3));
+	parentNode->branches.push_back(createBranchEntry(Rectangle(12.0, 12.0, 14.0, 14.0), child3));
 
 	// Remove one of the children
 	parentNode->removeChild(child3);
-	REQUIRE(parentNode->entries.size() == 3);
+	REQUIRE(parentNode->entryCount() == 3);
 
-	delete child3;
+	tree.nodeArena.destroy(child3);
 }
 
 TEST_CASE("R*Tree: testRemoveData")
@@ -129,16 +130,16 @@ TEST_CASE("R*Tree: testRemoveData")
 	rstartree::Node *parentNode = tree.root;
 	parentNode->level = 0;
 
-	parentNode->entries.push_back(Point(9.0, -5.0));
-	parentNode->entries.push_back(Point(14.0, -3.0));
-	parentNode->entries.push_back(Point(11.0, 13.0));
-	parentNode->entries.push_back(Point(13.0, 13.0));
+	parentNode->data.push_back(Point(9.0, -5.0));
+	parentNode->data.push_back(Point(14.0, -3.0));
+	parentNode->data.push_back(Point(11.0, 13.0));
+	parentNode->data.push_back(Point(13.0, 13.0));
 
 	// Remove some of the data
 	parentNode->removeData(Point(13.0, 13.0));
 
 	// Test the removal
-	REQUIRE(parentNode->entries.size() == 3);
+	REQUIRE(parentNode->entryCount() == 3);
 }
 
 TEST_CASE("R*Tree: testChooseLeaf")
@@ -146,8 +147,8 @@ TEST_CASE("R*Tree: testChooseLeaf")
 	// Create rtree::Nodes
 	rstartree::RStarTree tree(3, 5);
 	rstartree::Node *root= tree.root;
-	rstartree::Node *left = new rstartree::Node(tree);
-	rstartree::Node *right = new rstartree::Node(tree);
+	rstartree::Node *left = tree.nodeArena.create(tree);
+	rstartree::Node *right = tree.nodeArena.create(tree);
 	rstartree::Node *leftChild0 = createFullLeafNode(tree);
 	rstartree::Node *leftChild1 = createFullLeafNode(tree);
 	rstartree::Node *leftChild2 = createFullLeafNode(tree);
@@ -159,47 +160,47 @@ TEST_CASE("R*Tree: testChooseLeaf")
 	// NB: All of these bounding rectangles are wrong, but that's fine for the purposes of this test.
 	leftChild0->parent = left;
 	leftChild0->level = 0;
-	left->entries.push_back(createBranchEntry(Rectangle(8.0, 12.0, 10.0, 14.0), leftChild0));
+	left->branches.push_back(createBranchEntry(Rectangle(8.0, 12.0, 10.0, 14.0), leftChild0));
 
 	leftChild1->parent = left;
 	leftChild1->level = 0;
-	left->entries.push_back(createBranchEntry(Rectangle(10.0, 12.0, 12.0, 14.0), leftChild1));
+	left->branches.push_back(createBranchEntry(Rectangle(10.0, 12.0, 12.0, 14.0), leftChild1));
 
 	leftChild2->parent = left;
 	leftChild2->level = 0;
-	left->entries.push_back(createBranchEntry(Rectangle(12.0, 12.0, 14.0, 14.0), leftChild2));
+	left->branches.push_back(createBranchEntry(Rectangle(12.0, 12.0, 14.0, 14.0), leftChild2));
 
 	rightChild0->parent = right;
 	rightChild0->level = 0;
-	right->entries.push_back(createBranchEntry(Rectangle(8.0, 1.0, 12.0, 5.0), rightChild0));
+	right->branches.push_back(createBranchEntry(Rectangle(8.0, 1.0, 12.0, 5.0), rightChild0));
 
 	rightChild1->parent = right;
 	rightChild1->level = 0;
-	right->entries.push_back(createBranchEntry(Rectangle(12.0, -4.0, 16.0, -2.0), rightChild1));
+	right->branches.push_back(createBranchEntry(Rectangle(12.0, -4.0, 16.0, -2.0), rightChild1));
 
 	rightChild2->parent = right;
 	rightChild2->level = 0;
-	right->entries.push_back(createBranchEntry(Rectangle(8.0, -6.0, 10.0, -4.0), rightChild2));
+	right->branches.push_back(createBranchEntry(Rectangle(8.0, -6.0, 10.0, -4.0), rightChild2));
 
 	left->parent = root;
 	left->level = 1;
-	root->entries.push_back(createBranchEntry(Rectangle(8.0, 12.0, 14.0, 14.0), left));
+	root->branches.push_back(createBranchEntry(Rectangle(8.0, 12.0, 14.0, 14.0), left));
 
 	right->parent = root;
 	right->level = 1;
-	root->entries.push_back(createBranchEntry(Rectangle(8.0, -6.0, 16.0, 5.0), right));
+	root->branches.push_back(createBranchEntry(Rectangle(8.0, -6.0, 16.0, 5.0), right));
 
     root->level = 2;
 
-	REQUIRE(!root->entries.empty());
-	REQUIRE(!left->entries.empty());
-	REQUIRE(!right->entries.empty());
-	REQUIRE(!leftChild0->entries.empty());
-	REQUIRE(!leftChild1->entries.empty());
-	REQUIRE(!leftChild2->entries.empty());
-	REQUIRE(!rightChild0->entries.empty());
-	REQUIRE(!rightChild1->entries.empty());
-	REQUIRE(!rightChild2->entries.empty());
+	REQUIRE(root->entryCount() > 0);
+	REQUIRE(left->entryCount() > 0);
+	REQUIRE(right->entryCount() > 0);
+	REQUIRE(leftChild0->entryCount() > 0);
+	REQUIRE(leftChild1->entryCount() > 0);
+	REQUIRE(leftChild2->entryCount() > 0);
+	REQUIRE(rightChild0->entryCount() > 0);
+	REQUIRE(rightChild1->entryCount() > 0);
+	REQUIRE(rightChild2->entryCount() > 0);
 
 
 	// Test that we get the correct child for the given point
@@ -220,24 +221,24 @@ TEST_CASE("R*Tree: testFindLeaf")
 	// Organized into two rtree::Nodes
 	rstartree::RStarTree tree(3, 5);
 	rstartree::Node *root = tree.root;
-	rstartree::Node *cluster4a = new rstartree::Node(tree);
-	cluster4a->entries.push_back(Point(-10.0, -2.0));
-	cluster4a->entries.push_back(Point(-12.0, -3.0));
-	cluster4a->entries.push_back(Point(-11.0, -3.0));
-	cluster4a->entries.push_back(Point(-10.0, -3.0));
+	rstartree::Node *cluster4a = tree.nodeArena.create(tree);
+	cluster4a->data.push_back(Point(-10.0, -2.0));
+	cluster4a->data.push_back(Point(-12.0, -3.0));
+	cluster4a->data.push_back(Point(-11.0, -3.0));
+	cluster4a->data.push_back(Point(-10.0, -3.0));
 	cluster4a->level = 0;
 
-	rstartree::Node *cluster4b = new rstartree::Node(tree);
-	cluster4b->entries.push_back(Point(-9.0, -3.0));
-	cluster4b->entries.push_back(Point(-7.0, -3.0));
-	cluster4b->entries.push_back(Point(-10.0, -5.0));
+	rstartree::Node *cluster4b = tree.nodeArena.create(tree);
+	cluster4b->data.push_back(Point(-9.0, -3.0));
+	cluster4b->data.push_back(Point(-7.0, -3.0));
+	cluster4b->data.push_back(Point(-10.0, -5.0));
 	cluster4b->level = 0;
 
-	rstartree::Node *cluster4 = new rstartree::Node(tree);
+	rstartree::Node *cluster4 = tree.nodeArena.create(tree);
 	cluster4a->parent = cluster4;
-	cluster4->entries.push_back(createBranchEntry(cluster4a->boundingBox(), cluster4a));
+	cluster4->branches.push_back(createBranchEntry(cluster4a->boundingBox(), cluster4a));
 	cluster4b->parent = cluster4;
-	cluster4->entries.push_back(createBranchEntry(cluster4b->boundingBox(), cluster4b));
+	cluster4->branches.push_back(createBranchEntry(cluster4b->boundingBox(), cluster4b));
 	cluster4->level = 1;
 
 	// Cluster 5, n = 16
@@ -245,51 +246,51 @@ TEST_CASE("R*Tree: testFindLeaf")
 	// (-13.5, -16), (-15, -14.5), (-14, -14.5), (-12.5, -14.5), (-13.5, -15.5), (-15, -15),
 	// (-14, -15), (-13, -15), (-12, -15)
 	// Organized into four rstartree::Nodes
-	rstartree::Node *cluster5a = new rstartree::Node(tree);
-	cluster5a->entries.push_back(Point(-14.5, -13.0));
-	cluster5a->entries.push_back(Point(-14.0, -13.0));
-	cluster5a->entries.push_back(Point(-13.5, -13.5));
-	cluster5a->entries.push_back(Point(-15.0, -14.0));
+	rstartree::Node *cluster5a = tree.nodeArena.create(tree);
+	cluster5a->data.push_back(Point(-14.5, -13.0));
+	cluster5a->data.push_back(Point(-14.0, -13.0));
+	cluster5a->data.push_back(Point(-13.5, -13.5));
+	cluster5a->data.push_back(Point(-15.0, -14.0));
 	cluster5a->level = 0;
 
-	rstartree::Node *cluster5b = new rstartree::Node(tree);
-	cluster5b->entries.push_back(Point(-14.0, -14.0));
-	cluster5b->entries.push_back(Point(-13.0, -14.0));
-	cluster5b->entries.push_back(Point(-12.0, -14.0));
-	cluster5b->entries.push_back(Point(-13.5, -16.0));
+	rstartree::Node *cluster5b = tree.nodeArena.create(tree);
+	cluster5b->data.push_back(Point(-14.0, -14.0));
+	cluster5b->data.push_back(Point(-13.0, -14.0));
+	cluster5b->data.push_back(Point(-12.0, -14.0));
+	cluster5b->data.push_back(Point(-13.5, -16.0));
 	cluster5b->level = 0;
 
-	rstartree::Node *cluster5c = new rstartree::Node(tree);
-	cluster5c->entries.push_back(Point(-15.0, -14.5));
-	cluster5c->entries.push_back(Point(-14.0, -14.5));
-	cluster5c->entries.push_back(Point(-12.5, -14.5));
-	cluster5c->entries.push_back(Point(-13.5, -15.5));
+	rstartree::Node *cluster5c = tree.nodeArena.create(tree);
+	cluster5c->data.push_back(Point(-15.0, -14.5));
+	cluster5c->data.push_back(Point(-14.0, -14.5));
+	cluster5c->data.push_back(Point(-12.5, -14.5));
+	cluster5c->data.push_back(Point(-13.5, -15.5));
 	cluster5c->level = 0;
 
-	rstartree::Node *cluster5d = new rstartree::Node(tree);
-	cluster5d->entries.push_back(Point(-15.0, -15.0));
-	cluster5d->entries.push_back(Point(-14.0, -15.0));
-	cluster5d->entries.push_back(Point(-13.0, -15.0));
-	cluster5d->entries.push_back(Point(-12.0, -15.0));
-	cluster5d->entries.push_back(Point(-15.0, -15.0));
+	rstartree::Node *cluster5d = tree.nodeArena.create(tree);
+	cluster5d->data.push_back(Point(-15.0, -15.0));
+	cluster5d->data.push_back(Point(-14.0, -15.0));
+	cluster5d->data.push_back(Point(-13.0, -15.0));
+	cluster5d->data.push_back(Point(-12.0, -15.0));
+	cluster5d->data.push_back(Point(-15.0, -15.0));
 	cluster5d->level = 0;
 
-	rstartree::Node *cluster5 = new rstartree::Node(tree);
+	rstartree::Node *cluster5 = tree.nodeArena.create(tree);
 	cluster5a->parent = cluster5;
-	cluster5->entries.push_back(createBranchEntry(cluster5a->boundingBox(),cluster5a));
+	cluster5->branches.push_back(createBranchEntry(cluster5a->boundingBox(),cluster5a));
 	cluster5b->parent = cluster5;
-	cluster5->entries.push_back(createBranchEntry(cluster5b->boundingBox(), cluster5b));
+	cluster5->branches.push_back(createBranchEntry(cluster5b->boundingBox(), cluster5b));
 	cluster5c->parent = cluster5;
-	cluster5->entries.push_back(createBranchEntry(cluster5c->boundingBox(), cluster5c));
+	cluster5->branches.push_back(createBranchEntry(cluster5c->boundingBox(), cluster5c));
 	cluster5d->parent = cluster5;
-	cluster5->entries.push_back(createBranchEntry(cluster5d->boundingBox(), cluster5d));
+	cluster5->branches.push_back(createBranchEntry(cluster5d->boundingBox(), cluster5d));
 	cluster5->level = 1;
 
 	// Root
 	cluster4->parent = root;
-	root->entries.push_back(createBranchEntry(cluster4->boundingBox(), cluster4));
+	root->branches.push_back(createBranchEntry(cluster4->boundingBox(), cluster4));
 	cluster5->parent = root;
-	root->entries.push_back(createBranchEntry(cluster5->boundingBox(), cluster5));
+	root->branches.push_back(createBranchEntry(cluster5->boundingBox(), cluster5));
 	root->level = 2;
 
 	// Test finding leaves
@@ -309,59 +310,59 @@ TEST_CASE("R*Tree: testSimpleSplitAxis")
 	// Test split with X
 	rstartree::RStarTree tree(3, 5);
 	rstartree::Node *cluster6X = tree.root;
-	cluster6X->entries.push_back(Point(-3.0, -11.0));
-	cluster6X->entries.push_back(Point(-2.0, -9.0));
-	cluster6X->entries.push_back(Point(2.0, -10.0));
-	cluster6X->entries.push_back(Point(3.0, -11.0));
-	cluster6X->entries.push_back(Point(1.0, -9.0));
-	cluster6X->entries.push_back(Point(-3.0, -10.0));
+	cluster6X->data.push_back(Point(-3.0, -11.0));
+	cluster6X->data.push_back(Point(-2.0, -9.0));
+	cluster6X->data.push_back(Point(2.0, -10.0));
+	cluster6X->data.push_back(Point(3.0, -11.0));
+	cluster6X->data.push_back(Point(1.0, -9.0));
+	cluster6X->data.push_back(Point(-3.0, -10.0));
 	cluster6X->level = 0;
 
 	// Split the rstartree::Node in two
 	unsigned int axis = cluster6X->chooseSplitAxis();
 
 	REQUIRE(axis == 0);
-	REQUIRE(std::get<Point>(cluster6X->entries[0]) == Point(-3.0, -11.0));
-	REQUIRE(std::get<Point>(cluster6X->entries[1]) == Point(-3.0, -10.0));
-	REQUIRE(std::get<Point>(cluster6X->entries[2]) == Point(-2.0, -9.0));
-	REQUIRE(std::get<Point>(cluster6X->entries[3]) == Point(1.0, -9.0));
-	REQUIRE(std::get<Point>(cluster6X->entries[4]) == Point(2.0, -10.0));
-	REQUIRE(std::get<Point>(cluster6X->entries[5]) == Point(3.0, -11.0));
+	REQUIRE(cluster6X->data[0] == Point(-3.0, -11.0));
+	REQUIRE(cluster6X->data[1] == Point(-3.0, -10.0));
+	REQUIRE(cluster6X->data[2] == Point(-2.0, -9.0));
+	REQUIRE(cluster6X->data[3] == Point(1.0, -9.0));
+	REQUIRE(cluster6X->data[4] == Point(2.0, -10.0));
+	REQUIRE(cluster6X->data[5] == Point(3.0, -11.0));
 
 	// Test split with Y
 	rstartree::RStarTree tree2(3, 5);
 	rstartree::Node *cluster6Y = tree2.root;
-	cluster6Y->entries.push_back(Point(-11.0, -3.0));
-	cluster6Y->entries.push_back(Point(-9.0, -2.0));
-	cluster6Y->entries.push_back(Point(-10.0, 2.0));
-	cluster6Y->entries.push_back(Point(-11.0, 3.0));
-	cluster6Y->entries.push_back(Point(-9.0, 1.0));
-	cluster6Y->entries.push_back(Point(-10.0, -3.0));
+	cluster6Y->data.push_back(Point(-11.0, -3.0));
+	cluster6Y->data.push_back(Point(-9.0, -2.0));
+	cluster6Y->data.push_back(Point(-10.0, 2.0));
+	cluster6Y->data.push_back(Point(-11.0, 3.0));
+	cluster6Y->data.push_back(Point(-9.0, 1.0));
+	cluster6Y->data.push_back(Point(-10.0, -3.0));
 	cluster6Y->level = 0;
 
 	axis = cluster6Y->chooseSplitAxis();
 
 	REQUIRE(axis == 1);
-	REQUIRE(std::get<Point>(cluster6Y->entries[0]) == Point(-11.0, -3.0));
-	REQUIRE(std::get<Point>(cluster6Y->entries[1]) == Point(-10.0, -3.0));
-	REQUIRE(std::get<Point>(cluster6Y->entries[2]) == Point(-9.0, -2.0));
-	REQUIRE(std::get<Point>(cluster6Y->entries[3]) == Point(-9.0, 1.0));
-	REQUIRE(std::get<Point>(cluster6Y->entries[4]) == Point(-10.0, 2.0));
-	REQUIRE(std::get<Point>(cluster6Y->entries[5]) == Point(-11.0, 3.0));
+	REQUIRE(cluster6Y->data[0] == Point(-11.0, -3.0));
+	REQUIRE(cluster6Y->data[1] == Point(-10.0, -3.0));
+	REQUIRE(cluster6Y->data[2] == Point(-9.0, -2.0));
+	REQUIRE(cluster6Y->data[3] == Point(-9.0, 1.0));
+	REQUIRE(cluster6Y->data[4] == Point(-10.0, 2.0));
+	REQUIRE(cluster6Y->data[5] == Point(-11.0, 3.0));
 }
 
 TEST_CASE("R*Tree: testComplexComputeMargin")
 {
 	rstartree::RStarTree tree(3,7);
 	rstartree::Node *cluster = tree.root;
-	cluster->entries.push_back(Point(-3.0, -11.0));
-	cluster->entries.push_back(Point(-2.0, -9.0));
-	cluster->entries.push_back(Point(2.0, -10.0));
-	cluster->entries.push_back(Point(3.0, -11.0));
-	cluster->entries.push_back(Point(1.0, -9.0));
-	cluster->entries.push_back(Point(-3.0, -10.0));
-	cluster->entries.push_back(Point(3.0, -11.0));
-	cluster->entries.push_back(Point(3.0, -9.0));
+	cluster->data.push_back(Point(-3.0, -11.0));
+	cluster->data.push_back(Point(-2.0, -9.0));
+	cluster->data.push_back(Point(2.0, -10.0));
+	cluster->data.push_back(Point(3.0, -11.0));
+	cluster->data.push_back(Point(1.0, -9.0));
+	cluster->data.push_back(Point(-3.0, -10.0));
+	cluster->data.push_back(Point(3.0, -11.0));
+	cluster->data.push_back(Point(3.0, -9.0));
 	cluster->level = 0;
 
 	// Check that produce the right margin under X order
@@ -379,14 +380,14 @@ TEST_CASE("R*Tree: testComplexSplitAxis")
 	// Test split with X
 	rstartree::RStarTree tree(3, 7);
 	rstartree::Node *cluster = tree.root;
-	cluster->entries.push_back(Point(-3.0, -11.0));
-	cluster->entries.push_back(Point(-2.0, -9.0));
-	cluster->entries.push_back(Point(2.0, -10.0));
-	cluster->entries.push_back(Point(3.0, -11.0));
-	cluster->entries.push_back(Point(1.0, -9.0));
-	cluster->entries.push_back(Point(-3.0, -10.0));
-	cluster->entries.push_back(Point(3.0, -11.0));
-	cluster->entries.push_back(Point(3.0, -9.0));
+	cluster->data.push_back(Point(-3.0, -11.0));
+	cluster->data.push_back(Point(-2.0, -9.0));
+	cluster->data.push_back(Point(2.0, -10.0));
+	cluster->data.push_back(Point(3.0, -11.0));
+	cluster->data.push_back(Point(1.0, -9.0));
+	cluster->data.push_back(Point(-3.0, -10.0));
+	cluster->data.push_back(Point(3.0, -11.0));
+	cluster->data.push_back(Point(3.0, -9.0));
 	cluster->level = 0;
 
 	// See above test for margin scores for X and Y.
@@ -399,14 +400,14 @@ TEST_CASE("R*Tree: testComplexSplitAxis")
 	// Test split with Y
 	rstartree::RStarTree tree2(3,7);
 	cluster = tree2.root;
-	cluster->entries.push_back(Point(-11.0, -3.0));
-	cluster->entries.push_back(Point(-9.0, -2.0));
-	cluster->entries.push_back(Point(-10.0, 2.0));
-	cluster->entries.push_back(Point(-11.0, 3.0));
-	cluster->entries.push_back(Point(-9.0, 1.0));
-	cluster->entries.push_back(Point(-10.0, -3.0));
-	cluster->entries.push_back(Point(-11.0, 3.0));
-	cluster->entries.push_back(Point(-9.0, 3.0));
+	cluster->data.push_back(Point(-11.0, -3.0));
+	cluster->data.push_back(Point(-9.0, -2.0));
+	cluster->data.push_back(Point(-10.0, 2.0));
+	cluster->data.push_back(Point(-11.0, 3.0));
+	cluster->data.push_back(Point(-9.0, 1.0));
+	cluster->data.push_back(Point(-10.0, -3.0));
+	cluster->data.push_back(Point(-11.0, 3.0));
+	cluster->data.push_back(Point(-9.0, 3.0));
 	cluster->level = 0;
 
 	axis = cluster->chooseSplitAxis();
@@ -421,28 +422,28 @@ TEST_CASE("R*Tree: testSplitNode")
 	
 	rstartree::RStarTree tree(3,5);
 	rstartree::Node *cluster6 = tree.root;
-	cluster6->entries.push_back(Point(-2.0, -6.0));
-	cluster6->entries.push_back(Point(2.0, -6.0));
-	cluster6->entries.push_back(Point(-1.0, -7.0));
-	cluster6->entries.push_back(Point(1.0, -7.0));
-	cluster6->entries.push_back(Point(3.0, -8.0));
-	cluster6->entries.push_back(Point(-2.0, -9.0));
+	cluster6->data.push_back(Point(-2.0, -6.0));
+	cluster6->data.push_back(Point(2.0, -6.0));
+	cluster6->data.push_back(Point(-1.0, -7.0));
+	cluster6->data.push_back(Point(1.0, -7.0));
+	cluster6->data.push_back(Point(3.0, -8.0));
+	cluster6->data.push_back(Point(-2.0, -9.0));
 	cluster6->level = 0;
 
 	// Split the rstartree::Node in two
-	cluster6->entries.push_back(Point(-3.0, -11.0));
+	cluster6->data.push_back(Point(-3.0, -11.0));
 	rstartree::Node *cluster6p = cluster6->splitNode();
 
 	// Test the split
-	REQUIRE(cluster6->entries.size() == 3);
-	REQUIRE(std::get<Point>(cluster6->entries[0]) == Point(-3.0, -11.0));
-	REQUIRE(std::get<Point>(cluster6->entries[1]) == Point(-2.0, -9.0));
-	REQUIRE(std::get<Point>(cluster6->entries[2]) == Point(-2.0, -6.0));
-	REQUIRE(cluster6p->entries.size() == 4);
-	REQUIRE(std::get<Point>(cluster6p->entries[0]) == Point(-1.0, -7.0));
-	REQUIRE(std::get<Point>(cluster6p->entries[1]) == Point(1.0, -7.0));
-	REQUIRE(std::get<Point>(cluster6p->entries[2]) == Point(2.0, -6.0));
-	REQUIRE(std::get<Point>(cluster6p->entries[3]) == Point(3.0, -8.0));
+	REQUIRE(cluster6->entryCount() == 3);
+	REQUIRE(cluster6->data[0] == Point(-3.0, -11.0));
+	REQUIRE(cluster6->data[1] == Point(-2.0, -9.0));
+	REQUIRE(cluster6->data[2] == Point(-2.0, -6.0));
+	REQUIRE(cluster6p->entryCount() == 4);
+	REQUIRE(cluster6p->data[0] == Point(-1.0, -7.0));
+	REQUIRE(cluster6p->data[1] == Point(1.0, -7.0));
+	REQUIRE(cluster6p->data[2] == Point(2.0, -6.0));
+	REQUIRE(cluster6p->data[3] == Point(3.0, -8.0));
 	REQUIRE(cluster6p->level == cluster6->level);
 
 	// Test set two
@@ -450,30 +451,30 @@ TEST_CASE("R*Tree: testSplitNode")
 	// (-14, 8), (-10, 8), (-9, 10), (-9, 9), (-8, 10), (-9, 7), (-8, 8), (-8, 9)
 	rstartree::RStarTree tree2(3,7);
 	rstartree::Node *cluster2 = tree2.root;
-	cluster2->entries.push_back(Point(-14.0, 8.0));
-	cluster2->entries.push_back(Point(-10.0, 8.0));
-	cluster2->entries.push_back(Point(-9.0, 10.0));
-	cluster2->entries.push_back(Point(-9.0, 9.0));
-	cluster2->entries.push_back(Point(-8.0, 10.0));
-	cluster2->entries.push_back(Point(-9.0, 7.0));
-	cluster2->entries.push_back(Point(-8.0, 8.0));
-	cluster2->entries.push_back(Point(-8.0, 9.0));
+	cluster2->data.push_back(Point(-14.0, 8.0));
+	cluster2->data.push_back(Point(-10.0, 8.0));
+	cluster2->data.push_back(Point(-9.0, 10.0));
+	cluster2->data.push_back(Point(-9.0, 9.0));
+	cluster2->data.push_back(Point(-8.0, 10.0));
+	cluster2->data.push_back(Point(-9.0, 7.0));
+	cluster2->data.push_back(Point(-8.0, 8.0));
+	cluster2->data.push_back(Point(-8.0, 9.0));
 	cluster2->level = 0;
 
 	// Split the rstartree::Node in two
 	rstartree::Node *cluster2p = cluster2->splitNode();
 
 	// Test the split
-	REQUIRE(cluster2->entries.size() == 3);
-	REQUIRE(std::get<Point>(cluster2->entries[0]) == Point(-9.0, 7.0));
-	REQUIRE(std::get<Point>(cluster2->entries[1]) == Point(-14.0, 8.0));
-	REQUIRE(std::get<Point>(cluster2->entries[2]) == Point(-10.0, 8.0));
-	REQUIRE(cluster2p->entries.size() == 5);
-	REQUIRE(std::get<Point>(cluster2p->entries[0]) == Point(-8.0, 8.0));
-	REQUIRE(std::get<Point>(cluster2p->entries[1]) == Point(-9.0, 9.0));
-	REQUIRE(std::get<Point>(cluster2p->entries[2]) == Point(-8.0, 9.0));
-	REQUIRE(std::get<Point>(cluster2p->entries[3]) == Point(-9.0, 10.0));
-	REQUIRE(std::get<Point>(cluster2p->entries[4]) == Point(-8.0, 10.0));
+	REQUIRE(cluster2->entryCount() == 3);
+	REQUIRE(cluster2->data[0] == Point(-9.0, 7.0));
+	REQUIRE(cluster2->data[1] == Point(-14.0, 8.0));
+	REQUIRE(cluster2->data[2] == Point(-10.0, 8.0));
+	REQUIRE(cluster2p->entryCount() == 5);
+	REQUIRE(cluster2p->data[0] == Point(-8.0, 8.0));
+	REQUIRE(cluster2p->data[1] == Point(-9.0, 9.0));
+	REQUIRE(cluster2p->data[2] == Point(-8.0, 9.0));
+	REQUIRE(cluster2p->data[3] == Point(-9.0, 10.0));
+	REQUIRE(cluster2p->data[4] == Point(-8.0, 10.0));
 	REQUIRE(cluster2->level == cluster2p->level);
 
 	// Test set three
@@ -484,52 +485,52 @@ TEST_CASE("R*Tree: testSplitNode")
 	rstartree::RStarTree tree3(3,5);
 	rstartree::Node *cluster3 = tree3.root;
 	cluster3->level = 1;
-	rstartree::Node *dummys[6] = {new rstartree::Node(tree3), new rstartree::Node(tree3), new rstartree::Node(tree3), new rstartree::Node(tree3), new rstartree::Node(tree3), new rstartree::Node(tree3)};
+	rstartree::Node *dummys[6] = {tree3.nodeArena.create(tree3), tree3.nodeArena.create(tree3), tree3.nodeArena.create(tree3), tree3.nodeArena.create(tree3), tree3.nodeArena.create(tree3), tree3.nodeArena.create(tree3)};
 	dummys[0]->parent = cluster3;
 	dummys[0]->level = 0;
-	cluster3->entries.push_back(createBranchEntry(Rectangle(-6.0, 3.0, -4.0, 5.0), dummys[0]));
+	cluster3->branches.push_back(createBranchEntry(Rectangle(-6.0, 3.0, -4.0, 5.0), dummys[0]));
 	dummys[1]->parent = cluster3;
 	dummys[1]->level = 0;
-	cluster3->entries.push_back(createBranchEntry(Rectangle(-3.0, 3.0, -1.0, 5.0), dummys[1]));
+	cluster3->branches.push_back(createBranchEntry(Rectangle(-3.0, 3.0, -1.0, 5.0), dummys[1]));
 	dummys[2]->parent = cluster3;
 	dummys[2]->level = 0;
-	cluster3->entries.push_back(createBranchEntry(Rectangle(-2.0, 2.0, 0.0, 4.0), dummys[2]));
+	cluster3->branches.push_back(createBranchEntry(Rectangle(-2.0, 2.0, 0.0, 4.0), dummys[2]));
 	dummys[3]->parent = cluster3;
 	dummys[3]->level = 0;
-	cluster3->entries.push_back(createBranchEntry(Rectangle(-2.0, 0.0, 0.0, 2.0), dummys[3]));
+	cluster3->branches.push_back(createBranchEntry(Rectangle(-2.0, 0.0, 0.0, 2.0), dummys[3]));
 	dummys[4]->parent = cluster3;
 	dummys[4]->level = 0;
-	cluster3->entries.push_back(createBranchEntry(Rectangle(-4.0, -1.0, -2.0, 1.0), dummys[4]));
+	cluster3->branches.push_back(createBranchEntry(Rectangle(-4.0, -1.0, -2.0, 1.0), dummys[4]));
 	dummys[5]->parent = cluster3;
 	dummys[5]->level = 0;
-	cluster3->entries.push_back(createBranchEntry(Rectangle(-7.0, 1.0, -5.0, 3.0), dummys[5]));
+	cluster3->branches.push_back(createBranchEntry(Rectangle(-7.0, 1.0, -5.0, 3.0), dummys[5]));
 
 
 	// Extra rstartree::Node causing the split
-	rstartree::Node *cluster3extra = new rstartree::Node(tree3);
-	cluster3extra->entries.push_back(Point(1.0, 1.0));
-	cluster3extra->entries.push_back(Point(2.0, 2.0));
+	rstartree::Node *cluster3extra = tree3.nodeArena.create(tree3);
+	cluster3extra->data.push_back(Point(1.0, 1.0));
+	cluster3extra->data.push_back(Point(2.0, 2.0));
 
 	// Set proper tree levels on everything
 	cluster3extra->level = 0;
 
 	// Test the split
-	cluster3->entries.push_back(createBranchEntry(cluster3extra->boundingBox(), cluster3extra ) );
+	cluster3->branches.push_back(createBranchEntry(cluster3extra->boundingBox(), cluster3extra ) );
 	rstartree::Node *cluster3p = cluster3->splitNode();
 	REQUIRE(cluster3p->level == cluster3->level);
 	REQUIRE(cluster3->level == 1);
 
-	REQUIRE(cluster3->entries.size() == 4);
-	REQUIRE(std::get<rstartree::Node::Branch>(cluster3->entries[0]).boundingBox == Rectangle(-7.0, 1.0, -5.0, 3.0));
-	REQUIRE(std::get<rstartree::Node::Branch>(cluster3->entries[1]).boundingBox == Rectangle(-6.0, 3.0, -4.0, 5.0));
-	REQUIRE(std::get<rstartree::Node::Branch>(cluster3->entries[2]).boundingBox == Rectangle(-4.0, -1.0, -2.0, 1.0));
-	REQUIRE(std::get<rstartree::Node::Branch>(cluster3->entries[3]).boundingBox == Rectangle(-3.0, 3.0, -1.0, 5.0));
-
-	REQUIRE(cluster3p->entries.size() == 3);
-	REQUIRE(std::get<rstartree::Node::Branch>(cluster3p->entries[0]).boundingBox == Rectangle(-2.0, 0.0, 0.0, 2.0));
-	REQUIRE(std::get<rstartree::Node::Branch>(cluster3p->entries[1]).boundingBox == Rectangle(-2.0, 2.0, 0.0, 4.0));
-	REQUIRE(std::get<rstartree::Node::Branch>(cluster3p->entries[2]).boundingBox == Rectangle(1.0, 1.0, 2.0, 2.0));
-	REQUIRE(std::get<rstartree::Node::Branch>(cluster3p->entries[2]).child == cluster3extra);
+	REQUIRE(cluster3->entryCount() == 4);
+	REQUIRE(cluster3->branches[0].boundingBox == Rectangle(-7.0, 1.0, -5.0, 3.0));
+	REQUIRE(cluster3->branches[1].boundingBox == Rectangle(-6.0, 3.0, -4.0, 5.0));
+	REQUIRE(cluster3->branches[2].boundingBox == Rectangle(-4.0, -1.0, -2.0, 1.0));
+	REQUIRE(cluster3->branches[3].boundingBox == Rectangle(-3.0, 3.0, -1.0, 5.0));
+
+	REQUIRE(cluster3p->entryCount() == 3);
+	REQUIRE(cluster3p->branches[0].boundingBox == Rectangle(-2.0, 0.0, 0.0, 2.0));
+	REQUIRE(cluster3p->branches[1].boundingBox == Rectangle(-2.0, 2.0, 0.0, 4.0));
+	REQUIRE(cluster3p->branches[2].boundingBox == Rectangle(1.0, 1.0, 2.0, 2.0));
+	REQUIRE(tree.nodeArena[cluster3p->branches[2].child] == cluster3extra);
 	
 }
 
@@ -544,24 +545,24 @@ TEST_CASE("R*Tree: testInsertOverflowReInsertAndSplit")
 	// Cluster 4, n = 5
 	rstartree::RStarTree tree(3,7);
 	rstartree::Node *root = tree.root;
-	rstartree::Node *cluster4aAugment = new rstartree::Node(tree);
-	cluster4aAugment->entries.push_back(Point(-30.0, -30.0));
-	cluster4aAugment->entries.push_back(Point(30.0, 30.0));
-	cluster4aAugment->entries.push_back(Point(-20.0, -20.0));
-	cluster4aAugment->entries.push_back(Point(20.0, 20.0));
-	cluster4aAugment->entries.push_back(Point(-10.0, -10.0));
-	cluster4aAugment->entries.push_back(Point(10.0, 10.0));
-	cluster4aAugment->entries.push_back(Point(0.0, 0.0));
+	rstartree::Node *cluster4aAugment = tree.nodeArena.create(tree);
+	cluster4aAugment->data.push_back(Point(-30.0, -30.0));
+	cluster4aAugment->data.push_back(Point(30.0, 30.0));
+	cluster4aAugment->data.push_back(Point(-20.0, -20.0));
+	cluster4aAugment->data.push_back(Point(20.0, 20.0));
+	cluster4aAugment->data.push_back(Point(-10.0, -10.0));
+	cluster4aAugment->data.push_back(Point(10.0, 10.0));
+	cluster4aAugment->data.push_back(Point(0.0, 0.0));
 	cluster4aAugment->level = 0;
 
 	// Root rstartree::Node
 	root->level = 1;
-	root->entries.push_back(createBranchEntry(cluster4aAugment->boundingBox(), cluster4aAugment));
+	root->branches.push_back(createBranchEntry(cluster4aAugment->boundingBox(), cluster4aAugment));
 	cluster4aAugment->parent = root;
 
 	Point point(0.0,0.0);
 
-	REQUIRE(cluster4aAugment->entries.size() == 7);
+	REQUIRE(cluster4aAugment->entryCount() == 7);
 	REQUIRE(cluster4aAugment->boundingBox().centrePoint() == Point(0.0,0.0));
 	REQUIRE(root->checksum() == 0);
 
@@ -575,28 +576,28 @@ TEST_CASE("R*Tree: testInsertOverflowReInsertAndSplit")
 	REQUIRE(reInsertedAtLevel[1] == false);
 
 	// Should force split
-	REQUIRE(root->entries.size() == 2);
+	REQUIRE(root->entryCount() == 2);
 	REQUIRE(root->level == 1);
 
 	// We will have split along the x axis (y axis isomorphic so we prefer x).
 	// Overlap is always zero between any cut along X. Cumulative area is minimized at 3,5 or 5,3 split.
 	// We prefer 3,5.
-	rstartree::Node::Branch bLeft = std::get<rstartree::Node::Branch>(root->entries[0]);
-	rstartree::Node::Branch bRight = std::get<rstartree::Node::Branch>(root->entries[1]);
-	REQUIRE(bLeft.child->entries.size() == 3);
-	REQUIRE(bRight.child->entries.size() == 5);
-
-	REQUIRE(std::get<Point>(bLeft.child->entries[0]) == Point(-30,-30));
-	REQUIRE(std::get<Point>(bLeft.child->entries[1]) == Point(-20,-20));
-	REQUIRE(std::get<Point>(bLeft.child->entries[2]) == Point(-10,-10));
-
-	REQUIRE(std::get<Point>(bRight.child->entries[0]) == Point(0,0));
-	REQUIRE(std::get<Point>(bRight.child->entries[1]) == Point(0,0));
-	REQUIRE(std::get<Point>(bRight.child->entries[2]) == Point(10,10));
-	REQUIRE(std::get<Point>(bRight.child->entries[3]) == Point(20,20));
-	REQUIRE(std::get<Point>(bRight.child->entries[4]) == Point(30,30));
-	REQUIRE(bLeft.child->level == 0);
-	REQUIRE(bRight.child->level == 0);
+	rstartree::Node::Branch bLeft = root->branches[0];
+	rstartree::Node::Branch bRight = root->branches[1];
+	REQUIRE(tree.nodeArena[bLeft.child]->entryCount() == 3);
+	REQUIRE(tree.nodeArena[bRight.child]->entryCount() == 5);
+
+	REQUIRE(tree.nodeArena[bLeft.child]->data[0] == Point(-30,-30));
+	REQUIRE(tree.nodeArena[bLeft.child]->data[1] == Point(-20,-20));
+	REQUIRE(tree.nodeArena[bLeft.child]->data[2] == Point(-10,-10));
+
+	REQUIRE(tree.nodeArena[bRight.child]->data[0] == Point(0,0));
+	REQUIRE(tree.nodeArena[bRight.child]->data[1] == Point(0,0));
+	REQUIRE(tree.nodeArena[bRight.child]->data[2] == Point(10,10));
+	REQUIRE(tree.nodeArena[bRight.child]->data[3] == Point(20,20));
+	REQUIRE(tree.nodeArena[bRight.child]->data[4] == Point(30,30));
+	REQUIRE(tree.nodeArena[bLeft.child]->level == 0);
+	REQUIRE(tree.nodeArena[bRight.child]->level == 0);
 }
 
 TEST_CASE("R*Tree: testInsertGrowTreeHeight")
@@ -612,14 +613,14 @@ TEST_CASE("R*Tree: testInsertGrowTreeHeight")
 		root = root->insert(Point(0.0, 0.0), reInsertedAtLevel);
 	}
 
-	REQUIRE(root->entries.size() == 2);
-	rstartree::Node::Branch bLeft = std::get<rstartree::Node::Branch>(root->entries[0]);
-	rstartree::Node::Branch bRight = std::get<rstartree::Node::Branch>(root->entries[1]);
+	REQUIRE(root->entryCount() == 2);
+	rstartree::Node::Branch bLeft = root->branches[0];
+	rstartree::Node::Branch bRight = root->branches[1];
 
-	REQUIRE(bLeft.child->entries.size() == 3);
-	REQUIRE(bLeft.child->level == 0);
-	REQUIRE(bRight.child->entries.size() == 5);
-	REQUIRE(bRight.child->level == 0);
+	REQUIRE(tree.nodeArena[bLeft.child]->entryCount() == 3);
+	REQUIRE(tree.nodeArena[bLeft.child]->level == 0);
+	REQUIRE(tree.nodeArena[bRight.child]->entryCount() == 5);
+	REQUIRE(tree.nodeArena[bRight.child]->level == 0);
 	REQUIRE(root->level == 1);
 }
 
@@ -637,7 +638,7 @@ TEST_CASE("R*Tree: testSplitNonLeafNode")
 		child->level = 0;
 		child->parent = root;
 		rstartree::Node::Branch b(child->boundingBox(), child);
-		root->entries.emplace_back(std::move(b));
+		root->branches.push_back(b);
 	}
 
 	unsigned height = root->height();
@@ -647,30 +648,30 @@ TEST_CASE("R*Tree: testSplitNonLeafNode")
 	std::vector<Point> accumulator = tree.search(Point(0.0, 0.0));
 	REQUIRE(accumulator.size() == maxBranchFactor * maxBranchFactor);
 
-	REQUIRE(root->entries.size() == maxBranchFactor);
+	REQUIRE(root->entryCount() == maxBranchFactor);
 	tree.insert(Point(0.0, 0.0));
 	rstartree::Node *newRoot = tree.root;
 	REQUIRE(newRoot != root);
 
 	// Confirm tree structure
-	REQUIRE(newRoot->entries.size() == 2);
-	const rstartree::Node::Branch &bLeft = std::get<rstartree::Node::Branch>( newRoot->entries[0] );
-	const rstartree::Node::Branch &bRight = std::get<rstartree::Node::Branch>( newRoot->entries[1] );
-	REQUIRE(bLeft.child->entries.size() == 3);
-	REQUIRE(bRight.child->entries.size() == 5);
+	REQUIRE(newRoot->entryCount() == 2);
+	const rstartree::Node::Branch &bLeft = newRoot->branches[0];
+	const rstartree::Node::Branch &bRight = newRoot->branches[1];
+	REQUIRE(tree.nodeArena[bLeft.child]->entryCount() == 3);
+	REQUIRE(tree.nodeArena[bRight.child]->entryCount() == 5);
 
-	for (const auto &entry : bLeft.child->entries)
+	for (const rstartree::Node::Branch &branch : tree.nodeArena[bLeft.child]->branches)
 	{
-		rstartree::Node *child = std::get<rstartree::Node::Branch>(entry).child;
+		rstartree::Node *child = tree.nodeArena[branch.child];
 		// These are all leaves
-		REQUIRE(std::holds_alternative<Point>(child->entries[0]));
+		REQUIRE(!child->data.empty());
 	}
 
-	for (const auto &entry : bRight.child->entries)
+	for (const rstartree::Node::Branch &branch : tree.nodeArena[bRight.child]->branches)
 	{
-		rstartree::Node *child = std::get<rstartree::Node::Branch>(entry).child;
+		rstartree::Node *child = tree.nodeArena[branch.child];
 		// These are all leaves
-		REQUIRE( std::holds_alternative<Point>(child->entries[0]));
+		REQUIRE(!child->data.empty());
 	}
 
 	// Count
@@ -697,26 +698,24 @@ TEST_CASE("R*Tree: RemoveLeafNode")
 
 	//Find a leaf
 	rstartree::Node *node = tree.root;
-	while (std::holds_alternative<rstartree::Node::Branch>(node->entries[0]))
+	while (!node->branches.empty())
 	{
-		const rstartree::Node::Branch &b = std::get<rstartree::Node::Branch>(node->entries[0]);
-		node = b.child;
+		const rstartree::Node::Branch &b = node->branches[0];
+		node = tree.nodeArena[b.child];
 	}
 
-	REQUIRE(std::holds_alternative<Point>(node->entries[0]));
-	size_t cnt = node->entries.size();
-	std::vector<rstartree::Node::NodeEntry> nodesToRemove(node->entries.begin(), node->entries.begin() + (cnt-minBranchFactor + 1));
-	for (const auto &entry : nodesToRemove)
+	REQUIRE(!node->data.empty());
+	size_t cnt = node->data.size();
+	std::vector<Point> nodesToRemove(node->data.begin(), node->data.begin() + (cnt-minBranchFactor + 1));
+	for (const Point &p : nodesToRemove)
 	{
-		const Point &p = std::get<Point>(entry);
 		tree.remove(p);
 	}
 
 	for (unsigned i = 0; i < maxBranchFactor*maxBranchFactor + 1; ++i)
 	{
 		Point p(i, i);
-		rstartree::Node::NodeEntry ne = p;
-		if (std::find(nodesToRemove.begin(), nodesToRemove.end(), ne) == nodesToRemove.end())
+		if (std::find(nodesToRemove.begin(), nodesToRemove.end(), p) == nodesToRemove.end())
 		{
 			REQUIRE(tree.search(p).size() == 1);
 		}
@@ -734,12 +733,12 @@ TEST_CASE("R*Tree: computeTotalMarginSum")
 	// Cluster 4, n = 5
 	rstartree::RStarTree tree(3, 5);
 	rstartree::Node *cluster4aAugment = tree.root;
-	cluster4aAugment->entries.push_back(Point(-20.0, -20.0));
-	cluster4aAugment->entries.push_back(Point(-10.0, -10.0));
-	cluster4aAugment->entries.push_back(Point(0.0, 0.0));
-	cluster4aAugment->entries.push_back(Point(0.0, 0.0));
-	cluster4aAugment->entries.push_back(Point(10.0, 10.0));
-	cluster4aAugment->entries.push_back(Point(20.0, 20.0));
+	cluster4aAugment->data.push_back(Point(-20.0, -20.0));
+	cluster4aAugment->data.push_back(Point(-10.0, -10.0));
+	cluster4aAugment->data.push_back(Point(0.0, 0.0));
+	cluster4aAugment->data.push_back(Point(0.0, 0.0));
+	cluster4aAugment->data.push_back(Point(10.0, 10.0));
+	cluster4aAugment->data.push_back(Point(20.0, 20.0));
 
 	REQUIRE( cluster4aAugment->computeTotalMarginSum() == 160.0 );
 }
@@ -753,75 +752,75 @@ TEST_CASE("R*Tree: testSearch")
 
 	rstartree::RStarTree tree(3,5);
 	rstartree::Node *root = tree.root;
-	rstartree::Node *cluster1a = new rstartree::Node(tree);
-	cluster1a->entries.push_back(Point(-3.0, 16.0));
-	cluster1a->entries.push_back(Point(-3.0, 15.0));
-	cluster1a->entries.push_back(Point(-4.0, 13.0));
+	rstartree::Node *cluster1a = tree.nodeArena.create(tree);
+	cluster1a->data.push_back(Point(-3.0, 16.0));
+	cluster1a->data.push_back(Point(-3.0, 15.0));
+	cluster1a->data.push_back(Point(-4.0, 13.0));
 	cluster1a->level = 0;
 
-	rstartree::Node *cluster1b = new rstartree::Node(tree);
-	cluster1b->entries.push_back(Point(-5.0, 12.0));
-	cluster1b->entries.push_back(Point(-5.0, 15.0));
-	cluster1b->entries.push_back(Point(-6.0, 14.0));
-	cluster1b->entries.push_back(Point(-8.0, 16.0));
+	rstartree::Node *cluster1b = tree.nodeArena.create(tree);
+	cluster1b->data.push_back(Point(-5.0, 12.0));
+	cluster1b->data.push_back(Point(-5.0, 15.0));
+	cluster1b->data.push_back(Point(-6.0, 14.0));
+	cluster1b->data.push_back(Point(-8.0, 16.0));
 	cluster1b->level = 0;
 
 	// Cluster 2, n = 8
 	// (-14, 8), (-10, 8), (-9, 10), (-9, 9), (-8, 10), (-9, 7), (-8, 8), (-8, 9)
-	rstartree::Node *cluster2a = new rstartree::Node(tree);
-	cluster2a->entries.push_back(Point(-8.0, 10.0));
-	cluster2a->entries.push_back(Point(-9.0, 10.0));
-	cluster2a->entries.push_back(Point(-8.0, 9.0));
-	cluster2a->entries.push_back(Point(-9.0, 9.0));
-	cluster2a->entries.push_back(Point(-8.0, 8.0));
+	rstartree::Node *cluster2a = tree.nodeArena.create(tree);
+	cluster2a->data.push_back(Point(-8.0, 10.0));
+	cluster2a->data.push_back(Point(-9.0, 10.0));
+	cluster2a->data.push_back(Point(-8.0, 9.0));
+	cluster2a->data.push_back(Point(-9.0, 9.0));
+	cluster2a->data.push_back(Point(-8.0, 8.0));
 	cluster2a->level = 0;
 
-	rstartree::Node *cluster2b = new rstartree::Node(tree);
-	cluster2b->entries.push_back(Point(-14.0, 8.0));
-	cluster2b->entries.push_back(Point(-10.0, 8.0));
-	cluster2b->entries.push_back(Point(-9.0, 7.0));
+	rstartree::Node *cluster2b = tree.nodeArena.create(tree);
+	cluster2b->data.push_back(Point(-14.0, 8.0));
+	cluster2b->data.push_back(Point(-10.0, 8.0));
+	cluster2b->data.push_back(Point(-9.0, 7.0));
 	cluster2b->level = 0;
 
 	// Cluster 3, n = 9
 	// (-5, 4), (-3, 4), (-2, 4), (-4, 3), (-1, 3), (-6, 2), (-4, 1), (-3, 0), (-1, 1)
-	rstartree::Node *cluster3a = new rstartree::Node(tree);
-	cluster3a->entries.push_back(Point(-3.0, 4.0));
-	cluster3a->entries.push_back(Point(-3.0, 0.0));
-	cluster3a->entries.push_back(Point(-2.0, 4.0));
-	cluster3a->entries.push_back(Point(-1.0, 3.0));
-	cluster3a->entries.push_back(Point(-1.0, 1.0));
+	rstartree::Node *cluster3a = tree.nodeArena.create(tree);
+	cluster3a->data.push_back(Point(-3.0, 4.0));
+	cluster3a->data.push_back(Point(-3.0, 0.0));
+	cluster3a->data.push_back(Point(-2.0, 4.0));
+	cluster3a->data.push_back(Point(-1.0, 3.0));
+	cluster3a->data.push_back(Point(-1.0, 1.0));
 	cluster3a->level = 0;
 
-	rstartree::Node *cluster3b = new rstartree::Node(tree);
-	cluster3b->entries.push_back(Point(-5.0, 4.0));
-	cluster3b->entries.push_back(Point(-4.0, 3.0));
-	cluster3b->entries.push_back(Point(-4.0, 1.0));
-	cluster3b->entries.push_back(Point(-6.0, 2.0));
+	rstartree::Node *cluster3b = tree.nodeArena.create(tree);
+	cluster3b->data.push_back(Point(-5.0, 4.0));
+	cluster3b->data.push_back(Point(-4.0, 3.0));
+	cluster3b->data.push_back(Point(-4.0, 1.0));
+	cluster3b->data.push_back(Point(-6.0, 2.0));
 	cluster3b->level = 0;
 
 	// High level rstartree::Nodes
-	rstartree::Node *left = new rstartree::Node(tree);
+	rstartree::Node *left = tree.nodeArena.create(tree);
 	cluster1a->parent = left;
-	left->entries.push_back(createBranchEntry(cluster1a->boundingBox(), cluster1a));
+	left->branches.push_back(createBranchEntry(cluster1a->boundingBox(), cluster1a));
 	cluster1b->parent = left;
-	left->entries.push_back(createBranchEntry(cluster1b->boundingBox(), cluster1b));
+	left->branches.push_back(createBranchEntry(cluster1b->boundingBox(), cluster1b));
 	cluster2a->parent = left;
-	left->entries.push_back(createBranchEntry(cluster2a->boundingBox(), cluster2a));
+	left->branches.push_back(createBranchEntry(cluster2a->boundingBox(), cluster2a));
 	cluster2b->parent = left;
-	left->entries.push_back(createBranchEntry(cluster2b->boundingBox(), cluster2b));
+	left->branches.push_back(createBranchEntry(cluster2b->boundingBox(), cluster2b));
 	left->level = 1;
 
-	rstartree::Node *right = new rstartree::Node(tree);
+	rstartree::Node *right = tree.nodeArena.create(tree);
 	cluster3a->parent = right;
-	right->entries.push_back(createBranchEntry(cluster3a->boundingBox(), cluster3a));
+	right->branches.push_back(createBranchEntry(cluster3a->boundingBox(), cluster3a));
 	cluster3b->parent = right;
-	right->entries.push_back(createBranchEntry(cluster3b->boundingBox(), cluster3b));
+	right->branches.push_back(createBranchEntry(cluster3b->boundingBox(), cluster3b));
 	right->level = 1;
 
 	left->parent = root;
-	root->entries.push_back(createBranchEntry(left->boundingBox(), left));
+	root->branches.push_back(createBranchEntry(left->boundingBox(), left));
 	right->parent = root;
-	root->entries.push_back(createBranchEntry(right->boundingBox(), right));
+	root->branches.push_back(createBranchEntry(right->boundingBox(), right));
 	root->level = 2;
 
 	// Test search
@@ -889,16 +888,16 @@ TEST_CASE("R*Tree: reInsertAccountsForNewTreeDepth")
 	std::vector<rstartree::Node *> middleLayer;
 	for (unsigned i = 0; i < 5; i++)
 	{
-		rstartree::Node *child = new rstartree::Node(tree);
+		rstartree::Node *child = tree.nodeArena.create(tree);
 		child->level = 1;
 		child->parent = root;
 		for (unsigned j = 0; j < 5; j++)
 		{
 			rstartree::Node *leaf = leafNodes.at(5*i + j);
-			child->entries.push_back(createBranchEntry(leaf->boundingBox(), leaf));
+			child->branches.push_back(createBranchEntry(leaf->boundingBox(), leaf));
 			leaf->parent = child;
 		}
-		root->entries.push_back(createBranchEntry(child->boundingBox(), child));
+		root->branches.push_back(createBranchEntry(child->boundingBox(), child));
 		middleLayer.push_back(child);
 	}
 
@@ -909,16 +908,16 @@ TEST_CASE("R*Tree: reInsertAccountsForNewTreeDepth")
 	rstartree::Node *leaf = leafNodes.at(maxBranchFactor*maxBranchFactor);
 	leaf->level = 0;
 	leaf->parent = middleLayer.at(0);
-	middleLayer.at(0)->entries.push_back(createBranchEntry(leaf->boundingBox(), leaf));
+	middleLayer.at(0)->branches.push_back(createBranchEntry(leaf->boundingBox(), leaf));
 
 	leaf = leafNodes.at(maxBranchFactor*maxBranchFactor+1);
 	leaf->level = 0;
 	leaf->parent = middleLayer.at(0);
-	middleLayer.at(0)->entries.push_back(createBranchEntry(leaf->boundingBox(), leaf));
+	middleLayer.at(0)->branches.push_back(createBranchEntry(leaf->boundingBox(), leaf));
 
 	std::vector<bool> hasReinsertedOnLevel = {false, true, false};
 
-	REQUIRE(middleLayer.at(0)->entries.size() > maxBranchFactor );
+	REQUIRE(middleLayer.at(0)->entryCount() > maxBranchFactor );
 	middleLayer.at(0)->reInsert(hasReinsertedOnLevel);
 
 	for (rstartree::Node *leaf : leafNodes)
@@ -936,3 +935,457 @@ TEST_CASE("R*Tree: reInsertAccountsForNewTreeDepth")
 	REQUIRE(root->parent->level == 3);
 }
 
+
+TEST_CASE("R*Tree: testBulkLoad")
+{
+	unsigned minBranchFactor = 3;
+	unsigned maxBranchFactor = 7;
+	rstartree::RStarTree tree(minBranchFactor, maxBranchFactor);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 40; ++i)
+	{
+		for (unsigned j = 0; j < 25; ++j)
+		{
+			points.push_back(Point(i * 1.0, j * 2.0));
+		}
+	}
+	tree.bulkLoad(points);
+
+	// Every node but the root is filled within its bounds and levels line up
+	std::stack<rstartree::Node *> context;
+	context.push(tree.root);
+	unsigned leafPoints = 0;
+	while (!context.empty())
+	{
+		rstartree::Node *node = context.top();
+		context.pop();
+
+		REQUIRE(node->entryCount() <= maxBranchFactor);
+		if (node != tree.root)
+		{
+			REQUIRE(node->entryCount() >= minBranchFactor);
+			REQUIRE(node->parent->level == node->level + 1);
+		}
+
+		if (node->isLeafNode())
+		{
+			leafPoints += node->entryCount();
+		}
+		else
+		{
+			for (const rstartree::Node::Branch &b : node->branches)
+			{
+				REQUIRE(tree.nodeArena[b.child]->parent == node);
+				REQUIRE(b.boundingBox == tree.nodeArena[b.child]->boundingBox());
+				context.push(tree.nodeArena[b.child]);
+			}
+		}
+	}
+	REQUIRE(leafPoints == points.size());
+	REQUIRE(tree.hasReinsertedOnLevel.size() == tree.root->level + 1);
+
+	// Every point can be found and a range search returns exactly what it covers
+	for (const Point &p : points)
+	{
+		std::vector<Point> v = tree.search(p);
+		REQUIRE(v.size() == 1);
+		REQUIRE(v[0] == p);
+	}
+	REQUIRE(tree.search(Rectangle(10.0, 10.0, 19.0, 19.0)).size() == 10 * 5);
+
+	// The packed tree keeps working dynamically
+	tree.insert(Point(100.0, 100.0));
+	REQUIRE(tree.search(Point(100.0, 100.0)).size() == 1);
+	for (const Point &p : points)
+	{
+		tree.remove(p);
+	}
+	REQUIRE(tree.search(Point(0.0, 0.0)).empty());
+	REQUIRE(tree.search(Point(100.0, 100.0)).size() == 1);
+}
+
+TEST_CASE("R*Tree: testInsertBatch")
+{
+	rstartree::RStarTree tree(3, 7);
+
+	// Two batches so the second lands in an already populated tree
+	std::vector<Point> firstBatch;
+	std::vector<Point> secondBatch;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		Point p((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001);
+		if (i % 2 == 0)
+		{
+			firstBatch.push_back(p);
+		}
+		else
+		{
+			secondBatch.push_back(p);
+		}
+	}
+	tree.insertBatch(firstBatch);
+	tree.insertBatch(secondBatch);
+
+	for (Point &p : firstBatch)
+	{
+		std::vector<Point> v = tree.search(p);
+		REQUIRE(v.size() == 1);
+		REQUIRE(v[0] == p);
+	}
+	for (Point &p : secondBatch)
+	{
+		std::vector<Point> v = tree.search(p);
+		REQUIRE(v.size() == 1);
+		REQUIRE(v[0] == p);
+	}
+}
+
+TEST_CASE("R*Tree: testSearchBatch")
+{
+	rstartree::RStarTree tree(3, 7);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	tree.bulkLoad(points);
+
+	// More than one chunk of queries, some of them empty
+	std::vector<Rectangle> rectangles;
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		double x = (i * 13 % 110) * 1.0;
+		double y = (i * 29 % 105) * 1.0;
+		rectangles.push_back(Rectangle(x, y, x + (i % 7) * 3.0, y + (i % 5) * 4.0));
+	}
+
+	std::vector<std::vector<Point>> vs = tree.searchBatch(rectangles);
+	REQUIRE(vs.size() == rectangles.size());
+	for (unsigned i = 0; i < rectangles.size(); ++i)
+	{
+		std::vector<Point> v = tree.search(rectangles[i]);
+		REQUIRE(vs[i].size() == v.size());
+		REQUIRE(std::is_permutation(vs[i].begin(), vs[i].end(), v.begin()));
+	}
+}
+
+TEST_CASE("R*Tree: testSearchVisitor")
+{
+	rstartree::RStarTree tree(3, 7);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	tree.bulkLoad(points);
+
+	Rectangle searchRectangle(20.0, 10.0, 60.0, 45.0);
+	std::vector<Point> v = tree.search(searchRectangle);
+	REQUIRE(v.size() > 0);
+
+	// Directly through the tree
+	std::vector<Point> visited;
+	tree.search(searchRectangle, [&visited](const Point &p) { visited.push_back(p); });
+	REQUIRE(visited.size() == v.size());
+	REQUIRE(std::is_permutation(visited.begin(), visited.end(), v.begin()));
+
+	// Through the index interface, with a visitor that starts a search of its own
+	Index &index = tree;
+	unsigned visitedCount = 0;
+	unsigned nestedCount = 0;
+	index.search(searchRectangle, [&](const Point &p)
+	{
+		++visitedCount;
+		tree.search(Rectangle(p, p), [&nestedCount](const Point &) { ++nestedCount; });
+	});
+	REQUIRE(visitedCount == v.size());
+	REQUIRE(nestedCount == v.size());
+}
+
+TEST_CASE("R*Tree: testNearest")
+{
+	rstartree::RStarTree tree(3, 7);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0 + i * 0.0001, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	tree.bulkLoad(points);
+
+	// Compare against brute force distances from a few query points inside and outside the data
+	std::vector<Point> queries = {Point(50.0, 50.0), points[17], Point(-20.0, 130.0)};
+	for (Point &query : queries)
+	{
+		std::vector<double> expected;
+		for (Point &p : points)
+		{
+			expected.push_back(p.distance(query));
+		}
+		std::sort(expected.begin(), expected.end());
+
+		std::vector<Point> v = tree.nearest(query, 10);
+		REQUIRE(v.size() == 10);
+		for (unsigned i = 0; i < v.size(); ++i)
+		{
+			REQUIRE(v[i].distance(query) == expected[i]);
+		}
+	}
+
+	// Asking for more points than the tree holds returns all of them
+	REQUIRE(tree.nearest(Point(0.0, 0.0), 1000).size() == points.size());
+}
+
+TEST_CASE("R*Tree: testCount")
+{
+	rstartree::RStarTree tree(3, 7);
+
+	// Mix single inserts, a batch and removals so every count update path is exercised
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 900; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		tree.insert(points[i]);
+	}
+	tree.insertBatch(std::vector<Point>(points.begin() + 600, points.end()));
+	for (unsigned i = 0; i < 900; i += 3)
+	{
+		tree.remove(points[i]);
+	}
+
+	REQUIRE(tree.count(Rectangle(-1.0, -1.0, 200.0, 200.0)) == 600);
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		double x = (i * 13 % 110) * 1.0;
+		double y = (i * 29 % 105) * 1.0;
+		Rectangle r(x, y, x + (i % 7) * 9.0, y + (i % 5) * 12.0);
+		REQUIRE(tree.count(r) == tree.search(r).size());
+	}
+}
+
+TEST_CASE("R*Tree: testConcurrentSearch")
+{
+	rstartree::RStarTree tree(3, 7);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 900; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	for (Point &p : points)
+	{
+		tree.insert(p);
+	}
+
+	std::vector<Rectangle> rectangles;
+	for (unsigned i = 0; i < 200; ++i)
+	{
+		double x = (i * 13 % 110) * 1.0;
+		double y = (i * 29 % 105) * 1.0;
+		rectangles.push_back(Rectangle(x, y, x + (i % 7) * 9.0, y + (i % 5) * 12.0));
+	}
+
+	// Search from several threads at once through the const interface
+	const Index &index = tree;
+	std::vector<unsigned> pointMatches(points.size(), 0);
+	std::vector<unsigned> rectangleMatches(rectangles.size(), 0);
+	#pragma omp parallel for num_threads(4) schedule(dynamic)
+	for (unsigned i = 0; i < points.size(); ++i)
+	{
+		pointMatches[i] = index.search(points[i]).size();
+	}
+	#pragma omp parallel for num_threads(4) schedule(dynamic)
+	for (unsigned i = 0; i < rectangles.size(); ++i)
+	{
+		rectangleMatches[i] = index.search(rectangles[i]).size();
+	}
+
+	for (unsigned i = 0; i < points.size(); ++i)
+	{
+		REQUIRE(pointMatches[i] == 1);
+	}
+	for (unsigned i = 0; i < rectangles.size(); ++i)
+	{
+		REQUIRE(rectangleMatches[i] == tree.search(rectangles[i]).size());
+	}
+}
+
+TEST_CASE("R*Tree: testNodeHandles")
+{
+	rstartree::RStarTree tree(3, 7);
+
+	// Enough nodes to fill several slabs of the node arena
+	std::vector<rstartree::Node *> nodes;
+	for (unsigned i = 0; i < 40000; ++i)
+	{
+		nodes.push_back(tree.nodeArena.create(tree));
+	}
+
+	unsigned roundTrips = 0;
+	for (rstartree::Node *node : nodes)
+	{
+		roundTrips += tree.nodeArena[tree.nodeArena.handle(node)] == node;
+	}
+	REQUIRE(roundTrips == nodes.size());
+
+	// Reused slots are named by the same handle as before
+	NodeHandle handle = tree.nodeArena.handle(nodes[12345]);
+	tree.nodeArena.destroy(nodes[12345]);
+	rstartree::Node *reused = tree.nodeArena.create(tree);
+	REQUIRE(reused == nodes[12345]);
+	REQUIRE(tree.nodeArena.handle(reused) == handle);
+
+	// Branches reach their children through handles
+	tree.root->level = 1;
+	tree.root->branches.push_back(rstartree::Node::Branch(Rectangle(0.0, 0.0, 1.0, 1.0), nodes[39999]));
+	REQUIRE(tree.root->childOf(tree.root->branches[0]) == nodes[39999]);
+	tree.root->branches.clear();
+	tree.root->level = 0;
+}
+
+TEST_CASE("R*Tree: testFanoutFromNodeBytes")
+{
+	// A page sized node holds the largest fanout plus the overflowing entry but not one more
+	unsigned maxBranchFactor = nodesizing::maxFanout<rstartree::RStarTree>(nodesizing::pageBytes);
+	size_t entryBytes = std::max(rstartree::RStarTree::leafEntryBytes, rstartree::RStarTree::branchEntryBytes);
+	REQUIRE((maxBranchFactor + 1) * entryBytes <= nodesizing::pageBytes);
+	REQUIRE((maxBranchFactor + 2) * entryBytes > nodesizing::pageBytes);
+	REQUIRE(nodesizing::minFanout<rstartree::RStarTree>(nodesizing::pageBytes) == maxBranchFactor / 2);
+
+	// Leaf entries start on a cache line
+	rstartree::RStarTree tree(nodesizing::minFanout<rstartree::RStarTree>(nodesizing::pageBytes), maxBranchFactor);
+	for (unsigned i = 0; i < 1000; ++i)
+	{
+		tree.insert(Point(i * 1.0, (i * 37 % 1000) * 1.0));
+	}
+
+	std::stack<rstartree::Node *> context;
+	context.push(tree.root);
+	unsigned misaligned = 0;
+	for (;!context.empty();)
+	{
+		rstartree::Node *node = context.top();
+		context.pop();
+		if (node->isLeafNode())
+		{
+			misaligned += (uintptr_t) node->data.data() % nodesizing::cacheLineBytes != 0;
+		}
+		for (const rstartree::Node::Branch &b : node->branches)
+		{
+			context.push(tree.nodeArena[b.child]);
+		}
+	}
+	REQUIRE(misaligned == 0);
+	REQUIRE(tree.checksum() == 999000);
+}
+
+TEST_CASE("R*Tree: testSnapshot")
+{
+	rstartree::RStarTree tree(3, 7);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 900; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	for (Point &p : points)
+	{
+		tree.insert(p);
+	}
+
+	const std::string path = "testRStarTreeSnapshot.bin";
+	REQUIRE(tree.save(path));
+
+	rstartree::RStarTree loaded(3, 7);
+	REQUIRE(loaded.load(path));
+	REQUIRE(loaded.root->level == tree.root->level);
+	REQUIRE(loaded.checksum() == tree.checksum());
+	REQUIRE(loaded.count(Rectangle(-1.0, -1.0, 200.0, 200.0)) == 900);
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		double x = (i * 13 % 110) * 1.0;
+		double y = (i * 29 % 105) * 1.0;
+		Rectangle r(x, y, x + (i % 7) * 9.0, y + (i % 5) * 12.0);
+		REQUIRE(loaded.search(r).size() == tree.search(r).size());
+	}
+
+	// The loaded tree keeps working as a tree
+	for (unsigned i = 0; i < 900; i += 2)
+	{
+		loaded.remove(points[i]);
+	}
+	REQUIRE(loaded.count(Rectangle(-1.0, -1.0, 200.0, 200.0)) == 450);
+
+	// A truncated snapshot is refused and leaves the tree empty
+	std::vector<char> bytes;
+	{
+		std::ifstream in(path, std::ios::binary);
+		bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+	{
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		out.write(bytes.data(), bytes.size() / 2);
+	}
+	REQUIRE(!loaded.load(path));
+	REQUIRE(loaded.checksum() == 0);
+
+	std::remove(path.c_str());
+}
+
+TEST_CASE("R*Tree: testPagedRStarTree")
+{
+	rstartree::RStarTree tree(3, 7);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 900; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	for (Point &p : points)
+	{
+		tree.insert(p);
+	}
+
+	const std::string path = "testPagedRStarTree.bin";
+	REQUIRE(rstartree::PagedRStarTree::build(tree, path));
+
+	rstartree::PagedRStarTree pagedTree(path);
+	REQUIRE(pagedTree.good());
+	REQUIRE(pagedTree.size() == 900);
+	REQUIRE(pagedTree.checksum() == tree.checksum());
+	REQUIRE(pagedTree.count(Rectangle(-1.0, -1.0, 200.0, 200.0)) == 900);
+	for (unsigned i = 0; i < 100; ++i)
+	{
+		double x = (i * 13 % 110) * 1.0;
+		double y = (i * 29 % 105) * 1.0;
+		Rectangle r(x, y, x + (i % 7) * 9.0, y + (i % 5) * 12.0);
+		std::vector<Point> expected = tree.search(r);
+		std::vector<Point> v = pagedTree.search(r);
+		REQUIRE(v.size() == expected.size());
+		REQUIRE(std::is_permutation(v.begin(), v.end(), expected.begin()));
+		REQUIRE(pagedTree.count(r) == expected.size());
+	}
+	for (unsigned i = 0; i < 900; i += 7)
+	{
+		REQUIRE(pagedTree.search(points[i]).size() == 1);
+	}
+
+	// Leaves of 300 points do not fit a 4KB page of two dimensional points but do fit 16KB
+	rstartree::RStarTree wideTree(150, 300);
+	wideTree.bulkLoad(points);
+	REQUIRE(!rstartree::PagedRStarTree::build(wideTree, path));
+	REQUIRE(rstartree::PagedRStarTree::build(wideTree, path, 4 * nodesizing::pageBytes));
+	rstartree::PagedRStarTree widePagedTree(path);
+	REQUIRE(widePagedTree.good());
+	REQUIRE(widePagedTree.checksum() == wideTree.checksum());
+	REQUIRE(widePagedTree.search(Rectangle(-1.0, -1.0, 200.0, 200.0)).size() == 900);
+
+	std::remove(path.c_str());
+	REQUIRE(!rstartree::PagedRStarTree(path).good());
+}
@@ -0,0 +1,222 @@
+#include <catch2/catch.hpp>
+#include <rtree/rtree.h>
+#include <util/geometry.h>
+
+TEST_CASE("RTree: testBulkLoad")
+{
+	unsigned minBranchFactor = 3;
+	unsigned maxBranchFactor = 5;
+	rtree::RTree tree(minBranchFactor, maxBranchFactor);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 40; ++i)
+	{
+		for (unsigned j = 0; j < 25; ++j)
+		{
+			points.push_back(Point(i * 1.0, j * 2.0));
+		}
+	}
+	std::vector<Point> loaded(points);
+	tree.bulkLoad(loaded);
+
+	REQUIRE(tree.validate());
+	REQUIRE(tree.checksum() == 20 * 39 * 25 + 25 * 24 * 40);
+
+	// Every node but the root is filled within its bounds and leaves share a depth
+	std::stack<std::pair<rtree::Node *, unsigned>> context;
+	context.push({tree.root, 1});
+	unsigned height = tree.root->height();
+	while (!context.empty())
+	{
+		rtree::Node *node = context.top().first;
+		unsigned depth = context.top().second;
+		context.pop();
+
+		unsigned fanout = node->children.empty() ? node->data.size() : node->children.size();
+		REQUIRE(fanout <= maxBranchFactor);
+		if (node != tree.root)
+		{
+			REQUIRE(fanout >= minBranchFactor);
+		}
+
+		if (node->children.empty())
+		{
+			REQUIRE(depth == height);
+		}
+		for (rtree::Node *child : node->children)
+		{
+			context.push({child, depth + 1});
+		}
+	}
+
+	// Every point can be found and range searches match a scan
+	for (Point &p : points)
+	{
+		std::vector<Point> v = tree.search(p);
+		REQUIRE(v.size() == 1);
+		REQUIRE(v[0] == p);
+	}
+	REQUIRE(tree.search(Rectangle(10.0, 10.0, 19.0, 19.0)).size() == 10 * 5);
+
+	// The packed tree keeps working dynamically
+	tree.insert(Point(100.0, 100.0));
+	REQUIRE(tree.search(Point(100.0, 100.0)).size() == 1);
+	for (Point &p : points)
+	{
+		tree.remove(p);
+	}
+	REQUIRE(tree.search(Point(0.0, 0.0)).empty());
+	REQUIRE(tree.search(Point(100.0, 100.0)).size() == 1);
+}
+
+TEST_CASE("RTree: testInsertBatch")
+{
+	rtree::RTree tree(3, 5);
+
+	// Two batches so the second lands in an already populated tree
+	std::vector<Point> firstBatch;
+	std::vector<Point> secondBatch;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		Point p((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001);
+		if (i % 2 == 0)
+		{
+			firstBatch.push_back(p);
+		}
+		else
+		{
+			secondBatch.push_back(p);
+		}
+	}
+	tree.insertBatch(firstBatch);
+	tree.insertBatch(secondBatch);
+	REQUIRE(tree.validate());
+
+	for (Point &p : firstBatch)
+	{
+		std::vector<Point> v = tree.search(p);
+		REQUIRE(v.size() == 1);
+		REQUIRE(v[0] == p);
+	}
+	for (Point &p : secondBatch)
+	{
+		std::vector<Point> v = tree.search(p);
+		REQUIRE(v.size() == 1);
+		REQUIRE(v[0] == p);
+	}
+}
+
+TEST_CASE("RTree: testSearchVisitor")
+{
+	rtree::RTree tree(3, 5);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	tree.bulkLoad(points);
+
+	Rectangle searchRectangle(20.0, 10.0, 60.0, 45.0);
+	std::vector<Point> v = tree.search(searchRectangle);
+	REQUIRE(v.size() > 0);
+
+	// Directly through the tree
+	std::vector<Point> visited;
+	tree.search(searchRectangle, [&visited](const Point &p) { visited.push_back(p); });
+	REQUIRE(visited.size() == v.size());
+	REQUIRE(std::is_permutation(visited.begin(), visited.end(), v.begin()));
+
+	// Through the index interface, with a visitor that starts a search of its own
+	Index &index = tree;
+	unsigned visitedCount = 0;
+	unsigned nestedCount = 0;
+	index.search(searchRectangle, [&](const Point &p)
+	{
+		++visitedCount;
+		tree.search(Rectangle(p, p), [&nestedCount](const Point &) { ++nestedCount; });
+	});
+	REQUIRE(visitedCount == v.size());
+	REQUIRE(nestedCount == v.size());
+}
+
+TEST_CASE("RTree: testNearest")
+{
+	rtree::RTree tree(3, 5);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 600; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0 + i * 0.0001, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	tree.bulkLoad(points);
+
+	// Compare against brute force distances from a few query points inside and outside the data
+	std::vector<Point> queries = {Point(50.0, 50.0), points[17], Point(-20.0, 130.0)};
+	for (Point &query : queries)
+	{
+		std::vector<double> expected;
+		for (Point &p : points)
+		{
+			expected.push_back(p.distance(query));
+		}
+		std::sort(expected.begin(), expected.end());
+
+		std::vector<Point> v = tree.nearest(query, 10);
+		REQUIRE(v.size() == 10);
+		for (unsigned i = 0; i < v.size(); ++i)
+		{
+			REQUIRE(v[i].distance(query) == expected[i]);
+		}
+	}
+
+	// Asking for more points than the tree holds returns all of them
+	REQUIRE(tree.nearest(Point(0.0, 0.0), 1000).size() == points.size());
+}
+
+static unsigned reachableNodes(rtree::Node *root)
+{
+	unsigned nodes = 0;
+	std::vector<rtree::Node *> context = {root};
+	for (;!context.empty();)
+	{
+		rtree::Node *currentContext = context.back();
+		context.pop_back();
+		++nodes;
+		context.insert(context.end(), currentContext->children.begin(), currentContext->children.end());
+	}
+
+	return nodes;
+}
+
+TEST_CASE("RTree: testNodeArena")
+{
+	rtree::RTree tree(3, 6);
+
+	std::vector<Point> points;
+	for (unsigned i = 0; i < 900; ++i)
+	{
+		points.push_back(Point((i * 37 % 101) * 1.0, (i * 53 % 97) * 1.0 + i * 0.001));
+	}
+	for (Point &p : points)
+	{
+		tree.insert(p);
+	}
+	REQUIRE(tree.nodeArena.liveNodes() == reachableNodes(tree.root));
+	size_t bytes = tree.nodeArena.bytes();
+
+	// Condensing frees nodes which must go back to the arena
+	for (unsigned i = 0; i < 900; i += 2)
+	{
+		tree.remove(points[i]);
+	}
+	REQUIRE(tree.nodeArena.liveNodes() == reachableNodes(tree.root));
+
+	// Growing back to the same size reuses the freed nodes before asking for more slabs
+	for (unsigned i = 0; i < 900; i += 2)
+	{
+		tree.insert(points[i]);
+	}
+	REQUIRE(tree.nodeArena.liveNodes() == reachableNodes(tree.root));
+	REQUIRE(tree.nodeArena.bytes() <= 2 * bytes);
+}
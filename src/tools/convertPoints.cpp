@@ -0,0 +1,111 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cctype>
+#include <unistd.h>
+#include <util/pointFile.h>
+
+// Converts a text data file of whitespace separated coordinates, as the file backed benchmarks
+// read, into a binary point file. Text is read a large chunk at a time and only whole numbers are
+// parsed from each chunk, whatever number was cut off at its end carries over to the next.
+int main(int argc, char *argv[])
+{
+	unsigned pointDimensions = 2;
+	int option;
+	while ((option = getopt(argc, argv, "d:")) != -1)
+	{
+		switch (option)
+		{
+			case 'd': // Dimensions
+			{
+				pointDimensions = atoi(optarg);
+				break;
+			}
+			default:
+			{
+				optind = argc + 1;
+				break;
+			}
+		}
+	}
+
+	if (optind + 2 != argc || pointDimensions == 0)
+	{
+		std::cout << "Usage: convertPoints [-d dimensions] <text file> <binary file>" << std::endl;
+		return 1;
+	}
+
+	std::FILE *text = std::fopen(argv[optind], "rb");
+	if (text == nullptr)
+	{
+		std::cout << "Could not read from file: " << argv[optind] << std::endl;
+		return 1;
+	}
+
+	pointfile::Writer writer(argv[optind + 1], pointDimensions);
+	constexpr size_t chunkBytes = 1 << 24;
+	std::vector<char> chunk(chunkBytes + 1);
+	std::vector<double> coordinates;
+	coordinates.reserve(pointDimensions);
+	size_t filled = 0;
+	bool bad = false;
+
+	for (bool last = false; !last && !bad;)
+	{
+		filled += std::fread(chunk.data() + filled, 1, chunkBytes - filled, text);
+		last = filled < chunkBytes;
+
+		// Parse up to the last whitespace unless this is the end of the file
+		size_t end = filled;
+		if (!last)
+		{
+			for (; end > 0 && !std::isspace((unsigned char) chunk[end - 1]); --end) {}
+			if (end == 0)
+			{
+				bad = true;
+				break;
+			}
+		}
+
+		char kept = chunk[end];
+		chunk[end] = '\0';
+		for (char *cursor = chunk.data();;)
+		{
+			char *next;
+			double value = std::strtod(cursor, &next);
+			if (next == cursor)
+			{
+				// Anything other than trailing whitespace is not a number
+				for (; std::isspace((unsigned char) *cursor); ++cursor) {}
+				bad = *cursor != '\0';
+				break;
+			}
+			cursor = next;
+
+			coordinates.push_back(value);
+			if (coordinates.size() == pointDimensions)
+			{
+				writer.write(coordinates.data());
+				coordinates.clear();
+			}
+		}
+		chunk[end] = kept;
+
+		std::memmove(chunk.data(), chunk.data() + end, filled - end);
+		filled -= end;
+	}
+
+	bad = bad || std::ferror(text) || !coordinates.empty();
+	std::fclose(text);
+	if (!writer.close() || bad)
+	{
+		std::cout << "Could not convert " << argv[optind] << ", stopped after " << writer.size() << " points" << std::endl;
+		return 1;
+	}
+
+	std::cout << "Converted " << writer.size() << " points of " << pointDimensions << " dimensions" << std::endl;
+	return 0;
+}
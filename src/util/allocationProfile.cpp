@@ -0,0 +1,62 @@
+#include <util/allocationProfile.h>
+
+#ifdef ALLOCPROFILE
+#include <new>
+#include <cstdlib>
+
+// The global allocation functions replaced so that every new made by the trees and the standard
+// containers they use is counted. They allocate exactly as the defaults would.
+namespace
+{
+	void *allocate(size_t bytes)
+	{
+		allocationprofile::countAllocation(bytes);
+		void *memory = std::malloc(bytes == 0 ? 1 : bytes);
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		return memory;
+	}
+
+	void *allocateAligned(size_t bytes, std::align_val_t alignment)
+	{
+		allocationprofile::countAllocation(bytes);
+		size_t boundary = static_cast<size_t>(alignment);
+		void *memory = std::aligned_alloc(boundary, (bytes + boundary - 1) / boundary * boundary + (bytes == 0 ? boundary : 0));
+		if (memory == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		return memory;
+	}
+}
+
+void *operator new(size_t bytes) { return allocate(bytes); }
+void *operator new[](size_t bytes) { return allocate(bytes); }
+void *operator new(size_t bytes, std::align_val_t alignment) { return allocateAligned(bytes, alignment); }
+void *operator new[](size_t bytes, std::align_val_t alignment) { return allocateAligned(bytes, alignment); }
+
+void *operator new(size_t bytes, const std::nothrow_t &) noexcept
+{
+	try { return allocate(bytes); } catch (const std::bad_alloc &) { return nullptr; }
+}
+
+void *operator new[](size_t bytes, const std::nothrow_t &) noexcept
+{
+	try { return allocate(bytes); } catch (const std::bad_alloc &) { return nullptr; }
+}
+
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, size_t) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete[](void *memory, size_t, std::align_val_t) noexcept { std::free(memory); }
+void operator delete(void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+void operator delete[](void *memory, const std::nothrow_t &) noexcept { std::free(memory); }
+#endif
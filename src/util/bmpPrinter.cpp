@@ -1,4 +1,5 @@
 #include <util/bmpPrinter.h>
+#include <rstartree/rstartree.h>
 
 BMPPrinter::BMPPrinter(const unsigned xPixels, const unsigned yPixels)
 {
@@ -83,7 +84,7 @@ bool BMPPrinter::whitePixel(const unsigned x, const unsigned y)
 	return (colourBytes[index + 0] == white) &&	(colourBytes[index + 1] == white) && (colourBytes[index + 2] == white);
 }
 
-void BMPPrinter::registerPoint(Point &point, Colour colour)
+void BMPPrinter::registerPoint(const Point &point, Colour colour)
 {
 	DPRINT1("registerPoint");
 
@@ -172,7 +173,7 @@ void BMPPrinter::registerQuadrants(Point &point, Rectangle limits, Colour colour
 	DPRINT1("registerQuadtrants finished");
 }
 
-void BMPPrinter::registerRectangle(Rectangle &boundingBox, Colour colour)
+void BMPPrinter::registerRectangle(const Rectangle &boundingBox, Colour colour)
 {
 	DPRINT1("registerRectangle");
 
@@ -407,19 +408,17 @@ void BMPPrinter::printToBMP(rstartree::Node *root)
 			currentLevel++;
 		}
 
-		DPRINT3("cycling through ", currentContext.first->entries.size(), " branches");
+		DPRINT3("cycling through ", currentContext.first->branches.size(), " branches");
 		// Add all of our children's bounding boxes to this level's image
-		for (unsigned i = 0; i < currentContext.first->entries.size(); ++i)
+		for (unsigned i = 0; i < currentContext.first->branches.size(); ++i)
+		{
+			registerRectangle(currentContext.first->branches[i].boundingBox, bmpColourGenerator());
+			explorationQ.push(std::pair<rstartree::Node *, unsigned>(currentContext.first->childOf(currentContext.first->branches[i]), currentLevel + 1));
+		}
+
+		for (unsigned i = 0; i < currentContext.first->data.size(); ++i)
 		{
-			if (std::holds_alternative<rstartree::Node::Branch>(currentContext.first->entries[i]))
-			{
-				registerRectangle(std::get<rstartree::Node::Branch>(currentContext.first->entries[i]).boundingBox, bmpColourGenerator());
-				explorationQ.push(std::pair<rstartree::Node *, unsigned>(std::get<rstartree::Node::Branch>(currentContext.first->entries[i]).child, currentLevel + 1));
-			}
-			else if (std::holds_alternative<Point>(currentContext.first->entries[i]))
-			{
-				registerPoint(std::get<Point>(currentContext.first->entries[i]), {0, 0, 0});
-			}
+			registerPoint(currentContext.first->data[i], {0, 0, 0});
 		}
 	}
 
@@ -65,7 +65,8 @@ double Point::distance(const Point &p) const
 {
 	double dist = 0.0;
 	for( unsigned d = 0; d < dimensions; d++ ) {
-		dist += pow(abs((*this)[d] - p[d]), 2);
+		double delta = (*this)[d] - p[d];
+		dist += delta * delta;
 	}
 	return sqrt(dist);
 }
@@ -120,16 +121,6 @@ Point &Point::operator*=(const Point &rhs)
 	return *this;
 }
 
-double &Point::operator[](unsigned index)
-{
-	return values[index];
-}
-
-const double Point::operator[](unsigned index) const
-{
-	return values[index];
-}
-
 Point &Point::operator<<(const Point &p)
 {
 	// Set this point to be the Hamming minimum between itself and p
@@ -212,60 +203,6 @@ Point operator*(const Point &lhs, const Point &rhs)
 	return r;
 }
 
-bool operator<(const Point &lhs, const Point &rhs)
-{
-	for (unsigned d = 0; d < dimensions; ++d)
-	{
-		if (lhs[d] >= rhs[d]) return false;
-	}
-
-	return true;
-}
-
-bool operator>(const Point &lhs, const Point &rhs)
-{
-	for (unsigned d = 0; d < dimensions; ++d)
-	{
-		if (lhs[d] <= rhs[d]) return false;
-	}
-
-	return true;
-}
-
-bool operator<=(const Point &lhs, const Point &rhs)
-{
-	for (unsigned d = 0; d < dimensions; ++d)
-	{
-		if (lhs[d] > rhs[d]) return false;
-	}
-	return true;
-}
-
-bool operator>=(const Point &lhs, const Point &rhs)
-{
-	for (unsigned d = 0; d < dimensions; ++d)
-	{
-		if (lhs[d] < rhs[d]) return false;
-	}
-
-	return true;
-}
-
-bool operator==(const Point &lhs, const Point &rhs)
-{
-	for (unsigned d = 0; d < dimensions; ++d)
-	{
-		if (lhs[d] != rhs[d]) return false;
-	}
-
-	return true;
-}
-
-bool operator!=(const Point &lhs, const Point &rhs)
-{
-	return !(lhs==rhs);
-}
-
 std::ostream& operator<<(std::ostream &os, const Point &p)
 {
 	os.precision(std::numeric_limits<double>::max_digits10+3);
@@ -470,22 +407,6 @@ bool Rectangle::alignedOpposingBorders(const Rectangle &givenRectangle) const
 	return result;
 }
 
-bool Rectangle::intersectsRectangle(const Rectangle &givenRectangle) const
-{
-	// Compute the range intersections
-	bool interval = true;
-
-	for (unsigned d = 0; d < dimensions && interval; ++d)
-	{
-		interval =
-			interval &&
-			((lowerLeft[d] <= givenRectangle.lowerLeft[d] && givenRectangle.lowerLeft[d] <= upperRight[d]) ||
-			(givenRectangle.lowerLeft[d] <= lowerLeft[d] && lowerLeft[d] <= givenRectangle.upperRight[d]));
-	}
-
-	return interval;
-}
-
 bool Rectangle::strictIntersectsRectangle(const Rectangle &givenRectangle) const
 {
 	// Compute the range intersections
@@ -507,24 +428,32 @@ bool Rectangle::borderOnlyIntersectsRectangle(const Rectangle &givenRectangle) c
 	return intersectsRectangle(givenRectangle) && alignedOpposingBorders(givenRectangle);
 }
 
-bool Rectangle::containsPoint(const Point &givenPoint) const
+Point Rectangle::centrePoint() const
 {
-	return lowerLeft <= givenPoint && givenPoint <= upperRight;
+	return (lowerLeft + upperRight) / 2.0;
 }
 
-bool Rectangle::strictContainsPoint(const Point &givenPoint) const
+// Distance from the point to the closest point of the rectangle, zero if the point is inside
+double Rectangle::minDistance(const Point &givenPoint) const
 {
-	return lowerLeft < givenPoint && givenPoint < upperRight;
-}
+	double dist = 0.0;
 
-bool Rectangle::containsRectangle(const Rectangle &givenRectangle) const
-{
-	return containsPoint(givenRectangle.lowerLeft) && containsPoint(givenRectangle.upperRight);
-}
+	for (unsigned d = 0; d < dimensions; ++d)
+	{
+		double delta = 0.0;
+		if (givenPoint[d] < lowerLeft[d])
+		{
+			delta = lowerLeft[d] - givenPoint[d];
+		}
+		else if (givenPoint[d] > upperRight[d])
+		{
+			delta = givenPoint[d] - upperRight[d];
+		}
 
-Point Rectangle::centrePoint() const
-{
-	return (lowerLeft + upperRight) / 2.0;
+		dist += delta * delta;
+	}
+
+	return sqrt(dist);
 }
 
 Rectangle Rectangle::copyExpand(const Point &givenPoint) const
@@ -643,8 +572,7 @@ IsotheticPolygon::IsotheticPolygon(const Rectangle &baseRectangle)
 IsotheticPolygon::IsotheticPolygon(const IsotheticPolygon &basePolygon)
 {
 	boundingBox = basePolygon.boundingBox;
-	basicRectangles.clear();
-	basicRectangles.insert(basicRectangles.end(), basePolygon.basicRectangles.begin(), basePolygon.basicRectangles.end());
+	basicRectangles = basePolygon.basicRectangles;
 }
 
 double IsotheticPolygon::area() const
@@ -831,6 +759,19 @@ bool IsotheticPolygon::containsPoint(const Point &givenPoint) const
 	return false;
 }
 
+// The bounding box can be much closer than any basic rectangle so take the true minimum
+double IsotheticPolygon::minDistance(const Point &givenPoint) const
+{
+	double dist = std::numeric_limits<double>::infinity();
+
+	for (const Rectangle &basicRectangle : basicRectangles)
+	{
+		dist = std::min(dist, basicRectangle.minDistance(givenPoint));
+	}
+
+	return dist;
+}
+
 bool IsotheticPolygon::disjoint(const IsotheticPolygon &givenPolygon) const
 {
 	bool rectanglesIntersect, opposingAlignment;
@@ -870,7 +811,7 @@ std::vector<Rectangle> IsotheticPolygon::intersection(const Rectangle &givenRect
 void IsotheticPolygon::intersection(const IsotheticPolygon &constraintPolygon)
 {
 	Rectangle r;
-	std::vector<Rectangle> v;
+	RectangleSet v;
 
 	for (const Rectangle &basicRectangle : basicRectangles)
 	{
@@ -891,7 +832,7 @@ void IsotheticPolygon::increaseResolution(const Point &givenPoint, const Rectang
 {
 	// Fragment each of our constiuent rectangles based on the clippingRectangle. This may result in
 	// no splitting of the constiuent rectangles and that's okay.
-	std::vector<Rectangle> extraRectangles;
+	RectangleSet extraRectangles;
 
 	for (const Rectangle &basicRectangle : basicRectangles)
 	{
@@ -1053,7 +994,7 @@ void IsotheticPolygon::deduplicate()
 		return;
 	}
 
-	std::vector<Rectangle> deduplicated;
+	RectangleSet deduplicated;
 	std::sort(basicRectangles.begin(), basicRectangles.end(), [](Rectangle &a, Rectangle &b){return a.lowerLeft[0] < b.lowerLeft[0];});
 
 	deduplicated.push_back(basicRectangles[0]);
@@ -1081,7 +1022,7 @@ void IsotheticPolygon::refine()
 	assert(basicRectangles.size() > 0);
 
 	unsigned rIndex;
-	std::vector<Rectangle> rectangleSetRefined;
+	RectangleSet rectangleSetRefined;
 
 	for (unsigned d = 0; d < dimensions; ++d)
 	{
@@ -1130,7 +1071,7 @@ void IsotheticPolygon::shrink(const std::vector<Point> &pinPoints)
 
 	assert(pinPoints.size() > 0);
 
-	std::vector<Rectangle> rectangleSetShrunk;
+	RectangleSet rectangleSetShrunk;
 	for (const Rectangle &basicRectangle : basicRectangles)
 	{
 		bool addRectangle = false;
@@ -0,0 +1,108 @@
+#include <util/hilbert.h>
+
+namespace hilbert
+{
+	// Skilling, "Programming the Hilbert curve", AIP Conf. Proc. 707 (2004). Converts the axes
+	// in place into the transposed Hilbert index.
+	static void axesToTranspose(uint64_t *x, unsigned bits)
+	{
+		uint64_t m = uint64_t(1) << (bits - 1);
+
+		// Inverse undo
+		for (uint64_t q = m; q > 1; q >>= 1)
+		{
+			uint64_t p = q - 1;
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				if (x[d] & q)
+				{
+					x[0] ^= p;
+				}
+				else
+				{
+					uint64_t t = (x[0] ^ x[d]) & p;
+					x[0] ^= t;
+					x[d] ^= t;
+				}
+			}
+		}
+
+		// Gray encode
+		for (unsigned d = 1; d < dimensions; ++d)
+		{
+			x[d] ^= x[d - 1];
+		}
+		uint64_t t = 0;
+		for (uint64_t q = m; q > 1; q >>= 1)
+		{
+			if (x[dimensions - 1] & q)
+			{
+				t ^= q - 1;
+			}
+		}
+		for (unsigned d = 0; d < dimensions; ++d)
+		{
+			x[d] ^= t;
+		}
+	}
+
+	uint64_t key(const Point &point, const Rectangle &bounds)
+	{
+		const uint64_t cells = (uint64_t(1) << bitsPerDimension) - 1;
+		uint64_t x[dimensions];
+
+		// Quantize each coordinate onto the grid over bounds
+		for (unsigned d = 0; d < dimensions; ++d)
+		{
+			double extent = bounds.upperRight[d] - bounds.lowerLeft[d];
+			double normalized = extent > 0.0 ? (point[d] - bounds.lowerLeft[d]) / extent : 0.0;
+			normalized = std::min(std::max(normalized, 0.0), 1.0);
+			x[d] = (uint64_t) (normalized * (double) cells);
+			x[d] = std::min(x[d], cells);
+		}
+
+		axesToTranspose(x, bitsPerDimension);
+
+		// Interleave the transposed bits, most significant first
+		uint64_t k = 0;
+		for (int bit = bitsPerDimension - 1; bit >= 0; --bit)
+		{
+			for (unsigned d = 0; d < dimensions; ++d)
+			{
+				k = (k << 1) | ((x[d] >> bit) & 1);
+			}
+		}
+
+		return k;
+	}
+
+	void sort(std::vector<Point> &points)
+	{
+		if (points.empty())
+		{
+			return;
+		}
+
+		Rectangle bounds(points[0], points[0]);
+		for (const Point &p : points)
+		{
+			bounds.expand(p);
+		}
+
+		std::vector<std::pair<uint64_t, unsigned>> keys;
+		keys.reserve(points.size());
+		for (unsigned i = 0; i < points.size(); ++i)
+		{
+			keys.emplace_back(key(points[i], bounds), i);
+		}
+		std::sort(keys.begin(), keys.end());
+
+		std::vector<Point> sorted;
+		sorted.reserve(points.size());
+		for (const auto &k : keys)
+		{
+			sorted.push_back(points[k.second]);
+		}
+		points.swap(sorted);
+	}
+}